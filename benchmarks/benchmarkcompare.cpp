@@ -0,0 +1,75 @@
+#include <QFile>
+#include <QXmlStreamReader>
+#include <QTextStream>
+#include "benchmarkcompare.h"
+
+bool BenchmarkCompare::readResults(const QString &filename, QMap<QString, BenchmarkResult> &results)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        QTextStream(stderr) << "Could not open " << filename << endl;
+        return false;
+    }
+
+    QXmlStreamReader xml(&file);
+    QString function;
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (!xml.isStartElement()) continue;
+        if (xml.name() == QLatin1String("TestFunction")) {
+            function = xml.attributes().value("name").toString();
+        } else if (xml.name() == QLatin1String("BenchmarkResult")) {
+            const QXmlStreamAttributes attributes = xml.attributes();
+            BenchmarkResult result;
+            result.metric = attributes.value("metric").toString();
+            result.value = attributes.value("value").toDouble();
+            result.iterations = attributes.value("iterations").toInt();
+            results.insert(function + QLatin1Char(':') + attributes.value("tag").toString(), result);
+        }
+    }
+    if (xml.hasError()) {
+        QTextStream(stderr) << filename << ": " << xml.errorString() << endl;
+        return false;
+    }
+    return true;
+}
+
+int BenchmarkCompare::run(const QString &baselineFile, const QString &currentFile, double threshold)
+{
+    QMap<QString, BenchmarkResult> baseline;
+    QMap<QString, BenchmarkResult> current;
+    if (!readResults(baselineFile, baseline) || !readResults(currentFile, current)) {
+        return 2;
+    }
+
+    QTextStream out(stdout);
+    int regressions = 0;
+    int compared = 0;
+    QMap<QString, BenchmarkResult>::const_iterator it = current.constBegin();
+    for (; it != current.constEnd(); ++it) {
+        QMap<QString, BenchmarkResult>::const_iterator base = baseline.constFind(it.key());
+        if (base == baseline.constEnd()) {
+            out << "new        " << it.key() << endl;
+            continue;
+        }
+        if (base->metric != it->metric || base->value <= 0) continue;
+
+        compared++;
+        const double change = (it->value - base->value) / base->value * 100.0;
+        const bool regressed = change > threshold;
+        if (regressed) regressions++;
+        out << (regressed ? "REGRESSED  " : change < -threshold ? "improved   " : "           ")
+            << it.key() << "  " << base->value << " -> " << it->value << " " << it->metric
+            << QString("  (%1%2%)").arg(change >= 0 ? "+" : "").arg(change, 0, 'f', 1) << endl;
+    }
+
+    QMap<QString, BenchmarkResult>::const_iterator base = baseline.constBegin();
+    for (; base != baseline.constEnd(); ++base) {
+        if (!current.contains(base.key())) {
+            out << "missing    " << base.key() << endl;
+        }
+    }
+
+    out << compared << " compared, " << regressions << " regressed by more than " << threshold << "%" << endl;
+    return regressions > 0 ? 1 : 0;
+}
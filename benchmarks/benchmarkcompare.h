@@ -0,0 +1,29 @@
+#ifndef BENCHMARKCOMPARE_H
+#define BENCHMARKCOMPARE_H
+
+#include <QString>
+#include <QMap>
+
+#define BENCHMARK_DEFAULT_THRESHOLD 10.0 // Percent
+
+struct BenchmarkResult
+{
+    QString metric;
+    double value; // Per iteration
+    int iterations;
+};
+
+/*!
+ * \brief Compares two QtTest XML result files (-o file,xml) of the benchmarks.
+ *
+ * Results are matched by function and data tag. Everything that got slower by
+ * more than the threshold counts as a regression.
+ */
+class BenchmarkCompare
+{
+public:
+    static bool readResults(const QString &filename, QMap<QString, BenchmarkResult> &results);
+    static int run(const QString &baselineFile, const QString &currentFile, double threshold = BENCHMARK_DEFAULT_THRESHOLD);
+};
+
+#endif // BENCHMARKCOMPARE_H
@@ -0,0 +1,121 @@
+#include "benchmarkcorpus.h"
+#include "models/fattributemodel.h"
+#include "models/fcardtypemodel.h"
+#include "models/fgeneralcardtypemodel.h"
+#include "models/flanguagemodel.h"
+
+struct CorpusEntry
+{
+    const char *tag;
+    const char *name;
+    const char *flavor;
+    int cardType; // Position in the card type model
+    int attributes[3]; // Positions in the attribute model, -1 terminated
+    int genericCost;
+    int attributeCost;
+    const char *traits[2];
+    const char *abilities[6];
+};
+
+static const CorpusEntry s_entries[] = {
+    { "vanilla", "Little Red, the Pure Stranger", nullptr, 0, { 0, -1, -1 }, 1, 1,
+      { nullptr, nullptr },
+      { nullptr } },
+    { "single-ability", "Flame of Outer World", "The fire that burns beyond the sky.", 0, { 1, -1, -1 }, 2, 1,
+      { "Dragon", nullptr },
+      { "[Enter] ⇨ Produce [w][w].", nullptr } },
+    { "keywords", "Zero, the Magus of Null", nullptr, 1, { 2, -1, -1 }, 0, 2,
+      { "Wizard", "Sage" },
+      { "[Judgement][u][u][1][2][3][4][5][6][7][8][9]", "[Energize][u]", "The weather is rain during your turn.", nullptr } },
+    { "long-text", "Thunder Parasol", "Rain or shine, the parasol stays open.", 2, { 3, 4, -1 }, 3, 1,
+      { "Machine", nullptr },
+      { "Other light resonators you control gain [+200/+200]. As long as there are four or more runes revealed from your rune area, they gain [+400/+400] instead.",
+        "[rest]: Search your deck for a card named \"Weather Change: Rain\", reveal it and put it into your hand. Then shuffle your deck.",
+        "《Thunder Parasol》 [0]: Choose one: Play this ability only during your turn and only once per turn - Put an electricity counter on this card; or remove an electricity counter from this card. If you do, the weather is thunderstorm until end of turn.",
+        nullptr } },
+    { "multi-attribute", "Alice, Girl in the Looking Glass", nullptr, 0, { 0, 2, 4 }, 1, 1,
+      { "Human", "Fairy Tale" },
+      { "[Enter] ⇨ Draw a card. Then put a card from your hand on top of your deck.",
+        "[rest], banish this card: Cancel target spell unless its controller pays [2].",
+        "[Quickcast]", nullptr } },
+    { "symbols", "Moon Shadow", nullptr, 1, { 4, -1, -1 }, 4, 2,
+      { nullptr, nullptr },
+      { "[moon][moon][time][v]: Remove target resonator from the game. Its controller produces [r][g][b].", nullptr } }
+};
+
+static const int s_entryCount = int(sizeof(s_entries) / sizeof(s_entries[0]));
+
+static int modelId(const QVector<FAbstractObject*> *data, int position)
+{
+    if (data->isEmpty() || position < 0) return -1;
+    return int(data->at(position % data->size())->id());
+}
+
+const QVector<BenchmarkCard> BenchmarkCorpus::cards(const QString &countryCode)
+{
+    const FLanguageModel *languageModel = FLanguageModel::Instance();
+    const QVector<FAbstractObject*> *cardTypes = FCardTypeModel::Instance()->dataVec();
+    const QVector<FAbstractObject*> *generalCardTypes = FGeneralCardTypeModel::Instance()->dataVec();
+    const QVector<FAbstractObject*> *attributes = FAttributeModel::Instance()->dataVec();
+
+    int genericAttribute = -1;
+    QVector<FAbstractObject*>::const_iterator it = attributes->constBegin();
+    for (; it != attributes->constEnd(); ++it) {
+        if (static_cast<const FAttribute*>(*it)->isGeneric()) {
+            genericAttribute = int((*it)->id());
+            break;
+        }
+    }
+
+    QVector<BenchmarkCard> cards;
+    cards.reserve(s_entryCount);
+    for (int i = 0; i < s_entryCount; ++i) {
+        const CorpusEntry &entry = s_entries[i];
+        BenchmarkCard card;
+        card.name = QString::fromLatin1(entry.tag);
+
+        CardRecord &record = card.record;
+        record.cardTypes[0] = qint16(modelId(cardTypes, entry.cardType));
+        record.generalCardTypes[0] = qint16(modelId(generalCardTypes, 0));
+        for (int a = 0; a < 3 && entry.attributes[a] != -1; ++a) {
+            const int id = modelId(attributes, entry.attributes[a]);
+            if (id == -1 || !record.addAttribute(id)) continue;
+            if (entry.attributeCost > 0) {
+                record.setCost(id, -1, entry.attributeCost);
+            }
+        }
+        if (entry.genericCost > 0 && genericAttribute != -1) {
+            record.setCost(genericAttribute, -1, entry.genericCost);
+        }
+
+        record.cardName = FLanguageString(languageModel);
+        record.cardName.setText(countryCode, QString::fromUtf8(entry.name));
+        record.flavorText = FLanguageString(languageModel);
+        if (entry.flavor) {
+            record.flavorText.setText(countryCode, QString::fromUtf8(entry.flavor));
+        }
+        for (int t = 0; t < 2 && entry.traits[t]; ++t) {
+            FLanguageString trait(languageModel);
+            trait.setText(countryCode, QString::fromUtf8(entry.traits[t]));
+            record.traits.append(trait);
+        }
+        for (int a = 0; a < 6 && entry.abilities[a]; ++a) {
+            FLanguageString ability(languageModel);
+            ability.setText(countryCode, QString::fromUtf8(entry.abilities[a]));
+            record.abilities.append(ability);
+        }
+        cards.append(card);
+    }
+    return cards;
+}
+
+const QStringList BenchmarkCorpus::abilityBlocks()
+{
+    QStringList blocks;
+    for (int i = 0; i < s_entryCount; ++i) {
+        for (int a = 0; a < 6 && s_entries[i].abilities[a]; ++a) {
+            blocks.append(QString::fromUtf8(s_entries[i].abilities[a]));
+        }
+    }
+    return blocks;
+}
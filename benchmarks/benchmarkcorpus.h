@@ -0,0 +1,28 @@
+#ifndef BENCHMARKCORPUS_H
+#define BENCHMARKCORPUS_H
+
+#include <QVector>
+#include <QStringList>
+#include "cardrecord.h"
+
+struct BenchmarkCard
+{
+    QString name; // Used as data tag
+    CardRecord record;
+};
+
+/*!
+ * \brief Fixed set of cards the benchmarks run on.
+ *
+ * The texts never change so results of different runs stay comparable. Type,
+ * attribute and rarity ids are taken from the loaded models by position, the
+ * models have to be set up before calling cards().
+ */
+class BenchmarkCorpus
+{
+public:
+    static const QVector<BenchmarkCard> cards(const QString &countryCode);
+    static const QStringList abilityBlocks();
+};
+
+#endif // BENCHMARKCORPUS_H
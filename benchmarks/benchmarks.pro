@@ -0,0 +1,33 @@
+#-------------------------------------------------
+#
+# QBENCHMARK suite of the render hot paths. Separate from the application:
+#   qmake benchmarks/benchmarks.pro && make
+#   ./fowce-benchmarks --data-dir <dir with data/> -o baseline.xml,xml
+#   ./fowce-benchmarks --compare baseline.xml current.xml
+#   ./fowce-benchmarks --data-dir <dir with data/> --tests
+#
+#-------------------------------------------------
+
+QT       += testlib concurrent
+
+TARGET = fowce-benchmarks
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../fowce.pri)
+
+SOURCES += \
+    main.cpp \
+    benchmarkcompare.cpp \
+    benchmarkcorpus.cpp \
+    cardsettests.cpp \
+    renderbenchmarks.cpp
+
+HEADERS += \
+    benchmarkcompare.h \
+    benchmarkcorpus.h \
+    cardsettests.h \
+    renderbenchmarks.h
@@ -0,0 +1,125 @@
+#include <QtTest>
+#include "cardsettests.h"
+#include "cardset/cardcorpusgenerator.h"
+#include "cardset/cardsetfile.h"
+#include "cardset/cardsetjournal.h"
+#include "models/flanguagemodel.h"
+#include "models/fwillcharacteristicmodel.h"
+#include "models/fattributemodel.h"
+#include "models/fgeneralcardtypemodel.h"
+#include "models/fcardtypemodel.h"
+#include "models/fraritymodel.h"
+
+static void compareTexts(const QVector<FLanguageString> &actual, const QVector<FLanguageString> &expected)
+{
+    QCOMPARE(actual.size(), expected.size());
+    for (int i = 0; i < actual.size(); ++i) {
+        QCOMPARE(*actual.at(i).data(), *expected.at(i).data());
+    }
+}
+
+static void compareRecords(const CardRecord &actual, const CardRecord &expected)
+{
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        QCOMPARE(actual.cardTypes[i], expected.cardTypes[i]);
+        QCOMPARE(actual.generalCardTypes[i], expected.generalCardTypes[i]);
+    }
+    QCOMPARE(actual.attributeCount, expected.attributeCount);
+    for (int i = 0; i < actual.attributeCount; ++i) {
+        QCOMPARE(actual.attributes[i], expected.attributes[i]);
+    }
+    QCOMPARE(actual.showFlags, expected.showFlags);
+    QCOMPARE(actual.side, expected.side);
+    QCOMPARE(actual.rarity, expected.rarity);
+    QCOMPARE(actual.costs, expected.costs);
+    QCOMPARE(*actual.cardName.data(), *expected.cardName.data());
+    QCOMPARE(*actual.flavorText.data(), *expected.flavorText.data());
+    compareTexts(actual.traits, expected.traits);
+    compareTexts(actual.abilities, expected.abilities);
+}
+
+CardSetTests::CardSetTests(QObject *parent)
+    : QObject(parent), m_languageModel(nullptr), m_characteristicModel(nullptr), m_attributeModel(nullptr),
+      m_generalCardTypeModel(nullptr), m_cardTypeModel(nullptr), m_rarityModel(nullptr)
+{
+}
+
+void CardSetTests::initTestCase()
+{
+    // Same order as MainWindow, the models look each other up through Instance()
+    m_languageModel = new FLanguageModel(this);
+    FLanguageModel::SetInstance(m_languageModel);
+    m_characteristicModel = new FWillCharacteristicModel(this);
+    FWillCharacteristicModel::SetInstance(m_characteristicModel);
+    m_attributeModel = new FAttributeModel(this);
+    FAttributeModel::SetInstance(m_attributeModel);
+    m_generalCardTypeModel = new FGeneralCardTypeModel(this);
+    FGeneralCardTypeModel::SetInstance(m_generalCardTypeModel);
+    m_cardTypeModel = new FCardTypeModel(this);
+    FCardTypeModel::SetInstance(m_cardTypeModel);
+    m_rarityModel = new FRarityModel(this);
+    FRarityModel::SetInstance(m_rarityModel);
+
+    QVERIFY(m_dir.isValid());
+}
+
+void CardSetTests::roundTrip_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1") << 1;
+    QTest::newRow("1k") << 1000;
+}
+
+void CardSetTests::roundTrip()
+{
+    QFETCH(int, count);
+
+    const QVector<CardRecord> records = CardCorpusGenerator().generate(count);
+    const QString filename = m_dir.filePath(QString("roundtrip-%1.fows").arg(count));
+    CardSetWriter writer;
+    writer.addCards(records);
+    QVERIFY2(writer.write(filename), qPrintable(writer.errorString()));
+
+    CardSetReader reader;
+    QVERIFY2(reader.open(filename), qPrintable(reader.errorString()));
+    QCOMPARE(reader.cardCount(), records.size());
+    // Backwards, every record is found through the index on its own
+    for (int i = records.size() - 1; i >= 0; --i) {
+        compareRecords(reader.card(i), records.at(i));
+        if (QTest::currentTestFailed()) {
+            QFAIL(qPrintable(QString("Card %1 differs.").arg(i)));
+        }
+        QCOMPARE(*reader.cardName(i).data(), *records.at(i).cardName.data());
+    }
+}
+
+void CardSetTests::journalReplay()
+{
+    QVector<CardRecord> records = CardCorpusGenerator().generate(10);
+    QVERIFY(records.size() >= 3);
+
+    // Entries go through serialize() and back, as they do in the journal file
+    QVector<CardJournalEntry> entries;
+    entries << CardJournalEntry(1, CardJournalEntry::SetCardName, records.at(2))
+            << CardJournalEntry(2, CardJournalEntry::PutCard, records.at(0))
+            << CardJournalEntry(quint32(records.size() - 1), CardJournalEntry::SetCardCount);
+    QVector<CardRecord> expected = records;
+    expected[1].cardName = records.at(2).cardName;
+    expected[2] = records.at(0);
+    expected.resize(records.size() - 1);
+
+    QVector<CardJournalEntry>::const_iterator it = entries.constBegin();
+    for (; it != entries.constEnd(); ++it) {
+        CardJournalEntry entry;
+        QVERIFY(CardJournalEntry::deserialize(it->serialize(), entry));
+        // Replaying twice has to give the same set, recovery relies on it
+        entry.applyTo(records);
+        entry.applyTo(records);
+    }
+
+    QCOMPARE(records.size(), expected.size());
+    for (int i = 0; i < records.size(); ++i) {
+        compareRecords(records.at(i), expected.at(i));
+    }
+}
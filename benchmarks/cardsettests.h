@@ -0,0 +1,44 @@
+#ifndef CARDSETTESTS_H
+#define CARDSETTESTS_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class FLanguageModel;
+class FWillCharacteristicModel;
+class FAttributeModel;
+class FGeneralCardTypeModel;
+class FCardTypeModel;
+class FRarityModel;
+
+/*!
+ * \brief Checks that card sets and journals read back what was written.
+ *
+ * Runs with "fowce-benchmarks --tests" on the same models as the benchmarks.
+ */
+class CardSetTests : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CardSetTests(QObject *parent = nullptr);
+
+private slots:
+    void initTestCase();
+
+    void roundTrip_data();
+    void roundTrip();
+
+    void journalReplay();
+
+private:
+    FLanguageModel *m_languageModel;
+    FWillCharacteristicModel *m_characteristicModel;
+    FAttributeModel *m_attributeModel;
+    FGeneralCardTypeModel *m_generalCardTypeModel;
+    FCardTypeModel *m_cardTypeModel;
+    FRarityModel *m_rarityModel;
+
+    QTemporaryDir m_dir;
+};
+
+#endif // CARDSETTESTS_H
@@ -0,0 +1,61 @@
+#include <QApplication>
+#include <QSettings>
+#include <QDir>
+#include <QtTest>
+#include "renderbenchmarks.h"
+#include "cardsettests.h"
+#include "benchmarkcompare.h"
+
+/*
+ * Usage:
+ *   fowce-benchmarks [--data-dir <dir>] [QtTest options]
+ *       Runs the benchmarks. The models load "data/" relative to <dir>.
+ *       Use "-o results.xml,xml" for results --compare can read, or
+ *       "-o results.csv,csv" for a spreadsheet.
+ *   fowce-benchmarks --compare <baseline.xml> <current.xml> [--threshold <percent>]
+ *       Lists every result that got slower than the threshold and exits
+ *       with 1 if there was any.
+ *   fowce-benchmarks [--data-dir <dir>] --tests [QtTest options]
+ *       Runs the card set tests instead of the benchmarks.
+ */
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    // Keep the user's font settings away from the results
+    QCoreApplication::setOrganizationName("FOWCE");
+    QCoreApplication::setApplicationName("FOWCE-benchmarks");
+    QSettings::setDefaultFormat(QSettings::IniFormat);
+
+    QStringList args = app.arguments();
+
+    int index = args.indexOf("--compare");
+    if (index != -1) {
+        if (index + 2 >= args.size()) {
+            QTextStream(stderr) << "--compare needs a baseline and a current result file" << endl;
+            return 2;
+        }
+        double threshold = BENCHMARK_DEFAULT_THRESHOLD;
+        int thresholdIndex = args.indexOf("--threshold");
+        if (thresholdIndex != -1 && thresholdIndex + 1 < args.size()) {
+            threshold = args.at(thresholdIndex + 1).toDouble();
+        }
+        return BenchmarkCompare::run(args.at(index + 1), args.at(index + 2), threshold);
+    }
+
+    index = args.indexOf("--data-dir");
+    if (index != -1 && index + 1 < args.size()) {
+        QDir::setCurrent(args.at(index + 1));
+        args.removeAt(index + 1);
+        args.removeAt(index);
+    }
+
+    index = args.indexOf("--tests");
+    if (index != -1) {
+        args.removeAt(index);
+        CardSetTests tests;
+        return QTest::qExec(&tests, args);
+    }
+
+    RenderBenchmarks benchmarks;
+    return QTest::qExec(&benchmarks, args);
+}
@@ -0,0 +1,475 @@
+#include <QtTest>
+#include <QGraphicsScene>
+#include <QStyleOptionGraphicsItem>
+#include <QtConcurrent>
+#include "renderbenchmarks.h"
+#include "card.h"
+#include "cardpreviewitem.h"
+#include "cardpreviewwidget.h"
+#include "cardset/cardcorpusgenerator.h"
+#include "cardset/cardsearchindex.h"
+#include "render/batchrenderer.h"
+#include "render/cardrenderer.h"
+#include "render/imageencoder.h"
+#include "render/workstealingscheduler.h"
+#include "text/fgraphicstextitem.h"
+#include "models/flanguagemodel.h"
+#include "models/fwillcharacteristicmodel.h"
+#include "models/fattributemodel.h"
+#include "models/fgeneralcardtypemodel.h"
+#include "models/fcardtypemodel.h"
+#include "models/fraritymodel.h"
+#include "util.h"
+
+// Size of CardPreviewItem's inner ability text box
+#define ABILITY_BOX_WIDTH 1164
+#define ABILITY_BOX_HEIGHT 479
+#define ABILITY_FONT_SIZE 38
+
+struct FlagCombination
+{
+    const char *name;
+    quint8 flags;
+};
+
+static const FlagCombination s_flagCombinations[] = {
+    { "default", CardRecord::DefaultShowFlags },
+    { "quickcast", CardRecord::DefaultShowFlags | CardRecord::ShowQuickcast },
+    { "no-border", CardRecord::DefaultShowFlags & ~CardRecord::ShowBorder },
+    { "no-cost", CardRecord::DefaultShowFlags & ~CardRecord::ShowCost },
+    { "small-textbox", CardRecord::DefaultShowFlags | CardRecord::ShowSmallTextBox },
+    { "no-stats", CardRecord::DefaultShowFlags & ~CardRecord::ShowStats },
+    { "bare", 0 }
+};
+
+static QFont abilityFont()
+{
+    QFont font("Ryo Text PlusN M");
+    font.setPointSize(ABILITY_FONT_SIZE);
+    font.setLetterSpacing(QFont::PercentageSpacing, 105);
+    font.setStyleStrategy(QFont::StyleStrategy::NoAntialias);
+    return font;
+}
+
+static void setupAbilityItem(FGraphicsTextItem &item, const QStringList &blocks)
+{
+    item.setFont(abilityFont());
+    QStringList::const_iterator it = blocks.constBegin();
+    for (; it != blocks.constEnd(); ++it) {
+        item.insertTextBlock(*it);
+    }
+    item.setTargetRect(QRect(0, 0, ABILITY_BOX_WIDTH, ABILITY_BOX_HEIGHT));
+}
+
+// Map functor for QtConcurrent, which needs result_type
+struct RenderRecord
+{
+    typedef QImage result_type;
+
+    explicit RenderRecord(const FModelSnapshotPtr &snapshot) : snapshot(snapshot) {}
+    QImage operator()(const CardRecord &record) const { return CardRenderer::renderRecord(record, snapshot); }
+
+    FModelSnapshotPtr snapshot;
+};
+
+static QStringList abilityTexts(const CardRecord &record, const QString &countryCode)
+{
+    QStringList texts;
+    QVector<FLanguageString>::const_iterator it = record.abilities.constBegin();
+    for (; it != record.abilities.constEnd(); ++it) {
+        texts.append(it->text(countryCode));
+    }
+    return texts;
+}
+
+RenderBenchmarks::RenderBenchmarks(QObject *parent)
+    : QObject(parent), m_languageModel(nullptr), m_characteristicModel(nullptr), m_attributeModel(nullptr),
+      m_generalCardTypeModel(nullptr), m_cardTypeModel(nullptr), m_rarityModel(nullptr)
+{
+}
+
+void RenderBenchmarks::initTestCase()
+{
+    // Same order as MainWindow, the models look each other up through Instance()
+    m_languageModel = new FLanguageModel(this);
+    FLanguageModel::SetInstance(m_languageModel);
+    m_characteristicModel = new FWillCharacteristicModel(this);
+    FWillCharacteristicModel::SetInstance(m_characteristicModel);
+    m_attributeModel = new FAttributeModel(this);
+    FAttributeModel::SetInstance(m_attributeModel);
+    m_generalCardTypeModel = new FGeneralCardTypeModel(this);
+    FGeneralCardTypeModel::SetInstance(m_generalCardTypeModel);
+    m_cardTypeModel = new FCardTypeModel(this);
+    FCardTypeModel::SetInstance(m_cardTypeModel);
+    m_rarityModel = new FRarityModel(this);
+    FRarityModel::SetInstance(m_rarityModel);
+
+    m_corpus = BenchmarkCorpus::cards(m_languageModel->selectedLanguage()->countryCode());
+    QVERIFY(!m_corpus.isEmpty());
+    QVERIFY(m_outputDir.isValid());
+}
+
+void RenderBenchmarks::cleanupTestCase()
+{
+    m_corpus.clear();
+}
+
+void RenderBenchmarks::svgToPixmap_data()
+{
+    QTest::addColumn<QString>("filename");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<bool>("outline");
+
+    const int heights[] = { 48, 96 };
+    QMap<QString, Util::TextObject::Replacement>::const_iterator it = Util::TextObject::Replacements.constBegin();
+    for (; it != Util::TextObject::Replacements.constEnd(); ++it) {
+        for (int h = 0; h < 2; ++h) {
+            QTest::newRow(qPrintable(QString("%1@%2").arg(it.key()).arg(heights[h]))) << it->symbolName << heights[h] << false;
+            QTest::newRow(qPrintable(QString("%1@%2-outline").arg(it.key()).arg(heights[h]))) << it->symbolName << heights[h] << true;
+        }
+    }
+}
+
+void RenderBenchmarks::svgToPixmap()
+{
+    QFETCH(QString, filename);
+    QFETCH(int, height);
+    QFETCH(bool, outline);
+
+    const QPen pen = outline ? QPen(Qt::black, 4) : QPen(Qt::NoPen);
+    QPixmap pix;
+    QBENCHMARK {
+        pix = Util::XML::svgToPixmap(filename, QSize(-1, height), pen);
+    }
+    QVERIFY(!pix.isNull());
+}
+
+void RenderBenchmarks::parseAndInsertText_data()
+{
+    QTest::addColumn<QString>("text");
+
+    const QStringList blocks = BenchmarkCorpus::abilityBlocks();
+    for (int i = 0; i < blocks.size(); ++i) {
+        QTest::newRow(qPrintable(QString("block-%1").arg(i))) << blocks.at(i);
+    }
+}
+
+// insertTextBlock() is the public entry to parseAndInsertText(). Without a
+// target rect nothing gets fitted, but the document still lays out once.
+void RenderBenchmarks::parseAndInsertText()
+{
+    QFETCH(QString, text);
+
+    FGraphicsTextItem item;
+    item.setFont(abilityFont());
+    QBENCHMARK {
+        item.clear();
+        item.insertTextBlock(text);
+    }
+}
+
+void RenderBenchmarks::fitToRect_data()
+{
+    QTest::addColumn<int>("order");
+    QTest::addColumn<QStringList>("blocks");
+
+    const char *orderNames[] = { "SpacingStretchSize", "SizeSpacingStretch", "SizeStretchSpacing" };
+    const QString countryCode = m_languageModel->selectedLanguage()->countryCode();
+    for (int order = 0; order < 3; ++order) {
+        QVector<BenchmarkCard>::const_iterator it = m_corpus.constBegin();
+        for (; it != m_corpus.constEnd(); ++it) {
+            if (it->record.abilities.isEmpty()) continue;
+            QTest::newRow(qPrintable(QString("%1/%2").arg(orderNames[order], it->name)))
+                    << order << abilityTexts(it->record, countryCode);
+        }
+    }
+}
+
+void RenderBenchmarks::fitToRect()
+{
+    QFETCH(int, order);
+    QFETCH(QStringList, blocks);
+
+    FGraphicsTextItem item;
+    item.setFitToRectOrder(FGraphicsTextItem::FitToRectOrder(order));
+    setupAbilityItem(item, blocks);
+    // fitToRect() starts over from the default font every time
+    QBENCHMARK {
+        item.fitToRect();
+    }
+}
+
+void RenderBenchmarks::documentLayout_data()
+{
+    QTest::addColumn<QStringList>("blocks");
+
+    const QString countryCode = m_languageModel->selectedLanguage()->countryCode();
+    QVector<BenchmarkCard>::const_iterator it = m_corpus.constBegin();
+    for (; it != m_corpus.constEnd(); ++it) {
+        if (it->record.abilities.isEmpty()) continue;
+        QTest::newRow(qPrintable(it->name)) << abilityTexts(it->record, countryCode);
+    }
+}
+
+void RenderBenchmarks::documentLayout()
+{
+    QFETCH(QStringList, blocks);
+
+    FGraphicsTextItem item;
+    setupAbilityItem(item, blocks);
+    QTextDocument *doc = item.document();
+    QSizeF size;
+    QBENCHMARK {
+        doc->markContentsDirty(0, doc->characterCount());
+        size = doc->size();
+    }
+    QVERIFY(size.isValid());
+}
+
+void RenderBenchmarks::addCardRows(bool allFlagCombinations)
+{
+    QTest::addColumn<CardRecord>("record");
+
+    if (!allFlagCombinations) {
+        QVector<BenchmarkCard>::const_iterator it = m_corpus.constBegin();
+        for (; it != m_corpus.constEnd(); ++it) {
+            QTest::newRow(qPrintable(it->name)) << it->record;
+        }
+        return;
+    }
+
+    const BenchmarkCard &base = m_corpus.at(qMin(3, m_corpus.size() - 1));
+    const int flagCount = int(sizeof(s_flagCombinations) / sizeof(s_flagCombinations[0]));
+    const QVector<FAbstractObject*> *rarities = m_rarityModel->dataVec();
+    QVector<FAbstractObject*>::const_iterator it = rarities->constBegin();
+    for (; it != rarities->constEnd(); ++it) {
+        const FRarity *rarity = static_cast<const FRarity*>(*it);
+        for (int f = 0; f < flagCount; ++f) {
+            CardRecord record = base.record;
+            record.rarity = qint16(rarity->id());
+            record.showFlags = s_flagCombinations[f].flags;
+            QTest::newRow(qPrintable(QString("%1/%2").arg(rarity->stringId(), s_flagCombinations[f].name))) << record;
+        }
+    }
+
+    // Rulers have their own decorations
+    const FCardType *ruler = m_cardTypeModel->get("RULER");
+    if (ruler) {
+        CardRecord record = base.record;
+        record.cardTypes[0] = qint16(ruler->id());
+        QTest::newRow("RULER/default") << record;
+    }
+}
+
+void RenderBenchmarks::paintItem_data()
+{
+    addCardRows(true);
+}
+
+// Repaint with the layout and the text images already cached
+void RenderBenchmarks::paintItem()
+{
+    QFETCH(CardRecord, record);
+
+    CardPreviewItem item(record);
+    QImage image(item.boundingRect().size().toSize(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    QStyleOptionGraphicsItem option;
+    QBENCHMARK {
+        item.paint(&painter, &option, nullptr);
+    }
+}
+
+void RenderBenchmarks::renderCard_data()
+{
+    addCardRows(true);
+}
+
+// Full card with text, the text backing images are redrawn every time
+void RenderBenchmarks::renderCard()
+{
+    QFETCH(CardRecord, record);
+
+    QGraphicsScene scene;
+    CardPreviewItem *item = new CardPreviewItem(record);
+    scene.addItem(item);
+    QImage image(item->boundingRect().size().toSize(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    QBENCHMARK {
+        item->redraw();
+        scene.render(&painter, QRectF(image.rect()), item->boundingRect());
+    }
+}
+
+void RenderBenchmarks::renderRecord_data()
+{
+    addCardRows(false);
+}
+
+// Cold render without a scene: layout, text fitting and rasterizing
+void RenderBenchmarks::renderRecord()
+{
+    QFETCH(CardRecord, record);
+
+    const FModelSnapshotPtr snapshot = FModelSnapshot::current();
+    QImage image;
+    QBENCHMARK {
+        image = CardRenderer::renderRecord(record, snapshot);
+    }
+    QCOMPARE(image.size(), CardRenderer::size());
+}
+
+void RenderBenchmarks::renderParallel_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("64") << 64;
+}
+
+// The whole corpus on the global thread pool, compare against renderRecord for the scaling
+void RenderBenchmarks::renderParallel()
+{
+    QFETCH(int, count);
+
+    QVector<CardRecord> records;
+    for (int i = 0; i < count; ++i) {
+        records.append(m_corpus.at(i % m_corpus.size()).record);
+    }
+    // Every worker shares the one snapshot and reads it without locking
+    const FModelSnapshotPtr snapshot = FModelSnapshot::current();
+    QList<QImage> images;
+    QBENCHMARK {
+        images = QtConcurrent::blockingMapped<QList<QImage> >(records, RenderRecord(snapshot));
+    }
+    QCOMPARE(images.size(), count);
+}
+
+void RenderBenchmarks::renderBatch_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("64") << 64;
+}
+
+// Same corpus as renderParallel, split into subtasks on the work-stealing scheduler
+void RenderBenchmarks::renderBatch()
+{
+    QFETCH(int, count);
+
+    QVector<RenderJob> jobs;
+    for (int i = 0; i < count; ++i) {
+        RenderJob job;
+        job.id = quint32(i);
+        job.record = m_corpus.at(i % m_corpus.size()).record;
+        job.output.format = "bmp"; // Cheapest encoder, this is about the rendering
+        jobs.append(job);
+    }
+    WorkStealingScheduler scheduler;
+    BatchRenderer batch(&scheduler, FModelSnapshot::current());
+    QVector<RenderResult> results;
+    QBENCHMARK {
+        scheduler.resetStats();
+        results = batch.render(jobs);
+    }
+    QCOMPARE(results.size(), count);
+
+    const QVector<WorkerStats> stats = scheduler.stats();
+    for (int i = 0; i < stats.size(); ++i) {
+        qInfo("worker %d: %d tasks, %d stolen, %.0f%% busy", i, stats.at(i).executed, stats.at(i).stolen, stats.at(i).utilization() * 100.0);
+    }
+}
+
+void RenderBenchmarks::exportPng_data()
+{
+    addCardRows(false);
+}
+
+void RenderBenchmarks::exportPng()
+{
+    QFETCH(CardRecord, record);
+
+    Card card(nullptr, m_attributeModel, m_languageModel);
+    record.applyTo(&card);
+    CardPreviewWidget widget;
+    widget.addCard(&card);
+    const QString filename = m_outputDir.filePath(QString("%1.png").arg(QTest::currentDataTag()));
+    QBENCHMARK {
+        widget.saveToPNG(filename);
+    }
+    QVERIFY(QFile::exists(filename));
+}
+
+void RenderBenchmarks::encodeImage_data()
+{
+    QTest::addColumn<QByteArray>("format");
+    QTest::addColumn<int>("compression");
+    QTest::addColumn<int>("quality");
+
+    QTest::newRow("png-0") << QByteArray("png") << 0 << -1;
+    QTest::newRow("png-1") << QByteArray("png") << 1 << -1;
+    QTest::newRow("png-6") << QByteArray("png") << 6 << -1;
+    QTest::newRow("png-9") << QByteArray("png") << 9 << -1;
+    QTest::newRow("jpg-90") << QByteArray("jpg") << 0 << 90;
+    if (QImageWriter::supportedImageFormats().contains("webp")) {
+        QTest::newRow("webp-90") << QByteArray("webp") << 0 << 90;
+    }
+}
+
+void RenderBenchmarks::encodeImage()
+{
+    QFETCH(QByteArray, format);
+    QFETCH(int, compression);
+    QFETCH(int, quality);
+
+    EncoderOptions options;
+    options.format = format;
+    options.compression = compression;
+    options.quality = quality;
+    const QImage image = CardRenderer::renderRecord(CardRecord(), FModelSnapshot::current());
+    QByteArray data;
+    QString error;
+    QBENCHMARK {
+        QVERIFY2(ImageEncoder::encode(image, options, &data, &error), qPrintable(error));
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void RenderBenchmarks::generateCorpus_data()
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+}
+
+void RenderBenchmarks::generateCorpus()
+{
+    QFETCH(int, count);
+
+    CardCorpusGenerator generator;
+    QVector<CardRecord> records;
+    QBENCHMARK {
+        records = generator.generate(count);
+    }
+    QVERIFY(records.size() >= count);
+}
+
+void RenderBenchmarks::buildSearchIndex_data()
+{
+    generateCorpus_data();
+}
+
+void RenderBenchmarks::buildSearchIndex()
+{
+    QFETCH(int, count);
+
+    const QVector<CardRecord> records = CardCorpusGenerator().generate(count);
+    QBENCHMARK {
+        CardSearchIndex index;
+        for (int i = 0; i < records.size(); ++i) {
+            index.setCard(i, records.at(i));
+        }
+    }
+}
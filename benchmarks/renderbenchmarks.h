@@ -0,0 +1,84 @@
+#ifndef RENDERBENCHMARKS_H
+#define RENDERBENCHMARKS_H
+
+#include <QObject>
+#include <QTemporaryDir>
+#include "benchmarkcorpus.h"
+
+class FLanguageModel;
+class FWillCharacteristicModel;
+class FAttributeModel;
+class FGeneralCardTypeModel;
+class FCardTypeModel;
+class FRarityModel;
+
+/*!
+ * \brief QBENCHMARK suite of the render hot paths.
+ *
+ * Every benchmark is data driven over the fixed BenchmarkCorpus so the data
+ * tags, and therefore the rows compared by --compare, stay stable.
+ */
+class RenderBenchmarks : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RenderBenchmarks(QObject *parent = nullptr);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void svgToPixmap_data();
+    void svgToPixmap();
+
+    void parseAndInsertText_data();
+    void parseAndInsertText();
+
+    void fitToRect_data();
+    void fitToRect();
+
+    void documentLayout_data();
+    void documentLayout();
+
+    void paintItem_data();
+    void paintItem();
+
+    void renderCard_data();
+    void renderCard();
+
+    void renderRecord_data();
+    void renderRecord();
+
+    void renderParallel_data();
+    void renderParallel();
+
+    void renderBatch_data();
+    void renderBatch();
+
+    void exportPng_data();
+    void exportPng();
+
+    void encodeImage_data();
+    void encodeImage();
+
+    void generateCorpus_data();
+    void generateCorpus();
+
+    void buildSearchIndex_data();
+    void buildSearchIndex();
+
+private:
+    FLanguageModel *m_languageModel;
+    FWillCharacteristicModel *m_characteristicModel;
+    FAttributeModel *m_attributeModel;
+    FGeneralCardTypeModel *m_generalCardTypeModel;
+    FCardTypeModel *m_cardTypeModel;
+    FRarityModel *m_rarityModel;
+
+    QVector<BenchmarkCard> m_corpus;
+    QTemporaryDir m_outputDir;
+
+    void addCardRows(bool allFlagCombinations);
+};
+
+#endif // RENDERBENCHMARKS_H
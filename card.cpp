@@ -1,48 +1,82 @@
 #include "card.h"
 
 Card::Card(QObject *parent, const FAttributeModel *attributeModel, const FLanguageModel *languageModel)
-    : QObject(parent), m_showStats(true), m_showCost(true), m_showSmallTextBox(false), m_showBorder(true), m_showTextBox(true), m_showQuickcast(false)
+    : QObject(parent), m_showStats(true), m_showCost(true), m_showSmallTextBox(false), m_showBorder(true), m_showTextBox(true), m_showQuickcast(false),
+      m_updateDepth(0), m_pendingChanges(NoChange)
 {
     m_willCostModel = new WillCostModel(this, attributeModel);
     m_traitModel = new LangStringListModel(QObject::tr("Race/Trait"), languageModel);
     m_abilityTextModel = new LangStringListModel(QObject::tr("Ability"), languageModel);
     m_rarity = FRarityModel::Instance()->get(0);
+
+    QObject::connect(m_willCostModel, &WillCostModel::dataChanged, this, [this]() { markChanged(CostChange); });
+    QObject::connect(m_traitModel, &LangStringListModel::dataChanged, this, [this]() { markChanged(TraitChange); });
+    QObject::connect(m_traitModel, &LangStringListModel::rowsRemoved, this, [this]() { markChanged(TraitChange); });
+    QObject::connect(m_abilityTextModel, &LangStringListModel::dataChanged, this, [this]() { markChanged(AbilityChange); });
+    QObject::connect(m_abilityTextModel, &LangStringListModel::rowsRemoved, this, [this]() { markChanged(AbilityChange); });
+}
+
+void Card::endUpdate()
+{
+    Q_ASSERT(m_updateDepth > 0);
+    if (--m_updateDepth > 0) return;
+
+    Changes changes = m_pendingChanges;
+    m_pendingChanges = NoChange;
+    if (changes) {
+        emit changed(changes);
+    }
+}
+
+void Card::markChanged(Change change)
+{
+    if (m_updateDepth > 0) {
+        m_pendingChanges |= change;
+    } else {
+        emit changed(change);
+    }
 }
 
 void Card::setShowStats(bool showStats)
 {
     m_showStats = showStats;
     emit showStatsChanged(showStats);
+    markChanged(ShowStatsChange);
 }
 
 void Card::setShowCost(bool showCost)
 {
     m_showCost = showCost;
     emit showCostChanged(showCost);
+    markChanged(ShowCostChange);
 }
 
 void Card::setShowSmallTextBox(bool showSmallTextBox)
 {
     m_showSmallTextBox = showSmallTextBox;
     emit showSmallTextBoxChanged(showSmallTextBox);
+    markChanged(ShowSmallTextBoxChange);
 }
 
 void Card::setShowBorder(bool showBorder)
 {
     m_showBorder = showBorder;
     emit showBorderChanged(showBorder);
+    markChanged(ShowBorderChange);
 }
 
 void Card::setShowTextBox(bool showTextBox)
 {
     m_showTextBox = showTextBox;
     emit showTextBoxChanged(showTextBox);
+    markChanged(ShowTextBoxChange);
 }
 
 void Card::setShowQuickcast(bool showQuickcast)
 {
     m_showQuickcast = showQuickcast;
     emit showQuickcastChanged(showQuickcast);
+    markChanged(ShowQuickcastChange);
 }
 
 void Card::updateCanFight()
@@ -101,6 +135,7 @@ void Card::setRarity(const FRarity *rarity)
     if (rarity != m_rarity) {
         m_rarity = rarity;
         emit rarityChanged(rarity);
+        markChanged(RarityChange);
     }
 }
 
@@ -109,12 +144,14 @@ void Card::addAttribute(const FAttribute *attribute)
     if (m_attributes.contains(attribute->id())) return;
     m_attributes.insert(attribute->id(), attribute);
     emit attributeChanged(attribute);
+    markChanged(AttributeChange);
 }
 
 void Card::removeAttribute(const FAttribute *attribute)
 {
     if (m_attributes.remove(attribute->id())) {
         emit attributeChanged(attribute);
+        markChanged(AttributeChange);
     }
 }
 
@@ -123,6 +160,7 @@ void Card::addCardType(int key, const FCardType *cardType)
     m_cardTypes.insert(key, cardType);
     updateCardOptions();
     emit cardTypeChanged(cardType);
+    markChanged(CardTypeChange);
 }
 
 void Card::replaceCardType(int key, const FCardType *cardType)
@@ -131,6 +169,7 @@ void Card::replaceCardType(int key, const FCardType *cardType)
         m_cardTypes[key] = cardType;
         updateCardOptions();
         emit cardTypeChanged(cardType);
+        markChanged(CardTypeChange);
     }
 }
 
@@ -141,6 +180,7 @@ void Card::removeCardType(int key)
         m_cardTypes.remove(key);
         updateCardOptions();
         emit cardTypeChanged(ct);
+        markChanged(CardTypeChange);
     }
 }
 
@@ -149,6 +189,7 @@ void Card::addGeneralCardType(int key, const FGeneralCardType *generalCardType)
     m_generalCardTypes.insert(key, generalCardType);
     updateCardOptions();
     emit generalCardTypeChanged(generalCardType);
+    markChanged(GeneralCardTypeChange);
 }
 
 void Card::replaceGeneralCardType(int key, const FGeneralCardType *generalCardType)
@@ -157,6 +198,7 @@ void Card::replaceGeneralCardType(int key, const FGeneralCardType *generalCardTy
         m_generalCardTypes[key] = generalCardType;
         updateCardOptions();
         emit generalCardTypeChanged(generalCardType);
+        markChanged(GeneralCardTypeChange);
     }
 }
 
@@ -167,5 +209,6 @@ void Card::removeGeneralCardType(int key)
         m_generalCardTypes.remove(key);
         updateCardOptions();
         emit generalCardTypeChanged(gct);
+        markChanged(GeneralCardTypeChange);
     }
 }
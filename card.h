@@ -16,13 +16,40 @@ class Card : public QObject
 {
     Q_OBJECT
 public:
+    enum Change : quint32 {
+        NoChange = 0,
+        RarityChange = 0x0001,
+        CardTypeChange = 0x0002,
+        GeneralCardTypeChange = 0x0004,
+        AttributeChange = 0x0008,
+        CardNameChange = 0x0010,
+        FlavorTextChange = 0x0020,
+        ShowCostChange = 0x0040,
+        ShowStatsChange = 0x0080,
+        ShowSmallTextBoxChange = 0x0100,
+        ShowBorderChange = 0x0200,
+        ShowTextBoxChange = 0x0400,
+        ShowQuickcastChange = 0x0800,
+        CostChange = 0x1000,
+        TraitChange = 0x2000,
+        AbilityChange = 0x4000,
+        AllChanges = 0x7FFF
+    };
+    Q_DECLARE_FLAGS(Changes, Change)
+
     Card(QObject *parent = nullptr, const FAttributeModel* attributeModel = nullptr, const FLanguageModel *languageModel = nullptr);
 
+    // Transactions nest, changed() is sent once when the outermost one ends
+    void beginUpdate() { m_updateDepth++; }
+    void endUpdate();
+    bool isUpdating() const { return m_updateDepth > 0; }
+
     const QMap<int, const FCardType*> cardTypes() const { return m_cardTypes; }
     const QMap<int, const FGeneralCardType*> generalCardTypes() const { return m_generalCardTypes; }
     const QMap<int, const FAttribute*> attributes() const { return m_attributes; }
     const FRarity *rarity() const { return m_rarity; }
     WillCostModel* willCostModel() { return m_willCostModel; }
+    const WillCostModel* willCostModel() const { return m_willCostModel; }
     LangStringListModel *traitModel() const { return m_traitModel; }
     LangStringListModel *abilityTextModel() const { return m_abilityTextModel; }
     const FLanguageString cardName() const { return m_cardName; }
@@ -55,8 +82,8 @@ public:
 
 public slots:
     void setRarity(const FRarity *rarity);
-    void setCardName(FLanguageString cardName) { m_cardName = cardName; emit cardNameChanged(cardName); }
-    void setFlavorText(FLanguageString flavorText) { m_flavorText = flavorText; emit flavorTextChanged(flavorText); }
+    void setCardName(FLanguageString cardName) { m_cardName = cardName; emit cardNameChanged(cardName); markChanged(CardNameChange); }
+    void setFlavorText(FLanguageString flavorText) { m_flavorText = flavorText; emit flavorTextChanged(flavorText); markChanged(FlavorTextChange); }
 
     void setShowStats(bool showStats);
     void setShowCost(bool showCost);
@@ -93,6 +120,9 @@ signals:
 
     void redraw(QRectF rect = QRectF());
 
+    // Sent once per transaction, or per change outside of one
+    void changed(Card::Changes changes);
+
 private:
     QMap<int, const FCardType*> m_cardTypes;
     QMap<int, const FGeneralCardType*> m_generalCardTypes;
@@ -115,6 +145,27 @@ private:
     bool m_showBorder;
     bool m_showTextBox;
     bool m_showQuickcast;
+
+    int m_updateDepth;
+    Changes m_pendingChanges;
+
+    void markChanged(Change change);
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(Card::Changes)
+
+/*!
+ * \brief Keeps a Card transaction open for the lifetime of the locker.
+ */
+class CardUpdateLocker
+{
+public:
+    explicit CardUpdateLocker(Card *card) : m_card(card) { if (m_card) m_card->beginUpdate(); }
+    ~CardUpdateLocker() { if (m_card) m_card->endUpdate(); }
+
+private:
+    Q_DISABLE_COPY(CardUpdateLocker)
+    Card *m_card;
 };
 
 #endif // CARD_H
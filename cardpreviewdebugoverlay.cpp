@@ -0,0 +1,97 @@
+#include <QPainter>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include "cardpreviewdebugoverlay.h"
+#include "cardpreviewitem.h"
+#include "renderstats.h"
+
+#define OVERLAY_PADDING 6
+
+static QString formatMsecs(qint64 nsecs)
+{
+    return QString("%1 ms").arg(nsecs / 1000000.0, 7, 'f', 2);
+}
+
+static QString formatCache(const char *name, const CacheCounter &counter)
+{
+    return QString("%1 %2% (%3/%4)").arg(QString(name), -12)
+            .arg(counter.hitRate() * 100, 5, 'f', 1)
+            .arg(counter.hits())
+            .arg(counter.hits() + counter.misses());
+}
+
+CardPreviewDebugOverlay::CardPreviewDebugOverlay(CardPreviewItem *card)
+    : QGraphicsItem(card), m_card(card)
+{
+    setFlag(QGraphicsItem::ItemIgnoresTransformations);
+    setZValue(1000);
+    m_font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+}
+
+QRectF CardPreviewDebugOverlay::boundingRect() const
+{
+    return m_rect;
+}
+
+void CardPreviewDebugOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem * /*option*/, QWidget * /*widget*/)
+{
+    painter->fillRect(m_rect, QColor(0, 0, 0, 190));
+    painter->setPen(Qt::white);
+    painter->setFont(m_font);
+
+    QFontMetrics fm(m_font);
+    int y = OVERLAY_PADDING + fm.ascent();
+    QStringList::const_iterator it = m_lines.constBegin();
+    for (; it != m_lines.constEnd(); ++it) {
+        painter->drawText(OVERLAY_PADDING, y, *it);
+        y += fm.lineSpacing();
+    }
+}
+
+void CardPreviewDebugOverlay::refresh()
+{
+    m_lines.clear();
+
+    const CardRenderer *renderer = m_card->renderer();
+    m_lines << QStringLiteral("Last paint");
+    qint64 total = 0;
+    for (int i = 0; i < CardRenderer::LayerCount; ++i) {
+        const CardRenderer::Layer layer = CardRenderer::Layer(i);
+        total += renderer->layerPaintTime(layer);
+        m_lines << QString("  %1 %2").arg(QString(CardRenderer::layerName(layer)), -12).arg(formatMsecs(renderer->layerPaintTime(layer)));
+    }
+    m_lines << QString("  %1 %2").arg(QString("Total"), -12).arg(formatMsecs(total));
+
+    addTextItemLines(QStringLiteral("Card name"), renderer->textBox(CardRenderer::CardNameText));
+    addTextItemLines(QStringLiteral("Card type"), renderer->textBox(CardRenderer::CardTypeText));
+    addTextItemLines(QStringLiteral("Abilities"), renderer->textBox(CardRenderer::AbilityText));
+    addTextItemLines(QStringLiteral("Flavor"), renderer->textBox(CardRenderer::FlavorText));
+
+    const RenderStats *stats = RenderStats::Instance();
+    m_lines << QStringLiteral("Cache hit rate");
+    m_lines << QStringLiteral("  ") + formatCache("Decorations", stats->decorations);
+    m_lines << QStringLiteral("  ") + formatCache("Symbols", stats->symbols);
+    m_lines << QStringLiteral("  ") + formatCache("Keywords", stats->keywords);
+
+    QFontMetrics fm(m_font);
+    int width = 0;
+    QStringList::const_iterator it = m_lines.constBegin();
+    for (; it != m_lines.constEnd(); ++it) {
+        width = qMax(width, fm.horizontalAdvance(*it));
+    }
+
+    prepareGeometryChange();
+    m_rect = QRectF(0, 0, width + OVERLAY_PADDING * 2, fm.lineSpacing() * m_lines.size() + OVERLAY_PADDING * 2);
+    update();
+}
+
+void CardPreviewDebugOverlay::addTextItemLines(const QString &name, const FTextBox *item)
+{
+    const FTextFitStats &fit = item->lastFit();
+    m_lines << name;
+    m_lines << QString("  %1 %2%3").arg(QString("Paint"), -12).arg(formatMsecs(item->lastPaintTime()))
+               .arg(item->lastPaintRendered() ? QString(" (rendered)") : QString(" (cached)"));
+    m_lines << QString("  %1 %2, %3 layout passes").arg(QString("Fit"), -12).arg(formatMsecs(fit.nsecs)).arg(fit.layoutPasses);
+    m_lines << QString("  %1 %2pt, spacing %3%, stretch %4").arg(QString("Font"), -12).arg(fit.pointSize).arg(fit.letterSpacing).arg(fit.stretch);
+    m_lines << QString("  %1 %2 KiB").arg(QString("Backing"), -12).arg(item->backingStoreBytes() / 1024);
+}
@@ -0,0 +1,37 @@
+#ifndef CARDPREVIEWDEBUGOVERLAY_H
+#define CARDPREVIEWDEBUGOVERLAY_H
+
+#include <QGraphicsItem>
+#include <QStringList>
+#include <QFont>
+
+class CardPreviewItem;
+class FTextBox;
+
+/*!
+ * \brief Shows paint times, text fit results and cache hit rates on top of a card preview.
+ *
+ * The overlay ignores the view transformation so it stays readable at any
+ * zoom level. It only reads the statistics in refresh(), painting it does
+ * not touch the card.
+ */
+class CardPreviewDebugOverlay : public QGraphicsItem
+{
+public:
+    explicit CardPreviewDebugOverlay(CardPreviewItem *card);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    void refresh();
+
+private:
+    CardPreviewItem *m_card;
+    QStringList m_lines;
+    QFont m_font;
+    QRectF m_rect;
+
+    void addTextItemLines(const QString &name, const FTextBox *item);
+};
+
+#endif // CARDPREVIEWDEBUGOVERLAY_H
@@ -1,7 +1,10 @@
 #include "cardpreviewwidget.h"
 #include "ui_cardpreviewwidget.h"
 #include "cardpreviewitem.h"
+#include "tracer.h"
 
+#include <QFileInfo>
+#include <QDir>
 #include <QDebug>
 
 #if QT_CONFIG(wheelevent)
@@ -11,6 +14,7 @@
 CardPreviewWidget::CardPreviewWidget(QWidget *parent) :
     QWidget(parent),
     ui(new Ui::CardPreviewWidget),
+    m_snapshot(FModelSnapshot::current()),
     view_width(100),
     view_height(30)
 {
@@ -20,6 +24,7 @@ CardPreviewWidget::CardPreviewWidget(QWidget *parent) :
     ui->graphicsView->setBackgroundBrush(QBrush(QColor(230,230,230)));
 
     scene = new QGraphicsScene(this);
+    m_dependencies = new CardDependencyIndex(this);
 
     ui->graphicsView->setScene(scene);
 
@@ -31,6 +36,9 @@ CardPreviewWidget::CardPreviewWidget(QWidget *parent) :
     QObject::connect(this, &CardPreviewWidget::zoomChanged, ui->slider_zoom, &QSlider::setValue);
 
     QObject::connect(ui->btn_fit_view, &QPushButton::clicked, this, &CardPreviewWidget::fitInView);
+
+    m_debugOverlayTimer.setInterval(DEBUG_OVERLAY_REFRESH_INTERVAL);
+    QObject::connect(&m_debugOverlayTimer, &QTimer::timeout, this, &CardPreviewWidget::refreshDebugOverlays);
 }
 
 CardPreviewWidget::~CardPreviewWidget()
@@ -54,19 +62,81 @@ void CardPreviewWidget::addCard(const Card *card)
         }
         m_items.push_back(item);
         m_cards.push_back(card);
+        m_dependencies->watch(m_items.size() - 1, card);
         item->setPos(totalWidth, 0);
         scene->addItem(item);
     }
 }
 
+void CardPreviewWidget::removeCard(const Card *card)
+{
+    const int index = m_cards.indexOf(card);
+    if (index < 0) return;
+
+    CardPreviewItem *item = m_items.takeAt(index);
+    m_cards.remove(index);
+    scene->removeItem(item);
+    delete item;
+
+    // Dependencies are kept by item index, the following items move up
+    m_dependencies->unwatch(card);
+    for (int i = index; i < m_cards.size(); ++i) {
+        m_dependencies->watch(i, m_cards.at(i));
+    }
+    m_dependencies->removeCard(m_cards.size());
+
+    qreal totalWidth = 0;
+    QVector<CardPreviewItem*>::const_iterator it = m_items.constBegin();
+    for (; it != m_items.constEnd(); ++it) {
+        (*it)->setPos(totalWidth, 0);
+        totalWidth += (*it)->boundingRect().width() + CARD_MARGIN;
+    }
+}
+
 void CardPreviewWidget::saveToPNG(const QString &filename)
 {
+    exportImages(filename, EncoderOptions(), false);
+}
+
+/*!
+ * \brief Encodes the whole scene into filename, or every card into its own file with the
+ * card's number appended. Cards render while the previous ones encode.
+ */
+bool CardPreviewWidget::exportImages(const QString &filename, const EncoderOptions &options, bool splitCards)
+{
+    FTRACE_SCOPE(Export, "CardPreviewWidget::exportImages");
+    ImageEncoder encoder(options);
+    if (!splitCards || m_items.size() <= 1) {
+        encoder.encode(renderScene(scene->sceneRect()), filename);
+    } else {
+        const QFileInfo info(filename);
+        const QString base = info.dir().filePath(info.completeBaseName());
+        for (int i = 0; i < m_items.size(); ++i) {
+            const QString cardFile = QString("%1-%2.%3").arg(base).arg(i + 1).arg(ImageEncoder::fileExtension(options.format));
+            encoder.encode(renderScene(m_items.at(i)->sceneBoundingRect()), cardFile);
+        }
+    }
 
-    QRectF sceneRect = scene->sceneRect();
-    QPixmap pix(sceneRect.size().toSize());
-    QPainter p(&pix);
-    scene->render(&p, sceneRect);
-    pix.save(filename, "png", 100);
+    const bool encoded = encoder.waitForDone();
+    const QVector<EncodedImage> results = encoder.results();
+    QVector<EncodedImage>::const_iterator it = results.constBegin();
+    for (; it != results.constEnd(); ++it) {
+        qInfo(qUtf8Printable(tr("Encoded '%1', %2 bytes in %3 ms.").arg(it->fileName).arg(it->bytes).arg(it->nsecs / 1000000.0, 0, 'f', 1)));
+    }
+    if (!encoded) {
+        qWarning(qUtf8Printable(encoder.errorString()));
+    }
+    return encoded;
+}
+
+QImage CardPreviewWidget::renderScene(const QRectF &sceneRect) const
+{
+    FTRACE_SCOPE(Export, "render scene");
+    QImage image(sceneRect.size().toSize(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter p(&image);
+    scene->render(&p, QRectF(image.rect()), sceneRect);
+    return image;
 }
 
 void CardPreviewWidget::zoomIn(int level)
@@ -138,12 +208,58 @@ void CardPreviewWidget::fitInView()
     ui->spinbox_zoom->setValue(int(round(xratio * 100)));
 }
 
+/*!
+ * \brief Sets the font on every card, only the cards showing text in it are redrawn.
+ */
 void CardPreviewWidget::setFont(OptionsWindow::FontUpdateType type, const QFont &font)
 {
-    QVector<CardPreviewItem*> data = m_items;
-    QVector<CardPreviewItem*>::iterator iter = data.begin();
-    for (; iter != data.end(); ++iter) {
-        (*iter)->setTextItemFont(type, font);
+    QVector<CardPreviewItem*>::const_iterator it = m_items.constBegin();
+    for (; it != m_items.constEnd(); ++it) {
+        (*it)->setTextItemFont(type, font);
+    }
+
+    QString key;
+    switch (type) {
+    case OptionsWindow::FontCardname: key = "cardname"; break;
+    case OptionsWindow::FontCardtype: key = "cardtype"; break;
+    case OptionsWindow::FontAbilities: key = "abilities"; break;
+    case OptionsWindow::FontFlavor: key = "flavor"; break;
+    case OptionsWindow::FontVoidCost: key = "voidcost"; break;
+    case OptionsWindow::FontStats: return; // Not drawn yet
+    }
+    const QVector<int> cards = m_dependencies->dependents(CardDependency(CardDependency::Font, key));
+    QVector<int>::const_iterator card = cards.constBegin();
+    for (; card != cards.constEnd(); ++card) {
+        m_items.at(*card)->update();
+    }
+}
+
+/*!
+ * \brief Redraws the cards using model entries that differ in the published snapshot.
+ */
+void CardPreviewWidget::updateSnapshot()
+{
+    const FModelSnapshotPtr snapshot = FModelSnapshot::current();
+    if (snapshot == m_snapshot) return;
+
+    if (snapshot->countryCode() == m_snapshot->countryCode()) {
+        invalidate(CardDependencyIndex::changes(*m_snapshot, *snapshot));
+    } else {
+        QVector<CardPreviewItem*>::const_iterator it = m_items.constBegin();
+        for (; it != m_items.constEnd(); ++it) {
+            (*it)->redraw();
+        }
+    }
+    m_snapshot = snapshot;
+}
+
+void CardPreviewWidget::invalidate(const CardDependencyList &changes)
+{
+    const QVector<int> cards = m_dependencies->dependents(changes);
+    QVector<int>::const_iterator it = cards.constBegin();
+    for (; it != cards.constEnd(); ++it) {
+        // Ids of moved entries change, read the record again
+        m_items.at(*it)->applyChanges(Card::AllChanges);
     }
 }
 
@@ -153,8 +269,23 @@ void CardPreviewWidget::on_btn_debug_toggled(bool checked)
     QVector<CardPreviewItem*> data = m_items;
     QVector<CardPreviewItem*>::iterator iter = data.begin();
     for (; iter != data.end(); ++iter) {
+        (*iter)->setDebugOverlayVisible(checked);
         (*iter)->redraw();
     }
+    // The overlay shows numbers of the previous paint, keep it following along
+    if (checked) {
+        m_debugOverlayTimer.start();
+    } else {
+        m_debugOverlayTimer.stop();
+    }
+}
+
+void CardPreviewWidget::refreshDebugOverlays()
+{
+    QVector<CardPreviewItem*>::const_iterator iter = m_items.constBegin();
+    for (; iter != m_items.constEnd(); ++iter) {
+        (*iter)->refreshDebugOverlay();
+    }
 }
 
 void CardPreviewWidget::on_btn_zoom_100_clicked()
@@ -4,9 +4,12 @@
 #include <QWidget>
 #include <QGraphicsView>
 #include <QGraphicsScene>
+#include <QTimer>
 
 #include "card.h"
 #include "cardpreviewitem.h"
+#include "cardset/carddependencyindex.h"
+#include "render/imageencoder.h"
 #include "dialogs/optionswindow.h"
 
 namespace Ui {
@@ -14,6 +17,7 @@ class CardPreviewWidget;
 }
 
 #define CARD_MARGIN 20
+#define DEBUG_OVERLAY_REFRESH_INTERVAL 500 // msecs
 
 class CardPreviewWidget : public QWidget
 {
@@ -24,29 +28,39 @@ public:
     ~CardPreviewWidget();
 
     void addCard(const Card *card);
+    void removeCard(const Card *card);
     void saveToPNG(const QString &filename);
+    bool exportImages(const QString &filename, const EncoderOptions &options, bool splitCards);
 
 private:
     Ui::CardPreviewWidget *ui;
     QVector<const Card*> m_cards;
     QVector<CardPreviewItem*> m_items;
+    CardDependencyIndex *m_dependencies; // By item index
+    FModelSnapshotPtr m_snapshot; // Compared against the next published one
     QGraphicsScene *scene;
     QFont m_voidCostFont;
+    QTimer m_debugOverlayTimer;
 
     int view_width;
     int view_height;
 
+    QImage renderScene(const QRectF &sceneRect) const;
+
 public slots:
     void zoomIn(int level = 1);
     void zoomOut(int level = 1);
     void setZoom(int zoom = 100);
     void fitInView();
     void setFont(OptionsWindow::FontUpdateType type, const QFont &font);
+    void updateSnapshot();
+    void invalidate(const CardDependencyList &changes);
 
 signals:
     void zoomChanged(int zoom);
 private slots:
     void on_btn_debug_toggled(bool checked);
+    void refreshDebugOverlays();
     void on_btn_zoom_100_clicked();
     void on_btn_zoom_50_clicked();
 };
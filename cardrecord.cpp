@@ -0,0 +1,293 @@
+#include "cardrecord.h"
+#include "card.h"
+
+CardRecord::CardRecord()
+    : attributeCount(0), showFlags(DefaultShowFlags), side(0), rarity(0)
+{
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        cardTypes[i] = -1;
+        generalCardTypes[i] = -1;
+    }
+    for (int i = 0; i < MAX_CARD_ATTRIBUTES; ++i) {
+        attributes[i] = -1;
+    }
+}
+
+CardRecord CardRecord::fromCard(const Card *card)
+{
+    CardRecord record;
+    if (!card) return record;
+
+    const QMap<int, const FCardType*> cardTypes = card->cardTypes();
+    QMap<int, const FCardType*>::const_iterator ctIter = cardTypes.constBegin();
+    for (; ctIter != cardTypes.constEnd(); ++ctIter) {
+        if (ctIter.key() < 0 || ctIter.key() >= MAX_CARD_TYPES) {
+            qWarning(qUtf8Printable(QObject::tr("Card type slot %1 exceeds the maximum of %2 card types.").arg(ctIter.key()).arg(MAX_CARD_TYPES)));
+            continue;
+        }
+        record.cardTypes[ctIter.key()] = qint16(ctIter.value()->id());
+    }
+
+    const QMap<int, const FGeneralCardType*> generalCardTypes = card->generalCardTypes();
+    QMap<int, const FGeneralCardType*>::const_iterator gctIter = generalCardTypes.constBegin();
+    for (; gctIter != generalCardTypes.constEnd(); ++gctIter) {
+        if (gctIter.key() < 0 || gctIter.key() >= MAX_CARD_TYPES) {
+            qWarning(qUtf8Printable(QObject::tr("General card type slot %1 exceeds the maximum of %2 card types.").arg(gctIter.key()).arg(MAX_CARD_TYPES)));
+            continue;
+        }
+        record.generalCardTypes[gctIter.key()] = qint16(gctIter.value()->id());
+    }
+
+    const QMap<int, const FAttribute*> attributes = card->attributes();
+    QMap<int, const FAttribute*>::const_iterator attrIter = attributes.constBegin();
+    for (; attrIter != attributes.constEnd(); ++attrIter) {
+        if (!record.addAttribute(attrIter.key())) {
+            qWarning(qUtf8Printable(QObject::tr("Card has more than %1 attributes, ignoring '%2'.").arg(MAX_CARD_ATTRIBUTES).arg(attrIter.value()->stringId())));
+        }
+    }
+
+    record.rarity = card->rarity() ? qint16(card->rarity()->id()) : 0;
+
+    record.showFlags = 0;
+    record.setShowFlag(ShowStats, card->showStats());
+    record.setShowFlag(ShowCost, card->showCost());
+    record.setShowFlag(ShowSmallTextBox, card->showSmallTextBox());
+    record.setShowFlag(ShowBorder, card->showBorder());
+    record.setShowFlag(ShowTextBox, card->showTextBox());
+    record.setShowFlag(ShowQuickcast, card->showQuickcast());
+
+    const WillCostModel *costModel = card->willCostModel();
+    QMap<int, WillCostEntry>::const_iterator costIter = costModel->entries().constBegin();
+    for (; costIter != costModel->entries().constEnd(); ++costIter) {
+        const WillCost cost = costModel->cost(costIter.key());
+        record.costs.append(CardRecordCost(qint8(cost.attribute->id()),
+                                           cost.characteristic ? qint8(cost.characteristic->id()) : qint8(-1),
+                                           qint8(cost.cost), cost.dynamic));
+    }
+
+    record.cardName = card->cardName();
+    record.flavorText = card->flavorText();
+
+    const LangStringListModel *traits = card->traitModel();
+    record.traits.reserve(traits->rowCount(QModelIndex()));
+    for (int i = 0; i < traits->rowCount(QModelIndex()); ++i) {
+        record.traits.append(traits->data(traits->index(i), Qt::DisplayRole).value<FLanguageString>());
+    }
+
+    const LangStringListModel *abilities = card->abilityTextModel();
+    record.abilities.reserve(abilities->rowCount(QModelIndex()));
+    for (int i = 0; i < abilities->rowCount(QModelIndex()); ++i) {
+        record.abilities.append(abilities->data(abilities->index(i), Qt::DisplayRole).value<FLanguageString>());
+    }
+
+    return record;
+}
+
+void CardRecord::applyTo(Card *card) const
+{
+    if (!card) return;
+    CardUpdateLocker locker(card);
+
+    const FRarity *cardRarity = FRarityModel::Instance()->get(rarity);
+    if (cardRarity) {
+        card->setRarity(cardRarity);
+    }
+
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        const FCardType *cardType = cardTypes[i] >= 0 ? FCardTypeModel::Instance()->get(cardTypes[i]) : nullptr;
+        if (cardType) {
+            if (card->cardTypes().value(i, nullptr) != cardType) {
+                card->addCardType(i, cardType);
+            }
+        } else {
+            card->removeCardType(i);
+        }
+
+        const FGeneralCardType *generalCardType = generalCardTypes[i] >= 0 ? FGeneralCardTypeModel::Instance()->get(generalCardTypes[i]) : nullptr;
+        if (generalCardType) {
+            if (card->generalCardTypes().value(i, nullptr) != generalCardType) {
+                card->addGeneralCardType(i, generalCardType);
+            }
+        } else {
+            card->removeGeneralCardType(i);
+        }
+    }
+
+    const QMap<int, const FAttribute*> currentAttributes = card->attributes();
+    QMap<int, const FAttribute*>::const_iterator attrIter = currentAttributes.constBegin();
+    for (; attrIter != currentAttributes.constEnd(); ++attrIter) {
+        if (!hasAttribute(attrIter.key())) {
+            card->removeAttribute(attrIter.value());
+        }
+    }
+    for (int i = 0; i < attributeCount; ++i) {
+        const FAttribute *attribute = FAttributeModel::Instance()->get(attributes[i]);
+        if (attribute) {
+            card->addAttribute(attribute);
+        }
+    }
+
+    card->setShowStats(showFlag(ShowStats));
+    card->setShowCost(showFlag(ShowCost));
+    card->setShowSmallTextBox(showFlag(ShowSmallTextBox));
+    card->setShowBorder(showFlag(ShowBorder));
+    card->setShowTextBox(showFlag(ShowTextBox));
+    card->setShowQuickcast(showFlag(ShowQuickcast));
+
+    WillCostModel *costModel = card->willCostModel();
+    const QList<int> currentRows = costModel->entries().keys();
+    QList<int>::const_iterator rowIter = currentRows.constBegin();
+    for (; rowIter != currentRows.constEnd(); ++rowIter) {
+        const WillCost current = costModel->cost(*rowIter);
+        if (indexOfCost(current.attribute->id(), current.characteristic ? current.characteristic->id() : -1) < 0) {
+            costModel->setDynamic(*rowIter, false);
+            costModel->setCost(*rowIter, 0);
+        }
+    }
+    QVector<CardRecordCost>::const_iterator costIter = costs.constBegin();
+    for (; costIter != costs.constEnd(); ++costIter) {
+        int row = costModel->rowOf(costIter->attribute, costIter->characteristic);
+        if (row < 0) continue;
+        // Dynamic first, toggling it may clamp the cost
+        costModel->setDynamic(row, costIter->dynamic);
+        costModel->setCost(row, costIter->cost);
+    }
+
+    card->setCardName(cardName);
+    card->setFlavorText(flavorText);
+
+    LangStringListModel *traitModel = card->traitModel();
+    if (traitModel->rowCount(QModelIndex()) > 0) {
+        traitModel->removeRows(0, traitModel->rowCount(QModelIndex()), QModelIndex());
+    }
+    QVector<FLanguageString>::const_iterator traitIter = traits.constBegin();
+    for (; traitIter != traits.constEnd(); ++traitIter) {
+        traitModel->addLanguageString(*traitIter);
+    }
+
+    LangStringListModel *abilityModel = card->abilityTextModel();
+    if (abilityModel->rowCount(QModelIndex()) > 0) {
+        abilityModel->removeRows(0, abilityModel->rowCount(QModelIndex()), QModelIndex());
+    }
+    QVector<FLanguageString>::const_iterator abilityIter = abilities.constBegin();
+    for (; abilityIter != abilities.constEnd(); ++abilityIter) {
+        abilityModel->addLanguageString(*abilityIter);
+    }
+}
+
+void CardRecord::setShowFlag(ShowFlag flag, bool enabled)
+{
+    if (enabled) {
+        showFlags |= flag;
+    } else {
+        showFlags &= quint8(~flag);
+    }
+}
+
+int CardRecord::cardTypeCount() const
+{
+    int count = 0;
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        if (cardTypes[i] >= 0) count++;
+    }
+    return count;
+}
+
+bool CardRecord::hasAttribute(int id) const
+{
+    for (int i = 0; i < attributeCount; ++i) {
+        if (attributes[i] == id) return true;
+    }
+    return false;
+}
+
+bool CardRecord::addAttribute(int id)
+{
+    if (hasAttribute(id)) return true;
+    if (attributeCount >= MAX_CARD_ATTRIBUTES) return false;
+
+    // Keep the array sorted, same order as the QMap in Card
+    int pos = attributeCount;
+    while (pos > 0 && attributes[pos - 1] > id) {
+        attributes[pos] = attributes[pos - 1];
+        pos--;
+    }
+    attributes[pos] = qint8(id);
+    attributeCount++;
+    return true;
+}
+
+int CardRecord::indexOfCost(int attribute, int characteristic) const
+{
+    for (int i = 0; i < costs.size(); ++i) {
+        if (costs.at(i).attribute == attribute && costs.at(i).characteristic == characteristic) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int CardRecord::cost(int attribute, int characteristic) const
+{
+    int index = indexOfCost(attribute, characteristic);
+    return index >= 0 ? costs.at(index).cost : 0;
+}
+
+void CardRecord::setCost(int attribute, int characteristic, int cost, bool dynamic)
+{
+    int index = indexOfCost(attribute, characteristic);
+    if (cost == 0 && !dynamic) {
+        if (index >= 0) costs.remove(index);
+        return;
+    }
+    if (index >= 0) {
+        costs[index].cost = qint8(cost);
+        costs[index].dynamic = dynamic;
+    } else {
+        costs.append(CardRecordCost(qint8(attribute), qint8(characteristic), qint8(cost), dynamic));
+    }
+}
+
+QDataStream &operator<<(QDataStream &out, const CardRecord &record)
+{
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        out << record.cardTypes[i] << record.generalCardTypes[i];
+    }
+    out << record.attributeCount;
+    for (int i = 0; i < record.attributeCount; ++i) {
+        out << record.attributes[i];
+    }
+    out << record.showFlags << record.side << record.rarity;
+    out << quint32(record.costs.size());
+    QVector<CardRecordCost>::const_iterator it = record.costs.constBegin();
+    for (; it != record.costs.constEnd(); ++it) {
+        out << it->attribute << it->characteristic << it->cost << it->dynamic;
+    }
+    out << record.cardName << record.flavorText << record.traits << record.abilities;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, CardRecord &record)
+{
+    record = CardRecord();
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        in >> record.cardTypes[i] >> record.generalCardTypes[i];
+    }
+    quint8 attributeCount = 0;
+    in >> attributeCount;
+    for (int i = 0; i < attributeCount; ++i) {
+        qint8 attribute = -1;
+        in >> attribute;
+        record.addAttribute(attribute);
+    }
+    in >> record.showFlags >> record.side >> record.rarity;
+    quint32 costCount = 0;
+    in >> costCount;
+    for (quint32 i = 0; i < costCount && in.status() == QDataStream::Ok; ++i) {
+        CardRecordCost cost;
+        in >> cost.attribute >> cost.characteristic >> cost.cost >> cost.dynamic;
+        record.costs.append(cost);
+    }
+    in >> record.cardName >> record.flavorText >> record.traits >> record.abilities;
+    return in;
+}
@@ -0,0 +1,92 @@
+#ifndef CARDRECORD_H
+#define CARDRECORD_H
+
+#include <QVector>
+#include <QMetaType>
+#include "models/flanguagestring.h"
+#include "util.h"
+
+#define MAX_CARD_ATTRIBUTES 8
+
+class Card;
+
+/*!
+ * \brief A single non-zero entry of a card's will cost.
+ *
+ * Entries reference the attribute and (optionally) the will characteristic by
+ * id, so a record does not depend on the row layout of a WillCostModel.
+ */
+struct CardRecordCost
+{
+    CardRecordCost() : attribute(-1), characteristic(-1), cost(0), dynamic(false) {}
+    CardRecordCost(qint8 attribute, qint8 characteristic, qint8 cost, bool dynamic)
+        : attribute(attribute), characteristic(characteristic), cost(cost), dynamic(dynamic) {}
+
+    bool operator==(const CardRecordCost &other) const
+    {
+        return attribute == other.attribute && characteristic == other.characteristic && cost == other.cost && dynamic == other.dynamic;
+    }
+
+    qint8 attribute;
+    qint8 characteristic; // -1 for the plain attribute row
+    qint8 cost;
+    bool dynamic;
+};
+Q_DECLARE_TYPEINFO(CardRecordCost, Q_PRIMITIVE_TYPE);
+
+/*!
+ * \brief Plain value type holding everything needed to render a card side.
+ *
+ * Unlike Card this is not a QObject and owns no models, so large sets can be
+ * held in memory, copied across threads and passed to the renderer directly.
+ * Unused type slots are -1.
+ */
+class CardRecord
+{
+public:
+    enum ShowFlag : quint8 {
+        ShowStats        = 0x01,
+        ShowCost         = 0x02,
+        ShowSmallTextBox = 0x04,
+        ShowBorder       = 0x08,
+        ShowTextBox      = 0x10,
+        ShowQuickcast    = 0x20
+    };
+    static const quint8 DefaultShowFlags = ShowStats | ShowCost | ShowBorder | ShowTextBox;
+
+    CardRecord();
+
+    static CardRecord fromCard(const Card *card);
+    void applyTo(Card *card) const;
+
+    bool showFlag(ShowFlag flag) const { return (showFlags & flag) != 0; }
+    void setShowFlag(ShowFlag flag, bool enabled);
+
+    int cardTypeCount() const;
+    bool hasAttribute(int id) const;
+    bool addAttribute(int id);
+    int indexOfCost(int attribute, int characteristic = -1) const;
+    int cost(int attribute, int characteristic = -1) const;
+    void setCost(int attribute, int characteristic, int cost, bool dynamic = false);
+
+    qint16 cardTypes[MAX_CARD_TYPES];
+    qint16 generalCardTypes[MAX_CARD_TYPES];
+    qint8 attributes[MAX_CARD_ATTRIBUTES]; // Sorted by id
+    quint8 attributeCount;
+    quint8 showFlags;
+    quint8 side; // 0 = front, following sides of the same card count up
+    qint16 rarity;
+
+    QVector<CardRecordCost> costs; // Only non-zero or dynamic entries
+    FLanguageString cardName;
+    FLanguageString flavorText;
+    QVector<FLanguageString> traits;
+    QVector<FLanguageString> abilities;
+};
+
+Q_DECLARE_METATYPE(CardRecord)
+
+QDataStream &operator<<(QDataStream &out, const CardRecord &record);
+QDataStream &operator>>(QDataStream &in, CardRecord &record);
+
+#endif // CARDRECORD_H
@@ -0,0 +1,366 @@
+#include <QLocale>
+#include "cardcorpusgenerator.h"
+#include "models/fattributemodel.h"
+#include "models/fcardtypemodel.h"
+#include "models/fgeneralcardtypemodel.h"
+#include "models/flanguagemodel.h"
+#include "models/fraritymodel.h"
+#include "util.h"
+
+/* Random numbers */
+
+quint64 SplitMix64::next()
+{
+    quint64 z = (m_state += Q_UINT64_C(0x9E3779B97F4A7C15));
+    z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+    z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+    return z ^ (z >> 31);
+}
+
+quint64 SplitMix64::mix(quint64 value)
+{
+    SplitMix64 rng(value);
+    return rng.next();
+}
+
+quint32 SplitMix64::bounded(quint32 bound)
+{
+    // Multiply instead of modulo, no bias worth caring about for 32 bit bounds
+    return quint32((quint64(quint32(next() >> 32)) * bound) >> 32);
+}
+
+int SplitMix64::range(int min, int max)
+{
+    return min + int(bounded(quint32(max - min + 1)));
+}
+
+double SplitMix64::uniform()
+{
+    return double(next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int SplitMix64::weighted(const int *weights, int count)
+{
+    int total = 0;
+    for (int i = 0; i < count; ++i) total += weights[i];
+    int pick = int(bounded(quint32(total)));
+    for (int i = 0; i < count; ++i) {
+        if (pick < weights[i]) return i;
+        pick -= weights[i];
+    }
+    return count - 1;
+}
+
+/* Text material */
+
+static const char *s_words[] = {
+    "target", "resonator", "card", "your", "you", "control", "opponent", "deck", "hand", "graveyard",
+    "ruler", "J-ruler", "damage", "deals", "gain", "gains", "until", "end", "of", "turn",
+    "put", "into", "from", "the", "a", "an", "each", "all", "other", "this",
+    "remove", "game", "banish", "play", "cast", "chant", "spell", "ability", "abilities", "counter",
+    "draw", "discard", "reveal", "search", "shuffle", "choose", "one", "two", "three", "four",
+    "light", "fire", "water", "wind", "darkness", "void", "moon", "time", "magic", "stone",
+    "attack", "block", "recover", "rest", "battle", "during", "only", "once", "per", "if",
+    "when", "whenever", "enters", "field", "leaves", "destroy", "return", "owner's", "top", "bottom",
+    "look", "at", "cards", "named", "with", "total", "cost", "or", "less", "more",
+    "can't", "be", "targeted", "by", "spells", "instead", "then", "that", "it", "them",
+    "its", "controller", "produces", "will", "pay", "unless", "as", "long", "there", "are",
+    "Fairy", "Tale", "Alice", "Faria", "Melgis", "Arla", "Valentina", "Crimson", "Girl", "Machine",
+    "Dragon", "Vampire", "Angel", "Wolf", "Sage", "Knight", "Wizard", "Human", "Elf", "Beast"
+};
+static const int s_wordCount = int(sizeof(s_words) / sizeof(s_words[0]));
+
+static const char *s_keywords[] = {
+    "Enter", "Judgement", "Energize", "Quickcast", "Awakening", "Incarnation", "Flying", "Swiftness",
+    "First Strike", "Pierce", "Precision", "Imperishable", "Target Attack", "Drain", "Remnant",
+    "Stealth", "Barrier", "Eternal", "Mobilize", "Trigger", "Activate", "Continuous"
+};
+static const int s_keywordCount = int(sizeof(s_keywords) / sizeof(s_keywords[0]));
+
+enum Literal { LiteralArrow, LiteralColon, LiteralPeriod, LiteralComma, LiteralStatsSmall, LiteralStatsLarge, LiteralStatsMinus, LiteralEpithet };
+static const char *s_literals[] = { " ⇨ ", ": ", ".", ",", " [+200/+200]", " [+400/+400]", " [-100/-100]", ", the" };
+
+// Weights are percentages of real card sets, index is the count
+static const int s_nameWordWeights[] = { 0, 10, 35, 30, 17, 8 };
+static const int s_traitWeights[] = { 30, 55, 15 };
+static const int s_abilityWeights[] = { 8, 30, 32, 18, 8, 4 };
+static const int s_attributeWeights[] = { 0, 70, 24, 6 };
+static const int s_attributeCostWeights[] = { 0, 60, 30, 10 };
+static const int s_genericCostWeights[] = { 25, 30, 20, 12, 8, 5 };
+static const int s_rarityWeights[] = { 40, 28, 16, 9, 5, 2 };
+
+#define WEIGHT_COUNT(weights) int(sizeof(weights) / sizeof(weights[0]))
+
+static bool isCJK(QLocale::Language language)
+{
+    return language == QLocale::Japanese || language == QLocale::Chinese || language == QLocale::Korean;
+}
+
+/* Generator */
+
+CardCorpusGenerator::CardCorpusGenerator(const CardCorpusOptions &options)
+    : m_options(options), m_genericAttribute(-1)
+{
+    const QVector<FAbstractObject*> *cardTypes = FCardTypeModel::Instance()->dataVec();
+    QVector<FAbstractObject*>::const_iterator it = cardTypes->constBegin();
+    for (; it != cardTypes->constEnd(); ++it) {
+        m_cardTypes.append(int((*it)->id()));
+    }
+
+    const QVector<FAbstractObject*> *generalCardTypes = FGeneralCardTypeModel::Instance()->dataVec();
+    for (it = generalCardTypes->constBegin(); it != generalCardTypes->constEnd(); ++it) {
+        m_generalCardTypes.append(int((*it)->id()));
+    }
+
+    const QVector<FAbstractObject*> *attributes = FAttributeModel::Instance()->dataVec();
+    for (it = attributes->constBegin(); it != attributes->constEnd(); ++it) {
+        if (static_cast<const FAttribute*>(*it)->isGeneric()) {
+            if (m_genericAttribute == -1) m_genericAttribute = int((*it)->id());
+        } else {
+            m_attributes.append(int((*it)->id()));
+        }
+    }
+
+    // Rarities are listed from common to rare, later ones get the small weights
+    const QVector<FAbstractObject*> *rarities = FRarityModel::Instance()->dataVec();
+    for (it = rarities->constBegin(); it != rarities->constEnd(); ++it) {
+        const int position = m_rarities.size();
+        m_rarities.append(int((*it)->id()));
+        m_rarityWeights.append(position < WEIGHT_COUNT(s_rarityWeights) ? s_rarityWeights[position] : 1);
+    }
+
+    const FLanguageModel *languageModel = FLanguageModel::Instance();
+    const FLanguage *primary = languageModel->defaultLanguage();
+    if (primary) m_countryCodes.append(primary->countryCode());
+    const QVector<FAbstractObject*> *languages = languageModel->dataVec();
+    for (it = languages->constBegin(); it != languages->constEnd(); ++it) {
+        const QString countryCode = static_cast<const FLanguage*>(*it)->countryCode();
+        if (!m_countryCodes.contains(countryCode)) m_countryCodes.append(countryCode);
+    }
+
+    m_symbols = Util::TextObject::Replacements.keys();
+}
+
+QVector<CardRecord> CardCorpusGenerator::card(quint64 index) const
+{
+    // Seed per card so any card can be generated on its own
+    SplitMix64 rng(SplitMix64::mix(m_options.seed) ^ SplitMix64::mix(index));
+
+    const double sides = rng.uniform();
+    const int sideCount = sides < m_options.threeSidedRate ? 3 : sides < m_options.threeSidedRate + m_options.twoSidedRate ? 2 : 1;
+    const qint16 rarity = m_rarities.isEmpty() ? qint16(0) : qint16(m_rarities.at(rng.weighted(m_rarityWeights.constData(), m_rarityWeights.size())));
+
+    QVector<CardRecord> result;
+    result.reserve(sideCount);
+    for (int i = 0; i < sideCount; ++i) {
+        result.append(side(rng, i, rarity));
+    }
+    return result;
+}
+
+QVector<CardRecord> CardCorpusGenerator::generate(int count, quint64 first) const
+{
+    QVector<CardRecord> records;
+    records.reserve(count + count / 10);
+    for (int i = 0; i < count; ++i) {
+        records += card(first + quint64(i));
+    }
+    return records;
+}
+
+CardRecord CardCorpusGenerator::side(SplitMix64 &rng, int sideIndex, qint16 rarity) const
+{
+    CardRecord record;
+    record.side = quint8(sideIndex);
+    record.rarity = rarity;
+
+    if (!m_cardTypes.isEmpty()) {
+        record.cardTypes[0] = qint16(m_cardTypes.at(int(rng.bounded(quint32(m_cardTypes.size())))));
+        if (MAX_CARD_TYPES > 1 && m_cardTypes.size() > 1 && rng.chance(0.1)) {
+            qint16 second = qint16(m_cardTypes.at(int(rng.bounded(quint32(m_cardTypes.size())))));
+            if (second != record.cardTypes[0]) record.cardTypes[1] = second;
+        }
+    }
+    if (!m_generalCardTypes.isEmpty()) {
+        record.generalCardTypes[0] = qint16(m_generalCardTypes.at(int(rng.bounded(quint32(m_generalCardTypes.size())))));
+    }
+
+    // Attributes and their costs
+    const int attributeCount = qMin(rng.weighted(s_attributeWeights, WEIGHT_COUNT(s_attributeWeights)), m_attributes.size());
+    for (int i = 0; i < attributeCount; ++i) {
+        const int attribute = m_attributes.at(int(rng.bounded(quint32(m_attributes.size()))));
+        if (record.hasAttribute(attribute) || !record.addAttribute(attribute)) continue;
+        record.setCost(attribute, -1, rng.weighted(s_attributeCostWeights, WEIGHT_COUNT(s_attributeCostWeights)));
+    }
+    if (m_genericAttribute != -1) {
+        if (rng.chance(0.02)) {
+            record.setCost(m_genericAttribute, -1, 0, true);
+        } else {
+            record.setCost(m_genericAttribute, -1, rng.weighted(s_genericCostWeights, WEIGHT_COUNT(s_genericCostWeights)));
+        }
+    }
+
+    if (rng.chance(0.05)) record.setShowFlag(CardRecord::ShowQuickcast, true);
+    if (rng.chance(0.1)) record.setShowFlag(CardRecord::ShowStats, false);
+    // Back sides are mostly transformed resonators without a cost
+    if (sideIndex > 0 && rng.chance(0.5)) record.setShowFlag(CardRecord::ShowCost, false);
+
+    record.cardName = render(cardName(rng), rng, true);
+
+    const int traitCount = rng.weighted(s_traitWeights, WEIGHT_COUNT(s_traitWeights));
+    for (int i = 0; i < traitCount; ++i) {
+        record.traits.append(render(words(rng, rng.range(1, 2)), rng, false));
+    }
+
+    const int abilityCount = rng.weighted(s_abilityWeights, WEIGHT_COUNT(s_abilityWeights));
+    for (int i = 0; i < abilityCount; ++i) {
+        record.abilities.append(render(ability(rng), rng, false));
+    }
+
+    if (rng.chance(m_options.flavorRate)) {
+        Text flavor = words(rng, rng.range(6, 20));
+        flavor.append({Segment::Literal, LiteralPeriod, false});
+        record.flavorText = render(flavor, rng, false);
+    } else {
+        record.flavorText = FLanguageString(FLanguageModel::Instance());
+    }
+    return record;
+}
+
+CardCorpusGenerator::Text CardCorpusGenerator::words(SplitMix64 &rng, int count) const
+{
+    Text text;
+    text.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        text.append({Segment::Word, rng.bounded(quint32(s_wordCount)), false});
+    }
+    return text;
+}
+
+CardCorpusGenerator::Text CardCorpusGenerator::cardName(SplitMix64 &rng) const
+{
+    Text name = words(rng, rng.weighted(s_nameWordWeights, WEIGHT_COUNT(s_nameWordWeights)));
+    if (rng.chance(0.25)) {
+        name.append({Segment::Literal, LiteralEpithet, false});
+        name += words(rng, rng.range(1, 3));
+    }
+    return name;
+}
+
+CardCorpusGenerator::Text CardCorpusGenerator::ability(SplitMix64 &rng) const
+{
+    Text text;
+    const double kind = rng.uniform();
+    if (kind < 0.30) {
+        // Triggered, "[Enter] ⇨ ..."
+        text.append({Segment::Keyword, rng.bounded(quint32(s_keywordCount)), rng.chance(0.05)});
+        text.append({Segment::Literal, LiteralArrow, false});
+    } else if (kind < 0.55) {
+        // Activated, "[rest][1]: ..."
+        const int costs = rng.range(1, 3);
+        for (int i = 0; i < costs; ++i) {
+            if (!m_symbols.isEmpty() && rng.chance(0.6)) {
+                text.append({Segment::Symbol, rng.bounded(quint32(m_symbols.size())), false});
+            } else {
+                text.append({Segment::VoidCost, quint32(rng.range(0, 9)), false});
+            }
+        }
+        text.append({Segment::Literal, LiteralColon, false});
+    } else if (kind < 0.62) {
+        // Bare keyword like "[Flying]" or "[Energize][u]"
+        text.append({Segment::Keyword, rng.bounded(quint32(s_keywordCount)), rng.chance(0.05)});
+        if (!m_symbols.isEmpty() && rng.chance(0.3)) {
+            text.append({Segment::Symbol, rng.bounded(quint32(m_symbols.size())), false});
+        }
+        return text;
+    }
+
+    // Most abilities are short, a few are long paragraphs
+    int count = 3 + rng.range(0, 10) + rng.range(0, 10);
+    if (rng.chance(0.15)) count += rng.range(0, 30);
+    for (int i = 0; i < count; ++i) {
+        text.append({Segment::Word, rng.bounded(quint32(s_wordCount)), false});
+        if (!m_symbols.isEmpty() && rng.chance(m_options.symbolRate)) {
+            text.append({Segment::Symbol, rng.bounded(quint32(m_symbols.size())), false});
+        }
+        if (i + 1 < count && rng.chance(0.05)) {
+            text.append({Segment::Literal, LiteralComma, false});
+        }
+    }
+    if (rng.chance(0.1)) {
+        text.append({Segment::Literal, quint32(LiteralStatsSmall + rng.range(0, 2)), false});
+    }
+    text.append({Segment::Literal, LiteralPeriod, false});
+    return text;
+}
+
+FLanguageString CardCorpusGenerator::render(const Text &text, SplitMix64 &rng, bool alwaysTranslate) const
+{
+    const FLanguageModel *languageModel = FLanguageModel::Instance();
+    FLanguageString string(languageModel);
+    for (int i = 0; i < m_countryCodes.size(); ++i) {
+        // Always draw, so the sequence does not depend on the outcome
+        const bool translated = rng.chance(m_options.translationRate);
+        if (i == 0 || alwaysTranslate || translated) {
+            const FLanguage *language = languageModel->get(m_countryCodes.at(i));
+            string.setText(m_countryCodes.at(i), renderText(text, language ? language->language() : QLocale::English, m_countryCodes.at(i)));
+        }
+    }
+    return string;
+}
+
+QString CardCorpusGenerator::renderText(const Text &text, QLocale::Language language, const QString &countryCode) const
+{
+    const bool cjk = isCJK(language);
+    // Other latin languages get shifted letters, same lengths but their own terms
+    const int shift = language == QLocale::English ? 0 : int(qHash(countryCode) % 25) + 1;
+
+    QString result;
+    Segment::Type previous = Segment::Literal;
+    bool first = true;
+    Text::const_iterator it = text.constBegin();
+    for (; it != text.constEnd(); ++it) {
+        const bool spaced = !cjk && !first && previous != Segment::Literal;
+        switch (it->type) {
+        case Segment::Word: {
+            if (!cjk && !first && (previous != Segment::Literal || !result.endsWith(' '))) result.append(' ');
+            if (cjk) {
+                // One to three ideographs per word
+                const int length = 1 + int(it->value % 3);
+                for (int k = 0; k < length; ++k) {
+                    result.append(QChar(0x4E00 + int((it->value * 2654435761u + quint32(k) * 40503u) % 2000u)));
+                }
+            } else {
+                QString word = QString::fromUtf8(s_words[it->value]);
+                if (shift != 0) {
+                    for (int k = 0; k < word.size(); ++k) {
+                        const ushort c = word.at(k).unicode();
+                        if (c >= 'a' && c <= 'z') word[k] = QChar('a' + (c - 'a' + shift) % 26);
+                    }
+                }
+                if (first) word[0] = word.at(0).toUpper();
+                result.append(word);
+            }
+            break;
+        }
+        case Segment::Symbol:
+            if (spaced && previous == Segment::Word) result.append(' ');
+            result.append(QLatin1Char('[') + m_symbols.at(int(it->value)) + QLatin1Char(']'));
+            break;
+        case Segment::VoidCost:
+            if (spaced && previous == Segment::Word) result.append(' ');
+            result.append(QString("[%1]").arg(it->value));
+            break;
+        case Segment::Keyword:
+            if (spaced && previous == Segment::Word) result.append(' ');
+            result.append(QString("[%1%2]").arg(QString::fromLatin1(s_keywords[it->value]), it->gradient ? "!" : ""));
+            break;
+        case Segment::Literal:
+            result.append(QString::fromUtf8(s_literals[it->value]));
+            break;
+        }
+        previous = it->type;
+        first = false;
+    }
+    return result;
+}
@@ -0,0 +1,94 @@
+#ifndef CARDCORPUSGENERATOR_H
+#define CARDCORPUSGENERATOR_H
+
+#include <QVector>
+#include <QStringList>
+#include <QLocale>
+#include "cardrecord.h"
+
+/*!
+ * \brief SplitMix64 pseudo random number generator.
+ *
+ * Tiny state and the same sequence on every platform and Qt version, which
+ * QRandomGenerator does not promise.
+ */
+class SplitMix64
+{
+public:
+    explicit SplitMix64(quint64 seed) : m_state(seed) {}
+
+    quint64 next();
+    quint32 bounded(quint32 bound); // [0, bound)
+    int range(int min, int max); // [min, max]
+    double uniform(); // [0, 1)
+    bool chance(double probability) { return uniform() < probability; }
+    int weighted(const int *weights, int count); // Index picked by weight
+
+    static quint64 mix(quint64 value);
+
+private:
+    quint64 m_state;
+};
+
+struct CardCorpusOptions
+{
+    quint64 seed = 1;
+    double translationRate = 0.6; // Chance that a text is filled out in a non-primary language
+    double twoSidedRate = 0.06;
+    double threeSidedRate = 0.01;
+    double flavorRate = 0.3;
+    double symbolRate = 0.04; // Chance per word to be followed by an inline symbol
+};
+
+/*!
+ * \brief Generates synthetic cards for benchmarks and stress runs.
+ *
+ * Types, attributes, rarities, languages and symbols come from the loaded
+ * models and Util::TextObject::Replacements, the texts follow length and
+ * symbol/keyword distributions of real card sets. Card n only depends on
+ * the seed and n, so any range of a corpus can be regenerated exactly and
+ * in parallel.
+ */
+class CardCorpusGenerator
+{
+public:
+    explicit CardCorpusGenerator(const CardCorpusOptions &options = CardCorpusOptions());
+
+    // All sides of card number index, side 0 first
+    QVector<CardRecord> card(quint64 index) const;
+    // Sides of the cards [first, first + count), flattened
+    QVector<CardRecord> generate(int count, quint64 first = 0) const;
+
+    const CardCorpusOptions &options() const { return m_options; }
+    const QStringList &countryCodes() const { return m_countryCodes; }
+
+private:
+    // One piece of a text, rendered per language so symbols line up
+    struct Segment {
+        enum Type : quint8 { Word, Symbol, VoidCost, Keyword, Literal };
+        Type type;
+        quint32 value; // Word index, digit or index into symbols / keywords / literals
+        bool gradient;
+    };
+    typedef QVector<Segment> Text;
+
+    CardCorpusOptions m_options;
+    QVector<int> m_cardTypes;
+    QVector<int> m_generalCardTypes;
+    QVector<int> m_attributes; // Without the generic one
+    int m_genericAttribute;
+    QVector<int> m_rarities;
+    QVector<int> m_rarityWeights;
+    QStringList m_countryCodes; // Primary language first
+    QStringList m_symbols;
+
+    CardRecord side(SplitMix64 &rng, int sideIndex, qint16 rarity) const;
+
+    Text words(SplitMix64 &rng, int count) const;
+    Text cardName(SplitMix64 &rng) const;
+    Text ability(SplitMix64 &rng) const;
+    FLanguageString render(const Text &text, SplitMix64 &rng, bool alwaysTranslate) const;
+    QString renderText(const Text &text, QLocale::Language language, const QString &countryCode) const;
+};
+
+#endif // CARDCORPUSGENERATOR_H
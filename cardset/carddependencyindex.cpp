@@ -0,0 +1,179 @@
+#include <algorithm>
+#include "carddependencyindex.h"
+#include "card.h"
+#include "text/ftexttokenizer.h"
+#include "util.h"
+
+CardDependencyIndex::CardDependencyIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+/*!
+ * \brief Collects the dependencies of a record, the same entries CardRenderer::paint() reads.
+ */
+CardDependencyList CardDependencyIndex::dependencies(const CardRecord &record, const FModelSnapshot &snapshot)
+{
+    QSet<CardDependency> found;
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        const FModelSnapshot::CardType *ct = snapshot.cardType(record.cardTypes[i]);
+        const FModelSnapshot::GeneralCardType *gct = snapshot.generalCardType(record.generalCardTypes[i]);
+        if (ct) found.insert(CardDependency(CardDependency::CardType, ct->stringId));
+        if (gct) found.insert(CardDependency(CardDependency::GeneralCardType, gct->stringId));
+        if (ct || gct) found.insert(CardDependency(CardDependency::Font, "cardtype"));
+    }
+    for (int i = 0; i < record.attributeCount; ++i) {
+        const FModelSnapshot::Attribute *attribute = snapshot.attribute(record.attributes[i]);
+        if (!attribute) continue;
+        found.insert(CardDependency(CardDependency::Attribute, attribute->stringId));
+    }
+    const FModelSnapshot::Rarity *rarity = snapshot.rarity(record.rarity);
+    if (rarity) found.insert(CardDependency(CardDependency::Rarity, rarity->stringId));
+
+    const QString &countryCode = snapshot.countryCode();
+    if (!record.cardName.text(countryCode).isEmpty()) {
+        found.insert(CardDependency(CardDependency::Font, "cardname"));
+    }
+    if (!record.flavorText.text(countryCode).isEmpty()) {
+        found.insert(CardDependency(CardDependency::Font, "flavor"));
+    }
+    QVector<FLanguageString>::const_iterator it = record.abilities.constBegin();
+    for (; it != record.abilities.constEnd(); ++it) {
+        const QString text = it->text(countryCode);
+        if (text.isEmpty()) continue;
+        found.insert(CardDependency(CardDependency::Font, "abilities"));
+
+        const QVector<FTextToken> tokens = FTextTokenizer::tokenize(text);
+        QVector<FTextToken>::const_iterator token = tokens.constBegin();
+        for (; token != tokens.constEnd(); ++token) {
+            if (token->type == FTextToken::VoidCost) {
+                found.insert(CardDependency(CardDependency::Font, "voidcost"));
+                break;
+            }
+        }
+    }
+    return found.toList().toVector();
+}
+
+/*!
+ * \brief Compares two snapshots entry by entry. Added and removed entries count as changed,
+ * so do moved ones since records reference entries by id.
+ */
+CardDependencyList CardDependencyIndex::changes(const FModelSnapshot &before, const FModelSnapshot &after)
+{
+    CardDependencyList changed;
+
+    QVector<FModelSnapshot::Attribute>::const_iterator attrIter = after.attributes().constBegin();
+    for (; attrIter != after.attributes().constEnd(); ++attrIter) {
+        const FModelSnapshot::Attribute *old = before.attribute(attrIter->stringId);
+        if (!old || old->id != attrIter->id || old->iconPath != attrIter->iconPath || old->color != attrIter->color || old->color2 != attrIter->color2
+                || old->name != attrIter->name || old->shortName != attrIter->shortName) {
+            changed.append(CardDependency(CardDependency::Attribute, attrIter->stringId));
+        }
+    }
+    for (attrIter = before.attributes().constBegin(); attrIter != before.attributes().constEnd(); ++attrIter) {
+        if (!after.attribute(attrIter->stringId)) changed.append(CardDependency(CardDependency::Attribute, attrIter->stringId));
+    }
+
+    QVector<FModelSnapshot::CardType>::const_iterator ctIter = after.cardTypes().constBegin();
+    for (; ctIter != after.cardTypes().constEnd(); ++ctIter) {
+        const FModelSnapshot::CardType *old = before.cardType(ctIter->stringId);
+        if (!old || old->id != ctIter->id || old->canFight != ctIter->canFight || old->hasDivinity != ctIter->hasDivinity || old->hasCost != ctIter->hasCost
+                || old->name != ctIter->name || old->combinedNames != ctIter->combinedNames) {
+            changed.append(CardDependency(CardDependency::CardType, ctIter->stringId));
+        }
+    }
+    for (ctIter = before.cardTypes().constBegin(); ctIter != before.cardTypes().constEnd(); ++ctIter) {
+        if (!after.cardType(ctIter->stringId)) changed.append(CardDependency(CardDependency::CardType, ctIter->stringId));
+    }
+
+    QVector<FModelSnapshot::GeneralCardType>::const_iterator gctIter = after.generalCardTypes().constBegin();
+    for (; gctIter != after.generalCardTypes().constEnd(); ++gctIter) {
+        const FModelSnapshot::GeneralCardType *old = before.generalCardType(gctIter->stringId);
+        if (!old || old->id != gctIter->id || old->name != gctIter->name) {
+            changed.append(CardDependency(CardDependency::GeneralCardType, gctIter->stringId));
+        }
+    }
+    for (gctIter = before.generalCardTypes().constBegin(); gctIter != before.generalCardTypes().constEnd(); ++gctIter) {
+        if (!after.generalCardType(gctIter->stringId)) changed.append(CardDependency(CardDependency::GeneralCardType, gctIter->stringId));
+    }
+
+    QVector<FModelSnapshot::Rarity>::const_iterator rarityIter = after.rarities().constBegin();
+    for (; rarityIter != after.rarities().constEnd(); ++rarityIter) {
+        const FModelSnapshot::Rarity *old = before.rarity(rarityIter->stringId);
+        if (!old || old->id != rarityIter->id || old->name != rarityIter->name || old->shortName != rarityIter->shortName) {
+            changed.append(CardDependency(CardDependency::Rarity, rarityIter->stringId));
+        }
+    }
+    for (rarityIter = before.rarities().constBegin(); rarityIter != before.rarities().constEnd(); ++rarityIter) {
+        if (!after.rarity(rarityIter->stringId)) changed.append(CardDependency(CardDependency::Rarity, rarityIter->stringId));
+    }
+    return changed;
+}
+
+void CardDependencyIndex::setCard(int card, const CardRecord &record, const FModelSnapshot &snapshot)
+{
+    removeCard(card);
+    const CardDependencyList list = dependencies(record, snapshot);
+    CardDependencyList::const_iterator it = list.constBegin();
+    for (; it != list.constEnd(); ++it) {
+        m_dependents[*it].insert(card);
+    }
+    m_dependencies.insert(card, list);
+}
+
+void CardDependencyIndex::removeCard(int card)
+{
+    QHash<int, CardDependencyList>::iterator entry = m_dependencies.find(card);
+    if (entry == m_dependencies.end()) return;
+
+    CardDependencyList::const_iterator it = entry->constBegin();
+    for (; it != entry->constEnd(); ++it) {
+        QHash<CardDependency, QSet<int>>::iterator cards = m_dependents.find(*it);
+        if (cards == m_dependents.end()) continue;
+        cards->remove(card);
+        if (cards->isEmpty()) m_dependents.erase(cards);
+    }
+    m_dependencies.erase(entry);
+}
+
+void CardDependencyIndex::clear()
+{
+    m_dependents.clear();
+    m_dependencies.clear();
+}
+
+void CardDependencyIndex::watch(int card, const Card *editorCard)
+{
+    if (!editorCard) return;
+    unwatch(editorCard);
+    m_watched.insert(editorCard, card);
+    setCard(card, CardRecord::fromCard(editorCard), *FModelSnapshot::current());
+
+    QObject::connect(editorCard, &Card::changed, this, [this, editorCard](Card::Changes) {
+        setCard(m_watched.value(editorCard), CardRecord::fromCard(editorCard), *FModelSnapshot::current());
+    });
+}
+
+void CardDependencyIndex::unwatch(const Card *editorCard)
+{
+    if (!m_watched.remove(editorCard)) return;
+    QObject::disconnect(editorCard, nullptr, this, nullptr);
+}
+
+QVector<int> CardDependencyIndex::dependents(const CardDependency &dependency) const
+{
+    return dependents(CardDependencyList() << dependency);
+}
+
+QVector<int> CardDependencyIndex::dependents(const CardDependencyList &dependencies) const
+{
+    QSet<int> cards;
+    CardDependencyList::const_iterator it = dependencies.constBegin();
+    for (; it != dependencies.constEnd(); ++it) {
+        cards.unite(m_dependents.value(*it));
+    }
+    QVector<int> result = cards.toList().toVector();
+    std::sort(result.begin(), result.end());
+    return result;
+}
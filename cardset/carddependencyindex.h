@@ -0,0 +1,82 @@
+#ifndef CARDDEPENDENCYINDEX_H
+#define CARDDEPENDENCYINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include "cardrecord.h"
+#include "models/fmodelsnapshot.h"
+
+class Card;
+
+/*!
+ * \brief Something outside of a card record that its rendering reads.
+ *
+ * Model entries are named by their string id, which stays the same when a
+ * data file is reloaded, fonts by their settings key below "font/". Symbols
+ * are compiled in, CARD_RENDERER_VERSION covers them.
+ */
+struct CardDependency
+{
+    enum Kind : quint8 { Attribute, CardType, GeneralCardType, Rarity, Font };
+
+    CardDependency() : kind(Attribute) {}
+    CardDependency(Kind kind, const QString &id) : kind(kind), id(id) {}
+
+    bool operator==(const CardDependency &other) const { return kind == other.kind && id == other.id; }
+
+    Kind kind;
+    QString id;
+};
+Q_DECLARE_TYPEINFO(CardDependency, Q_MOVABLE_TYPE);
+
+inline uint qHash(const CardDependency &dependency, uint seed = 0)
+{
+    return qHash(dependency.id, seed) ^ uint(dependency.kind);
+}
+
+typedef QVector<CardDependency> CardDependencyList;
+
+/*!
+ * \brief Maps model entries and fonts to the cards using them.
+ *
+ * When a data file changes, changes() tells which entries
+ * differ between the old and the new snapshot and dependents() which cards
+ * have to be rendered again, instead of all of them.
+ */
+class CardDependencyIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CardDependencyIndex(QObject *parent = nullptr);
+
+    // Everything the record reads from the snapshot and the fonts
+    static CardDependencyList dependencies(const CardRecord &record, const FModelSnapshot &snapshot);
+    // Entries that differ. Snapshots of two languages differ in every text, callers invalidate all cards then.
+    static CardDependencyList changes(const FModelSnapshot &before, const FModelSnapshot &after);
+
+    void setCard(int card, const CardRecord &record, const FModelSnapshot &snapshot);
+    void removeCard(int card);
+    void clear();
+
+    // Keeps the entry of an editor card up to date
+    void watch(int card, const Card *editorCard);
+    void unwatch(const Card *editorCard);
+
+    // Cards depending on any of the entries, sorted
+    QVector<int> dependents(const CardDependency &dependency) const;
+    QVector<int> dependents(const CardDependencyList &dependencies) const;
+
+    const CardDependencyList cardDependencies(int card) const { return m_dependencies.value(card); }
+    int cardCount() const { return m_dependencies.size(); }
+
+private:
+    QHash<CardDependency, QSet<int>> m_dependents;
+    QHash<int, CardDependencyList> m_dependencies;
+    QHash<const Card*, int> m_watched;
+};
+
+Q_DECLARE_METATYPE(CardDependencyList)
+
+#endif // CARDDEPENDENCYINDEX_H
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include "cardsearchindex.h"
+#include "cardsetfile.h"
+#include "card.h"
+#include "text/ftexttokenizer.h"
+
+static const CardSearchIndex::Field AllIndexedFields[] = {
+    CardSearchIndex::CardName, CardSearchIndex::Trait, CardSearchIndex::Ability, CardSearchIndex::FlavorText
+};
+
+CardSearchIndex::CardSearchIndex(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void CardSearchIndex::setCard(int card, const CardRecord &record)
+{
+    setField(card, CardName, QVector<FLanguageString>() << record.cardName);
+    setField(card, Trait, record.traits);
+    setField(card, Ability, record.abilities);
+    setField(card, FlavorText, QVector<FLanguageString>() << record.flavorText);
+}
+
+/*!
+ * \brief Replaces the terms of one field of a card. Only the difference to
+ * the previous terms touches the postings.
+ */
+void CardSearchIndex::setField(int card, Field field, const QVector<FLanguageString> &texts)
+{
+    LanguageTerms newTerms;
+    QVector<FLanguageString>::const_iterator textIter = texts.constBegin();
+    for (; textIter != texts.constEnd(); ++textIter) {
+        QHash<QString, QString>::const_iterator langIter = textIter->data()->constBegin();
+        for (; langIter != textIter->data()->constEnd(); ++langIter) {
+            if (langIter.value().isEmpty()) continue;
+            const QStringList terms = FTextTokenizer::terms(langIter.value());
+            QSet<QString> &languageTerms = newTerms[langIter.key()];
+            QStringList::const_iterator termIter = terms.constBegin();
+            for (; termIter != terms.constEnd(); ++termIter) {
+                languageTerms.insert(*termIter);
+            }
+        }
+    }
+
+    const quint64 key = fieldKey(card, field);
+    const LanguageTerms oldTerms = m_fieldTerms.value(key);
+
+    // Drop terms that are gone
+    LanguageTerms::const_iterator oldIter = oldTerms.constBegin();
+    for (; oldIter != oldTerms.constEnd(); ++oldIter) {
+        const QSet<QString> kept = newTerms.value(oldIter.key());
+        QHash<QString, Postings> &languagePostings = m_postings[oldIter.key()];
+        QSet<QString>::const_iterator termIter = oldIter.value().constBegin();
+        for (; termIter != oldIter.value().constEnd(); ++termIter) {
+            if (kept.contains(*termIter)) continue;
+            QHash<QString, Postings>::iterator postings = languagePostings.find(*termIter);
+            if (postings == languagePostings.end()) continue;
+            quint8 fields = quint8(postings->value(card) & ~field);
+            if (fields) {
+                postings->insert(card, fields);
+            } else {
+                postings->remove(card);
+                if (postings->isEmpty()) languagePostings.erase(postings);
+            }
+        }
+    }
+
+    // Add new ones
+    LanguageTerms::const_iterator newIter = newTerms.constBegin();
+    for (; newIter != newTerms.constEnd(); ++newIter) {
+        const QSet<QString> existing = oldTerms.value(newIter.key());
+        QHash<QString, Postings> &languagePostings = m_postings[newIter.key()];
+        QSet<QString>::const_iterator termIter = newIter.value().constBegin();
+        for (; termIter != newIter.value().constEnd(); ++termIter) {
+            if (existing.contains(*termIter)) continue;
+            Postings &postings = languagePostings[*termIter];
+            postings.insert(card, quint8(postings.value(card) | field));
+        }
+    }
+
+    if (newTerms.isEmpty()) {
+        m_fieldTerms.remove(key);
+    } else {
+        m_fieldTerms.insert(key, newTerms);
+    }
+    m_cards.insert(card);
+}
+
+void CardSearchIndex::removeCard(int card)
+{
+    for (Field field : AllIndexedFields) {
+        setField(card, field, QVector<FLanguageString>());
+    }
+    m_cards.remove(card);
+}
+
+void CardSearchIndex::clear()
+{
+    m_postings.clear();
+    m_fieldTerms.clear();
+    m_cards.clear();
+}
+
+void CardSearchIndex::addCardSet(const CardSetReader &reader, int firstCard)
+{
+    for (int i = 0; i < reader.cardCount(); ++i) {
+        setCard(firstCard + i, reader.card(i));
+    }
+}
+
+void CardSearchIndex::watch(int card, Card *editorCard)
+{
+    if (!editorCard) return;
+    unwatch(editorCard);
+    m_watched.insert(editorCard, card);
+    setCard(card, CardRecord::fromCard(editorCard));
+
+    QObject::connect(editorCard, &Card::cardNameChanged, this, [this, editorCard](const FLanguageString cardName) {
+        setField(m_watched.value(editorCard), CardName, QVector<FLanguageString>() << cardName);
+    });
+    QObject::connect(editorCard, &Card::flavorTextChanged, this, [this, editorCard](const FLanguageString flavorText) {
+        setField(m_watched.value(editorCard), FlavorText, QVector<FLanguageString>() << flavorText);
+    });
+
+    const LangStringListModel *traits = editorCard->traitModel();
+    QObject::connect(traits, &LangStringListModel::dataChanged, this, [this, editorCard, traits]() { setModelField(editorCard, Trait, traits); });
+    QObject::connect(traits, &LangStringListModel::rowsRemoved, this, [this, editorCard, traits]() { setModelField(editorCard, Trait, traits); });
+
+    const LangStringListModel *abilities = editorCard->abilityTextModel();
+    QObject::connect(abilities, &LangStringListModel::dataChanged, this, [this, editorCard, abilities]() { setModelField(editorCard, Ability, abilities); });
+    QObject::connect(abilities, &LangStringListModel::rowsRemoved, this, [this, editorCard, abilities]() { setModelField(editorCard, Ability, abilities); });
+}
+
+void CardSearchIndex::unwatch(Card *editorCard)
+{
+    if (!m_watched.remove(editorCard)) return;
+    QObject::disconnect(editorCard, nullptr, this, nullptr);
+    QObject::disconnect(editorCard->traitModel(), nullptr, this, nullptr);
+    QObject::disconnect(editorCard->abilityTextModel(), nullptr, this, nullptr);
+}
+
+void CardSearchIndex::setModelField(const Card *editorCard, Field field, const LangStringListModel *model)
+{
+    QVector<FLanguageString> texts;
+    texts.reserve(model->rowCount(QModelIndex()));
+    for (int i = 0; i < model->rowCount(QModelIndex()); ++i) {
+        texts.append(model->data(model->index(i), Qt::DisplayRole).value<FLanguageString>());
+    }
+    setField(m_watched.value(editorCard), field, texts);
+}
+
+QVector<int> CardSearchIndex::search(const QString &query, const QString &countryCode, Fields fields) const
+{
+    QStringList terms = FTextTokenizer::terms(query);
+    terms.removeDuplicates();
+    if (terms.isEmpty()) return QVector<int>();
+
+    QList<QString> languages;
+    if (countryCode.isEmpty()) {
+        languages = m_postings.keys();
+    } else {
+        languages.append(countryCode);
+    }
+
+    QSet<int> matches;
+    QList<QString>::const_iterator langIter = languages.constBegin();
+    for (; langIter != languages.constEnd(); ++langIter) {
+        QHash<QString, QHash<QString, Postings>>::const_iterator languagePostings = m_postings.constFind(*langIter);
+        if (languagePostings == m_postings.constEnd()) continue;
+
+        QVector<const Postings*> lists;
+        lists.reserve(terms.size());
+        QStringList::const_iterator termIter = terms.constBegin();
+        for (; termIter != terms.constEnd(); ++termIter) {
+            QHash<QString, Postings>::const_iterator postings = languagePostings->constFind(*termIter);
+            if (postings == languagePostings->constEnd()) break;
+            lists.append(&postings.value());
+        }
+        if (lists.size() != terms.size()) continue;
+
+        // Walk the rarest term, look the card up in the others
+        std::sort(lists.begin(), lists.end(), [](const Postings *a, const Postings *b) { return a->size() < b->size(); });
+        Postings::const_iterator cardIter = lists.first()->constBegin();
+        for (; cardIter != lists.first()->constEnd(); ++cardIter) {
+            if (!(cardIter.value() & fields)) continue;
+            bool all = true;
+            for (int i = 1; i < lists.size() && all; ++i) {
+                all = lists.at(i)->value(cardIter.key()) & fields;
+            }
+            if (all) matches.insert(cardIter.key());
+        }
+    }
+
+    QVector<int> result;
+    result.reserve(matches.size());
+    QSet<int>::const_iterator matchIter = matches.constBegin();
+    for (; matchIter != matches.constEnd(); ++matchIter) {
+        result.append(*matchIter);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
@@ -0,0 +1,67 @@
+#ifndef CARDSEARCHINDEX_H
+#define CARDSEARCHINDEX_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include "cardrecord.h"
+
+class Card;
+class CardSetReader;
+class LangStringListModel;
+
+/*!
+ * \brief Inverted index over the card name, trait, ability and flavor texts
+ * of a set, per language.
+ *
+ * Terms are the words, symbols and keywords of FTextTokenizer, so a query
+ * like "[Judgement] human" finds every card mentioning both.
+ */
+class CardSearchIndex : public QObject
+{
+    Q_OBJECT
+public:
+    enum Field : quint8 {
+        CardName = 0x01,
+        Trait = 0x02,
+        Ability = 0x04,
+        FlavorText = 0x08,
+        AllFields = 0x0F
+    };
+    Q_DECLARE_FLAGS(Fields, Field)
+
+    explicit CardSearchIndex(QObject *parent = nullptr);
+
+    void setCard(int card, const CardRecord &record);
+    void setField(int card, Field field, const QVector<FLanguageString> &texts);
+    void removeCard(int card);
+    void clear();
+    void addCardSet(const CardSetReader &reader, int firstCard = 0);
+
+    // Keeps the entry of an editor card up to date
+    void watch(int card, Card *editorCard);
+    void unwatch(Card *editorCard);
+
+    // Cards containing every term of the query, sorted. An empty country code searches all languages.
+    QVector<int> search(const QString &query, const QString &countryCode = QString(), Fields fields = AllFields) const;
+
+    int cardCount() const { return m_cards.size(); }
+    int termCount(const QString &countryCode) const { return m_postings.value(countryCode).size(); }
+
+private:
+    typedef QHash<int, quint8> Postings; // card -> fields containing the term
+    typedef QHash<QString, QSet<QString>> LanguageTerms; // country code -> terms
+
+    QHash<QString, QHash<QString, Postings>> m_postings; // country code -> term -> postings
+    QHash<quint64, LanguageTerms> m_fieldTerms;
+    QSet<int> m_cards;
+    QHash<const Card*, int> m_watched;
+
+    static quint64 fieldKey(int card, Field field) { return (quint64(quint32(card)) << 8) | field; }
+    void setModelField(const Card *editorCard, Field field, const LangStringListModel *model);
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(CardSearchIndex::Fields)
+
+#endif // CARDSEARCHINDEX_H
@@ -0,0 +1,616 @@
+#include <QDataStream>
+#include <QSaveFile>
+#include <QtEndian>
+#include "cardsetfile.h"
+#include "models/fattributemodel.h"
+#include "models/fcardtypemodel.h"
+#include "models/fgeneralcardtypemodel.h"
+#include "models/fraritymodel.h"
+#include "models/fwillcharacteristicmodel.h"
+
+Q_STATIC_ASSERT(MAX_CARD_TYPES <= CARDSET_MAX_CARD_TYPES);
+Q_STATIC_ASSERT(MAX_CARD_ATTRIBUTES <= CARDSET_MAX_ATTRIBUTES);
+
+static const FAbstractYAMLModel *domainModel(int domain)
+{
+    switch (domain) {
+    case CardSetFile::LanguageDomain:
+        return FLanguageModel::Instance();
+    case CardSetFile::AttributeDomain:
+        return FAttributeModel::Instance();
+    case CardSetFile::CharacteristicDomain:
+        return FWillCharacteristicModel::Instance();
+    case CardSetFile::CardTypeDomain:
+        return FCardTypeModel::Instance();
+    case CardSetFile::GeneralCardTypeDomain:
+        return FGeneralCardTypeModel::Instance();
+    case CardSetFile::RarityDomain:
+        return FRarityModel::Instance();
+    }
+    return nullptr;
+}
+
+static const QString domainStringId(int domain, const FAbstractObject *object)
+{
+    switch (domain) {
+    case CardSetFile::LanguageDomain:
+        return static_cast<const FLanguage*>(object)->countryCode();
+    case CardSetFile::AttributeDomain:
+        return static_cast<const FAttribute*>(object)->stringId();
+    case CardSetFile::CharacteristicDomain:
+        return static_cast<const FWillCharacteristic*>(object)->stringId();
+    case CardSetFile::CardTypeDomain:
+        return static_cast<const FCardType*>(object)->stringId();
+    case CardSetFile::GeneralCardTypeDomain:
+        return static_cast<const FGeneralCardType*>(object)->stringId();
+    case CardSetFile::RarityDomain:
+        return static_cast<const FRarity*>(object)->stringId();
+    }
+    return QString();
+}
+
+const QString CardSetFile::stringId(int domain, int id)
+{
+    const FAbstractYAMLModel *model = domainModel(domain);
+    if (!model || id < 0 || id >= model->dataVec()->size()) {
+        return QString();
+    }
+    return domainStringId(domain, model->dataVec()->at(id));
+}
+
+int CardSetFile::id(int domain, const QString &stringId)
+{
+    const FAbstractYAMLModel *model = domainModel(domain);
+    const FAbstractObject *object = model && !stringId.isEmpty() ? model->data()->value(stringId, nullptr) : nullptr;
+    return object ? object->id() : -1;
+}
+
+const CardSetFile::IdTable CardSetFile::idTable()
+{
+    IdTable table(DomainCount);
+    for (int domain = 0; domain < DomainCount; ++domain) {
+        const FAbstractYAMLModel *model = domainModel(domain);
+        if (!model) continue;
+        QVector<FAbstractObject*>::const_iterator it = model->dataVec()->constBegin();
+        for (; it != model->dataVec()->constEnd(); ++it) {
+            table[domain].append(domainStringId(domain, *it));
+        }
+    }
+    return table;
+}
+
+static int remapId(int domain, int id, const CardSetFile::IdTable &before)
+{
+    if (id < 0 || id >= before.at(domain).size()) return -1;
+    return CardSetFile::id(domain, before.at(domain).at(id));
+}
+
+/*!
+ * \brief Moves the model ids of a record from the \a before table to the loaded
+ * models. References to entries that are gone are dropped, as the reader does.
+ */
+void CardSetFile::remap(CardRecord &record, const IdTable &before)
+{
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        record.cardTypes[i] = qint16(remapId(CardTypeDomain, record.cardTypes[i], before));
+        record.generalCardTypes[i] = qint16(remapId(GeneralCardTypeDomain, record.generalCardTypes[i], before));
+    }
+
+    // Attributes are kept sorted by id, which may have changed
+    QVector<int> attributes;
+    for (int i = 0; i < record.attributeCount; ++i) {
+        attributes.append(remapId(AttributeDomain, record.attributes[i], before));
+        record.attributes[i] = -1;
+    }
+    record.attributeCount = 0;
+    QVector<int>::const_iterator attrIter = attributes.constBegin();
+    for (; attrIter != attributes.constEnd(); ++attrIter) {
+        if (*attrIter >= 0) record.addAttribute(*attrIter);
+    }
+
+    record.rarity = qint16(qMax(0, remapId(RarityDomain, record.rarity, before)));
+
+    QVector<CardRecordCost> costs;
+    QVector<CardRecordCost>::const_iterator costIter = record.costs.constBegin();
+    for (; costIter != record.costs.constEnd(); ++costIter) {
+        const int attribute = remapId(AttributeDomain, costIter->attribute, before);
+        const int characteristic = costIter->characteristic < 0 ? -1 : remapId(CharacteristicDomain, costIter->characteristic, before);
+        if (attribute < 0 || (costIter->characteristic >= 0 && characteristic < 0)) continue;
+        costs.append(CardRecordCost(qint8(attribute), qint8(characteristic), costIter->cost, costIter->dynamic));
+    }
+    record.costs = costs;
+}
+
+/* Writer */
+
+CardSetWriter::CardSetWriter()
+{
+}
+
+void CardSetWriter::addCard(const CardRecord &record)
+{
+    m_records.append(record);
+}
+
+void CardSetWriter::addCards(const QVector<CardRecord> &records)
+{
+    m_records += records;
+}
+
+void CardSetWriter::reset()
+{
+    m_languages.clear();
+    m_stringIds.clear();
+    m_strings.clear();
+    m_textIds.clear();
+    m_texts.clear();
+}
+
+quint32 CardSetWriter::stringId(const QString &string)
+{
+    QHash<QString, quint32>::const_iterator it = m_stringIds.constFind(string);
+    if (it != m_stringIds.constEnd()) {
+        return it.value();
+    }
+    quint32 id = quint32(m_strings.size());
+    m_strings.append(string.toUtf8());
+    m_stringIds.insert(string, id);
+    return id;
+}
+
+quint32 CardSetWriter::textId(const FLanguageString &text)
+{
+    QVector<quint32> row(m_languages.size(), CARDSET_NO_ID);
+    bool empty = true;
+    for (int i = 0; i < m_languages.size(); ++i) {
+        const QString value = text.text(m_languages.at(i));
+        if (!value.isEmpty()) {
+            row[i] = stringId(value);
+            empty = false;
+        }
+    }
+    if (empty) {
+        return CARDSET_NO_ID;
+    }
+
+    QHash<QVector<quint32>, quint32>::const_iterator it = m_textIds.constFind(row);
+    if (it != m_textIds.constEnd()) {
+        return it.value();
+    }
+    quint32 id = quint32(m_texts.size());
+    m_texts.append(row);
+    m_textIds.insert(row, id);
+    return id;
+}
+
+QVector<quint32> CardSetWriter::domainStringIds(int domain)
+{
+    QVector<quint32> ids;
+    if (domain == CardSetFile::LanguageDomain) {
+        QStringList::const_iterator it = m_languages.constBegin();
+        for (; it != m_languages.constEnd(); ++it) {
+            ids.append(stringId(*it));
+        }
+        return ids;
+    }
+
+    // Model ids are indices into dataVec()
+    const FAbstractYAMLModel *model = domainModel(domain);
+    if (model) {
+        QVector<FAbstractObject*>::const_iterator it = model->dataVec()->constBegin();
+        for (; it != model->dataVec()->constEnd(); ++it) {
+            ids.append(stringId(domainStringId(domain, *it)));
+        }
+    }
+    return ids;
+}
+
+bool CardSetWriter::write(const QString &filename)
+{
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_errorString = file.errorString();
+        return false;
+    }
+    if (!write(&file)) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        m_errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Writes the set to an open \a device, models are read here so this has to
+ * run on the thread owning them.
+ */
+bool CardSetWriter::write(QIODevice *device)
+{
+    reset();
+
+    // Text columns follow the language model, extra languages found in the cards are appended
+    const FLanguageModel *languageModel = FLanguageModel::Instance();
+    if (languageModel) {
+        QVector<FAbstractObject*>::const_iterator it = languageModel->dataVec()->constBegin();
+        for (; it != languageModel->dataVec()->constEnd(); ++it) {
+            m_languages.append(static_cast<const FLanguage*>(*it)->countryCode());
+        }
+    }
+    QVector<CardRecord>::const_iterator recordIter = m_records.constBegin();
+    for (; recordIter != m_records.constEnd(); ++recordIter) {
+        QVector<const FLanguageString*> texts;
+        texts << &recordIter->cardName << &recordIter->flavorText;
+        for (int i = 0; i < recordIter->traits.size(); ++i) texts << &recordIter->traits.at(i);
+        for (int i = 0; i < recordIter->abilities.size(); ++i) texts << &recordIter->abilities.at(i);
+
+        QVector<const FLanguageString*>::const_iterator textIter = texts.constBegin();
+        for (; textIter != texts.constEnd(); ++textIter) {
+            QHash<QString, QString>::const_iterator langIter = (*textIter)->data()->constBegin();
+            for (; langIter != (*textIter)->data()->constEnd(); ++langIter) {
+                if (!langIter.value().isEmpty() && !m_languages.contains(langIter.key())) {
+                    m_languages.append(langIter.key());
+                }
+            }
+        }
+    }
+
+    if (m_languages.size() > 0xFFFF) {
+        m_errorString = QObject::tr("Too many languages in card set.");
+        return false;
+    }
+
+    // Records and pool
+    QByteArray records;
+    QByteArray pool;
+    records.reserve(m_records.size() * CARDSET_RECORD_SIZE);
+    QDataStream recordStream(&records, QIODevice::WriteOnly);
+    QDataStream poolStream(&pool, QIODevice::WriteOnly);
+    recordStream.setByteOrder(QDataStream::LittleEndian);
+    poolStream.setByteOrder(QDataStream::LittleEndian);
+    const char padding[CARDSET_RECORD_SIZE] = {};
+
+    for (recordIter = m_records.constBegin(); recordIter != m_records.constEnd(); ++recordIter) {
+        const CardRecord &record = *recordIter;
+        if (record.costs.size() > 0xFFFF || record.traits.size() > 0xFFFF || record.abilities.size() > 0xFFFF) {
+            m_errorString = QObject::tr("Card %1 has too many entries to be stored.").arg(int(recordIter - m_records.constBegin()));
+            return false;
+        }
+
+        quint32 poolOffset = quint32(poolStream.device()->pos());
+        QVector<CardRecordCost>::const_iterator costIter = record.costs.constBegin();
+        for (; costIter != record.costs.constEnd(); ++costIter) {
+            poolStream << costIter->attribute << costIter->characteristic << costIter->cost << quint8(costIter->dynamic ? 1 : 0);
+        }
+        for (int i = 0; i < record.traits.size(); ++i) {
+            poolStream << textId(record.traits.at(i));
+        }
+        for (int i = 0; i < record.abilities.size(); ++i) {
+            poolStream << textId(record.abilities.at(i));
+        }
+
+        qint64 start = recordStream.device()->pos();
+        for (int i = 0; i < CARDSET_MAX_CARD_TYPES; ++i) {
+            recordStream << qint16(i < MAX_CARD_TYPES ? record.cardTypes[i] : -1);
+        }
+        for (int i = 0; i < CARDSET_MAX_CARD_TYPES; ++i) {
+            recordStream << qint16(i < MAX_CARD_TYPES ? record.generalCardTypes[i] : -1);
+        }
+        for (int i = 0; i < CARDSET_MAX_ATTRIBUTES; ++i) {
+            recordStream << qint8(i < record.attributeCount ? record.attributes[i] : -1);
+        }
+        recordStream << record.attributeCount << record.showFlags << record.side << quint8(0);
+        recordStream << record.rarity << quint16(0);
+        recordStream << textId(record.cardName) << textId(record.flavorText);
+        recordStream << poolOffset << quint16(record.costs.size()) << quint16(record.traits.size()) << quint16(record.abilities.size()) << quint16(0);
+        recordStream.writeRawData(padding, int(CARDSET_RECORD_SIZE - (recordStream.device()->pos() - start)));
+    }
+
+    // Id tables, these may still add strings
+    QByteArray idTables;
+    QDataStream idStream(&idTables, QIODevice::WriteOnly);
+    idStream.setByteOrder(QDataStream::LittleEndian);
+    for (int domain = 0; domain < CardSetFile::DomainCount; ++domain) {
+        QVector<quint32> ids = domainStringIds(domain);
+        idStream << quint32(ids.size());
+        QVector<quint32>::const_iterator it = ids.constBegin();
+        for (; it != ids.constEnd(); ++it) {
+            idStream << *it;
+        }
+    }
+
+    quint64 idTableOffset = CARDSET_HEADER_SIZE;
+    quint64 indexOffset = idTableOffset + quint64(idTables.size());
+    quint64 recordsOffset = indexOffset + quint64(m_records.size()) * 8;
+    quint64 poolOffset = recordsOffset + quint64(records.size());
+    quint64 textTableOffset = poolOffset + quint64(pool.size());
+    quint64 stringIndexOffset = textTableOffset + quint64(m_texts.size()) * quint64(m_languages.size()) * 4;
+
+    QDataStream out(device);
+    out.setByteOrder(QDataStream::LittleEndian);
+
+    out << quint32(CARDSET_MAGIC) << quint16(CARDSET_VERSION) << quint16(m_languages.size());
+    out << quint32(m_records.size()) << quint32(CARDSET_RECORD_SIZE);
+    out << idTableOffset << indexOffset << poolOffset << textTableOffset;
+    out << quint32(m_texts.size()) << quint32(m_strings.size()) << stringIndexOffset;
+
+    out.writeRawData(idTables.constData(), idTables.size());
+    for (int i = 0; i < m_records.size(); ++i) {
+        out << quint64(recordsOffset + quint64(i) * CARDSET_RECORD_SIZE);
+    }
+    out.writeRawData(records.constData(), records.size());
+    out.writeRawData(pool.constData(), pool.size());
+
+    QVector<QVector<quint32>>::const_iterator textIter = m_texts.constBegin();
+    for (; textIter != m_texts.constEnd(); ++textIter) {
+        QVector<quint32>::const_iterator it = textIter->constBegin();
+        for (; it != textIter->constEnd(); ++it) {
+            out << *it;
+        }
+    }
+
+    quint32 stringOffset = 0;
+    QVector<QByteArray>::const_iterator stringIter = m_strings.constBegin();
+    for (; stringIter != m_strings.constEnd(); ++stringIter) {
+        out << stringOffset << quint32(stringIter->size());
+        stringOffset += quint32(stringIter->size());
+    }
+    for (stringIter = m_strings.constBegin(); stringIter != m_strings.constEnd(); ++stringIter) {
+        out.writeRawData(stringIter->constData(), stringIter->size());
+    }
+
+    if (out.status() != QDataStream::Ok) {
+        m_errorString = device->errorString();
+        return false;
+    }
+    return true;
+}
+
+/* Reader */
+
+CardSetReader::CardSetReader()
+    : m_data(nullptr), m_size(0), m_mapped(false), m_cardCount(0), m_recordSize(0), m_textCount(0), m_stringCount(0),
+      m_indexOffset(0), m_poolOffset(0), m_textTableOffset(0), m_stringIndexOffset(0), m_stringDataOffset(0)
+{
+}
+
+CardSetReader::~CardSetReader()
+{
+    close();
+}
+
+bool CardSetReader::open(const QString &filename)
+{
+    close();
+
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    m_size = m_file.size();
+
+    uchar *mapped = m_file.map(0, m_size);
+    if (mapped) {
+        m_data = mapped;
+        m_mapped = true;
+    } else {
+        m_buffer = m_file.readAll();
+        m_data = reinterpret_cast<const uchar*>(m_buffer.constData());
+        m_mapped = false;
+    }
+
+    if (!readHeader()) {
+        QString error = m_errorString;
+        close();
+        m_errorString = error;
+        return false;
+    }
+    return true;
+}
+
+void CardSetReader::close()
+{
+    if (m_mapped && m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+    m_file.close();
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_errorString.clear();
+
+    m_cardCount = 0;
+    m_recordSize = 0;
+    m_textCount = 0;
+    m_stringCount = 0;
+    m_languages.clear();
+    for (int domain = 0; domain < CardSetFile::DomainCount; ++domain) {
+        m_idMap[domain].clear();
+    }
+}
+
+bool CardSetReader::readHeader()
+{
+    if (!inRange(0, CARDSET_HEADER_SIZE) || qFromLittleEndian<quint32>(m_data) != CARDSET_MAGIC) {
+        m_errorString = QObject::tr("'%1' is not a card set file.").arg(m_file.fileName());
+        return false;
+    }
+    quint16 version = qFromLittleEndian<quint16>(m_data + 4);
+    if (version != CARDSET_VERSION) {
+        m_errorString = QObject::tr("Unsupported card set version %1.").arg(version);
+        return false;
+    }
+    quint16 languageCount = qFromLittleEndian<quint16>(m_data + 6);
+    m_cardCount = qFromLittleEndian<quint32>(m_data + 8);
+    m_recordSize = qFromLittleEndian<quint32>(m_data + 12);
+    quint64 idTableOffset = qFromLittleEndian<quint64>(m_data + 16);
+    m_indexOffset = qFromLittleEndian<quint64>(m_data + 24);
+    m_poolOffset = qFromLittleEndian<quint64>(m_data + 32);
+    m_textTableOffset = qFromLittleEndian<quint64>(m_data + 40);
+    m_textCount = qFromLittleEndian<quint32>(m_data + 48);
+    m_stringCount = qFromLittleEndian<quint32>(m_data + 52);
+    m_stringIndexOffset = qFromLittleEndian<quint64>(m_data + 56);
+    m_stringDataOffset = m_stringIndexOffset + quint64(m_stringCount) * 8;
+
+    if (m_recordSize < CARDSET_RECORD_SIZE
+            || !inRange(m_indexOffset, quint64(m_cardCount) * 8)
+            || !inRange(m_textTableOffset, quint64(m_textCount) * languageCount * 4)
+            || !inRange(m_stringIndexOffset, quint64(m_stringCount) * 8)) {
+        m_errorString = QObject::tr("Card set file '%1' is truncated or corrupt.").arg(m_file.fileName());
+        return false;
+    }
+
+    if (!readIdTables(idTableOffset)) {
+        m_errorString = QObject::tr("Card set file '%1' has invalid id tables.").arg(m_file.fileName());
+        return false;
+    }
+    if (m_languages.size() != languageCount) {
+        m_errorString = QObject::tr("Card set file '%1' has an invalid language table.").arg(m_file.fileName());
+        return false;
+    }
+    return true;
+}
+
+bool CardSetReader::readIdTables(quint64 offset)
+{
+    for (int domain = 0; domain < CardSetFile::DomainCount; ++domain) {
+        if (!inRange(offset, 4)) return false;
+        quint32 count = qFromLittleEndian<quint32>(m_data + offset);
+        offset += 4;
+        if (!inRange(offset, quint64(count) * 4)) return false;
+
+        const FAbstractYAMLModel *model = domainModel(domain);
+        for (quint32 i = 0; i < count; ++i, offset += 4) {
+            const QString stringId = string(qFromLittleEndian<quint32>(m_data + offset));
+            if (domain == CardSetFile::LanguageDomain) {
+                m_languages.append(stringId);
+                continue;
+            }
+            if (!model) continue;
+
+            const FAbstractObject *object = model->data()->value(stringId, nullptr);
+            if (!object) {
+                qWarning(qUtf8Printable(QObject::tr("Card set references unknown entry '%1', it will be ignored.").arg(stringId)));
+            }
+            m_idMap[domain].append(object ? object->id() : -1);
+        }
+    }
+    return true;
+}
+
+qint64 CardSetReader::recordOffset(int index) const
+{
+    if (!isOpen() || index < 0 || quint32(index) >= m_cardCount) {
+        return -1;
+    }
+    quint64 offset = qFromLittleEndian<quint64>(m_data + m_indexOffset + quint64(index) * 8);
+    if (!inRange(offset, m_recordSize)) {
+        return -1;
+    }
+    return qint64(offset);
+}
+
+int CardSetReader::mapId(int domain, int fileId) const
+{
+    if (fileId < 0) return -1;
+    // No table means the file was written without models, ids are taken as they are
+    if (m_idMap[domain].isEmpty()) return fileId;
+    return fileId < m_idMap[domain].size() ? m_idMap[domain].at(fileId) : -1;
+}
+
+const QString CardSetReader::string(quint32 id) const
+{
+    if (!isOpen() || id >= m_stringCount) {
+        return QString();
+    }
+    const uchar *entry = m_data + m_stringIndexOffset + quint64(id) * 8;
+    quint64 offset = m_stringDataOffset + qFromLittleEndian<quint32>(entry);
+    quint32 size = qFromLittleEndian<quint32>(entry + 4);
+    if (!inRange(offset, size)) {
+        return QString();
+    }
+    return QString::fromUtf8(reinterpret_cast<const char*>(m_data + offset), int(size));
+}
+
+const FLanguageString CardSetReader::text(quint32 id) const
+{
+    FLanguageString text(FLanguageModel::Instance());
+    if (id == CARDSET_NO_ID || id >= m_textCount) {
+        return text;
+    }
+    const uchar *row = m_data + m_textTableOffset + quint64(id) * quint64(m_languages.size()) * 4;
+    for (int i = 0; i < m_languages.size(); ++i) {
+        quint32 stringId = qFromLittleEndian<quint32>(row + i * 4);
+        if (stringId != CARDSET_NO_ID) {
+            text.setText(m_languages.at(i), string(stringId));
+        }
+    }
+    return text;
+}
+
+const FLanguageString CardSetReader::cardName(int index) const
+{
+    qint64 offset = recordOffset(index);
+    if (offset < 0) {
+        return FLanguageString(FLanguageModel::Instance());
+    }
+    return text(qFromLittleEndian<quint32>(m_data + offset + 24));
+}
+
+CardRecord CardSetReader::card(int index) const
+{
+    CardRecord record;
+    qint64 offset = recordOffset(index);
+    if (offset < 0) {
+        qWarning(qUtf8Printable(QObject::tr("Card index %1 is out of range.").arg(index)));
+        return record;
+    }
+    const uchar *p = m_data + offset;
+
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        record.cardTypes[i] = qint16(mapId(CardSetFile::CardTypeDomain, qFromLittleEndian<qint16>(p + i * 2)));
+        record.generalCardTypes[i] = qint16(mapId(CardSetFile::GeneralCardTypeDomain, qFromLittleEndian<qint16>(p + 4 + i * 2)));
+    }
+
+    int attributeCount = qMin(int(p[16]), CARDSET_MAX_ATTRIBUTES);
+    for (int i = 0; i < attributeCount; ++i) {
+        int id = mapId(CardSetFile::AttributeDomain, qint8(p[8 + i]));
+        if (id >= 0) record.addAttribute(id);
+    }
+    record.showFlags = p[17];
+    record.side = p[18];
+    record.rarity = qint16(qMax(0, mapId(CardSetFile::RarityDomain, qFromLittleEndian<qint16>(p + 20))));
+    record.cardName = text(qFromLittleEndian<quint32>(p + 24));
+    record.flavorText = text(qFromLittleEndian<quint32>(p + 28));
+
+    quint64 pool = m_poolOffset + qFromLittleEndian<quint32>(p + 32);
+    quint16 costCount = qFromLittleEndian<quint16>(p + 36);
+    quint16 traitCount = qFromLittleEndian<quint16>(p + 38);
+    quint16 abilityCount = qFromLittleEndian<quint16>(p + 40);
+    if (!inRange(pool, quint64(costCount) * CARDSET_COST_SIZE + (quint64(traitCount) + abilityCount) * 4)) {
+        qWarning(qUtf8Printable(QObject::tr("Card %1 in '%2' is corrupt.").arg(index).arg(m_file.fileName())));
+        return record;
+    }
+
+    const uchar *q = m_data + pool;
+    record.costs.reserve(costCount);
+    for (int i = 0; i < costCount; ++i, q += CARDSET_COST_SIZE) {
+        int attribute = mapId(CardSetFile::AttributeDomain, qint8(q[0]));
+        int characteristic = qint8(q[1]) < 0 ? -1 : mapId(CardSetFile::CharacteristicDomain, qint8(q[1]));
+        if (attribute < 0 || (qint8(q[1]) >= 0 && characteristic < 0)) continue;
+        record.costs.append(CardRecordCost(qint8(attribute), qint8(characteristic), qint8(q[2]), q[3] != 0));
+    }
+    record.traits.reserve(traitCount);
+    for (int i = 0; i < traitCount; ++i, q += 4) {
+        record.traits.append(text(qFromLittleEndian<quint32>(q)));
+    }
+    record.abilities.reserve(abilityCount);
+    for (int i = 0; i < abilityCount; ++i, q += 4) {
+        record.abilities.append(text(qFromLittleEndian<quint32>(q)));
+    }
+    return record;
+}
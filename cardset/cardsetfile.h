@@ -0,0 +1,138 @@
+#ifndef CARDSETFILE_H
+#define CARDSETFILE_H
+
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+#include "cardrecord.h"
+
+/*
+ * Card set file layout, all integers little endian:
+ *
+ *   Header         CARDSET_HEADER_SIZE bytes
+ *   Id tables      string ids of languages and model entities, per domain
+ *   Card index     cardCount x quint64 absolute record offsets
+ *   Records        cardCount x CARDSET_RECORD_SIZE bytes
+ *   Pool           costs and trait/ability text ids referenced by records
+ *   Text table     textCount x languageCount x quint32 string ids
+ *   String index   stringCount x (quint32 offset, quint32 size)
+ *   String data    deduplicated UTF-8 strings
+ *
+ * Records store model ids as they were when the file was written. The id
+ * tables map those back to string ids, so a reader can remap them to the
+ * currently loaded models.
+ */
+
+#define CARDSET_MAGIC 0x53574F46 // "FOWS"
+#define CARDSET_VERSION 1
+#define CARDSET_HEADER_SIZE 64
+#define CARDSET_RECORD_SIZE 64
+#define CARDSET_COST_SIZE 4
+#define CARDSET_NO_ID 0xFFFFFFFFu
+
+#define CARDSET_MAX_CARD_TYPES 2
+#define CARDSET_MAX_ATTRIBUTES 8
+
+class CardSetFile
+{
+public:
+    enum IdDomain {
+        LanguageDomain = 0,
+        AttributeDomain,
+        CharacteristicDomain,
+        CardTypeDomain,
+        GeneralCardTypeDomain,
+        RarityDomain,
+        DomainCount
+    };
+
+    // Between the ids of the currently loaded models and their string ids
+    static const QString stringId(int domain, int id); // Empty for unknown ids
+    static int id(int domain, const QString &stringId); // -1 for unknown string ids
+
+    // String ids of the loaded models by id and domain, taken before the data
+    // files are reloaded to move records held in memory to the new ids
+    typedef QVector<QStringList> IdTable;
+    static const IdTable idTable();
+    static void remap(CardRecord &record, const IdTable &before);
+};
+
+class CardSetWriter
+{
+public:
+    CardSetWriter();
+
+    void addCard(const CardRecord &record);
+    void addCards(const QVector<CardRecord> &records);
+    int cardCount() const { return m_records.size(); }
+
+    bool write(const QString &filename);
+    bool write(QIODevice *device);
+    const QString errorString() const { return m_errorString; }
+
+private:
+    QVector<CardRecord> m_records;
+    QString m_errorString;
+
+    QStringList m_languages;
+    QHash<QString, quint32> m_stringIds;
+    QVector<QByteArray> m_strings;
+    QHash<QVector<quint32>, quint32> m_textIds;
+    QVector<QVector<quint32>> m_texts;
+
+    void reset();
+    quint32 stringId(const QString &string);
+    quint32 textId(const FLanguageString &text);
+    QVector<quint32> domainStringIds(int domain);
+};
+
+class CardSetReader
+{
+public:
+    CardSetReader();
+    ~CardSetReader();
+
+    bool open(const QString &filename);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    bool isMapped() const { return m_mapped; }
+    const QString errorString() const { return m_errorString; }
+
+    int cardCount() const { return int(m_cardCount); }
+    const QStringList languages() const { return m_languages; }
+
+    CardRecord card(int index) const;
+    const FLanguageString cardName(int index) const;
+    const QString string(quint32 id) const;
+
+private:
+    QFile m_file;
+    QByteArray m_buffer; // Used when the file could not be mapped
+    const uchar *m_data;
+    qint64 m_size;
+    bool m_mapped;
+    QString m_errorString;
+
+    quint32 m_cardCount;
+    quint32 m_recordSize;
+    quint32 m_textCount;
+    quint32 m_stringCount;
+    quint64 m_indexOffset;
+    quint64 m_poolOffset;
+    quint64 m_textTableOffset;
+    quint64 m_stringIndexOffset;
+    quint64 m_stringDataOffset;
+
+    QStringList m_languages;
+    QVector<int> m_idMap[CardSetFile::DomainCount];
+
+    bool inRange(quint64 offset, quint64 size) const { return offset <= quint64(m_size) && size <= quint64(m_size) - offset; }
+    bool readHeader();
+    bool readIdTables(quint64 offset);
+    qint64 recordOffset(int index) const;
+    int mapId(int domain, int fileId) const;
+    const FLanguageString text(quint32 id) const;
+};
+
+#endif // CARDSETFILE_H
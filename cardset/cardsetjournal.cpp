@@ -0,0 +1,708 @@
+#include <QBuffer>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include "cardsetjournal.h"
+#include "cardsetfile.h"
+#include "card.h"
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static bool syncFile(QFile &file)
+{
+    if (!file.flush()) return false;
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+static bool writeJournalHeader(QFile &file)
+{
+    QByteArray header;
+    QDataStream out(&header, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << quint32(CARDSET_JOURNAL_MAGIC) << quint16(CARDSET_JOURNAL_VERSION) << quint16(0) << quint64(0);
+    return file.write(header) == header.size();
+}
+
+/* Entry */
+
+void CardJournalEntry::applyTo(QVector<CardRecord> &records) const
+{
+    if (operation == SetCardCount) {
+        records.resize(int(card));
+        return;
+    }
+    if (int(card) >= records.size()) {
+        records.resize(int(card) + 1);
+    }
+    CardRecord &target = records[int(card)];
+
+    switch (operation) {
+    case PutCard:
+        target = record;
+        break;
+    case SetRarity:
+        target.rarity = record.rarity;
+        break;
+    case SetCardTypes:
+        for (int i = 0; i < MAX_CARD_TYPES; ++i) target.cardTypes[i] = record.cardTypes[i];
+        break;
+    case SetGeneralCardTypes:
+        for (int i = 0; i < MAX_CARD_TYPES; ++i) target.generalCardTypes[i] = record.generalCardTypes[i];
+        break;
+    case SetAttributes:
+        for (int i = 0; i < MAX_CARD_ATTRIBUTES; ++i) target.attributes[i] = record.attributes[i];
+        target.attributeCount = record.attributeCount;
+        break;
+    case SetShowFlags:
+        target.showFlags = record.showFlags;
+        break;
+    case SetCosts:
+        target.costs = record.costs;
+        break;
+    case SetCardName:
+        target.cardName = record.cardName;
+        break;
+    case SetFlavorText:
+        target.flavorText = record.flavorText;
+        break;
+    case SetTraits:
+        target.traits = record.traits;
+        break;
+    case SetAbilities:
+        target.abilities = record.abilities;
+        break;
+    case SetCardCount:
+        break;
+    }
+}
+
+// Model ids change when the data files are reloaded, entries store the string ids like the set file does
+static void writeId(QDataStream &out, int domain, int id)
+{
+    out << CardSetFile::stringId(domain, id);
+}
+
+static int readId(QDataStream &in, int domain)
+{
+    QString stringId;
+    in >> stringId;
+    return CardSetFile::id(domain, stringId);
+}
+
+static void writeCardTypes(QDataStream &out, const qint16 *types, int domain)
+{
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) writeId(out, domain, types[i]);
+}
+
+static void readCardTypes(QDataStream &in, qint16 *types, int domain)
+{
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) types[i] = qint16(readId(in, domain));
+}
+
+static void writeAttributes(QDataStream &out, const CardRecord &record)
+{
+    out << record.attributeCount;
+    for (int i = 0; i < record.attributeCount; ++i) writeId(out, CardSetFile::AttributeDomain, record.attributes[i]);
+}
+
+static void readAttributes(QDataStream &in, CardRecord &record)
+{
+    quint8 count = 0;
+    in >> count;
+    for (int i = 0; i < count; ++i) {
+        const int attribute = readId(in, CardSetFile::AttributeDomain);
+        if (attribute >= 0) record.addAttribute(attribute);
+    }
+}
+
+static void writeCosts(QDataStream &out, const CardRecord &record)
+{
+    out << quint32(record.costs.size());
+    for (int i = 0; i < record.costs.size(); ++i) {
+        const CardRecordCost &cost = record.costs.at(i);
+        writeId(out, CardSetFile::AttributeDomain, cost.attribute);
+        writeId(out, CardSetFile::CharacteristicDomain, cost.characteristic);
+        out << cost.cost << cost.dynamic;
+    }
+}
+
+static void readCosts(QDataStream &in, CardRecord &record)
+{
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        QString characteristicId;
+        CardRecordCost cost;
+        const int attribute = readId(in, CardSetFile::AttributeDomain);
+        in >> characteristicId >> cost.cost >> cost.dynamic;
+        const int characteristic = CardSetFile::id(CardSetFile::CharacteristicDomain, characteristicId);
+        // Entries of attributes or characteristics that are gone are dropped, as the set reader does
+        if (attribute < 0 || (!characteristicId.isEmpty() && characteristic < 0)) continue;
+        cost.attribute = qint8(attribute);
+        cost.characteristic = qint8(characteristic);
+        record.costs.append(cost);
+    }
+}
+
+QByteArray CardJournalEntry::serialize() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_9);
+    out << card << quint8(operation);
+
+    switch (operation) {
+    case PutCard:
+        writeCardTypes(out, record.cardTypes, CardSetFile::CardTypeDomain);
+        writeCardTypes(out, record.generalCardTypes, CardSetFile::GeneralCardTypeDomain);
+        writeAttributes(out, record);
+        out << record.showFlags << record.side;
+        writeId(out, CardSetFile::RarityDomain, record.rarity);
+        writeCosts(out, record);
+        out << record.cardName << record.flavorText << record.traits << record.abilities;
+        break;
+    case SetRarity:
+        writeId(out, CardSetFile::RarityDomain, record.rarity);
+        break;
+    case SetCardTypes:
+        writeCardTypes(out, record.cardTypes, CardSetFile::CardTypeDomain);
+        break;
+    case SetGeneralCardTypes:
+        writeCardTypes(out, record.generalCardTypes, CardSetFile::GeneralCardTypeDomain);
+        break;
+    case SetAttributes:
+        writeAttributes(out, record);
+        break;
+    case SetShowFlags:
+        out << record.showFlags;
+        break;
+    case SetCosts:
+        writeCosts(out, record);
+        break;
+    case SetCardName:
+        out << record.cardName;
+        break;
+    case SetFlavorText:
+        out << record.flavorText;
+        break;
+    case SetTraits:
+        out << record.traits;
+        break;
+    case SetAbilities:
+        out << record.abilities;
+        break;
+    case SetCardCount:
+        break;
+    }
+    return data;
+}
+
+bool CardJournalEntry::deserialize(const QByteArray &data, CardJournalEntry &entry)
+{
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_9);
+    quint8 operation = 0;
+    in >> entry.card >> operation;
+    if (operation < PutCard || operation > SetAbilities) {
+        return false;
+    }
+    entry.operation = Operation(operation);
+    entry.record = CardRecord();
+    CardRecord &record = entry.record;
+
+    switch (entry.operation) {
+    case PutCard:
+        readCardTypes(in, record.cardTypes, CardSetFile::CardTypeDomain);
+        readCardTypes(in, record.generalCardTypes, CardSetFile::GeneralCardTypeDomain);
+        readAttributes(in, record);
+        in >> record.showFlags >> record.side;
+        record.rarity = qint16(qMax(0, readId(in, CardSetFile::RarityDomain)));
+        readCosts(in, record);
+        in >> record.cardName >> record.flavorText >> record.traits >> record.abilities;
+        break;
+    case SetRarity:
+        record.rarity = qint16(qMax(0, readId(in, CardSetFile::RarityDomain)));
+        break;
+    case SetCardTypes:
+        readCardTypes(in, record.cardTypes, CardSetFile::CardTypeDomain);
+        break;
+    case SetGeneralCardTypes:
+        readCardTypes(in, record.generalCardTypes, CardSetFile::GeneralCardTypeDomain);
+        break;
+    case SetAttributes:
+        readAttributes(in, record);
+        break;
+    case SetShowFlags:
+        in >> record.showFlags;
+        break;
+    case SetCosts:
+        readCosts(in, record);
+        break;
+    case SetCardName:
+        in >> record.cardName;
+        break;
+    case SetFlavorText:
+        in >> record.flavorText;
+        break;
+    case SetTraits:
+        in >> record.traits;
+        break;
+    case SetAbilities:
+        in >> record.abilities;
+        break;
+    case SetCardCount:
+        break;
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+/*!
+ * \brief Reads the intact entries of a journal. Without \a entries frames are only
+ * checked against their checksums, which needs no models and is safe on any thread.
+ */
+static bool readJournal(const QString &journalFilename, QVector<CardJournalEntry> *entries, qint64 *validSize)
+{
+    QFile file(journalFilename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    // Journals are compacted regularly, reading them at once is fine
+    const QByteArray data = file.readAll();
+    const uchar *raw = reinterpret_cast<const uchar*>(data.constData());
+    if (data.size() < CARDSET_JOURNAL_HEADER_SIZE
+            || qFromLittleEndian<quint32>(raw) != CARDSET_JOURNAL_MAGIC
+            || qFromLittleEndian<quint16>(raw + 4) != CARDSET_JOURNAL_VERSION) {
+        return false;
+    }
+
+    qint64 pos = CARDSET_JOURNAL_HEADER_SIZE;
+    while (pos + CARDSET_JOURNAL_FRAME_SIZE <= data.size()) {
+        quint32 size = qFromLittleEndian<quint32>(raw + pos);
+        quint16 checksum = qFromLittleEndian<quint16>(raw + pos + 4);
+        if (pos + CARDSET_JOURNAL_FRAME_SIZE + size > quint64(data.size())) break;
+
+        const char *payload = data.constData() + pos + CARDSET_JOURNAL_FRAME_SIZE;
+        if (qChecksum(payload, size) != checksum) break;
+
+        if (entries) {
+            CardJournalEntry entry;
+            if (!CardJournalEntry::deserialize(QByteArray::fromRawData(payload, int(size)), entry)) break;
+            entries->append(entry);
+        }
+        pos += CARDSET_JOURNAL_FRAME_SIZE + size;
+    }
+    if (validSize) {
+        *validSize = pos;
+    }
+    return true;
+}
+
+/* Writer thread */
+
+CardJournalWriter::CardJournalWriter(const QString &setFilename, const QString &journalFilename, bool recover, QObject *parent)
+    : QThread(parent), m_setFilename(setFilename), m_journalFilename(journalFilename), m_recover(recover), m_enqueued(0), m_synced(0),
+      m_flushWaiters(0), m_compactRequested(false), m_compacting(false), m_stopRequested(false), m_syncInterval(200), m_journalSize(0)
+{
+}
+
+void CardJournalWriter::enqueue(const QByteArray &frame)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pending.append(frame);
+    m_enqueued++;
+    m_wakeup.wakeAll();
+}
+
+/*!
+ * \brief Replaces the set file with \a set and empties the journal, after the
+ * entries enqueued so far are written. The writer never touches the models, so
+ * the set has to be built by the caller.
+ */
+void CardJournalWriter::requestCompaction(const QByteArray &set)
+{
+    QMutexLocker locker(&m_mutex);
+    m_compactedSet = set;
+    m_compactRequested = true;
+    m_wakeup.wakeAll();
+}
+
+void CardJournalWriter::waitForWritten()
+{
+    QMutexLocker locker(&m_mutex);
+    quint64 target = m_enqueued;
+    m_flushWaiters++;
+    m_wakeup.wakeAll();
+    while ((m_synced < target || m_compactRequested || m_compacting) && isRunning()) {
+        m_written.wait(&m_mutex, 100);
+    }
+    m_flushWaiters--;
+}
+
+void CardJournalWriter::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stopRequested = true;
+    m_wakeup.wakeAll();
+}
+
+void CardJournalWriter::setSyncInterval(int msecs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_syncInterval = msecs;
+}
+
+qint64 CardJournalWriter::journalSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_journalSize;
+}
+
+void CardJournalWriter::run()
+{
+    QFile journal(m_journalFilename);
+    if (!journal.open(QIODevice::ReadWrite)) {
+        emit writeFailed(QObject::tr("Could not open journal '%1'. (%2)").arg(m_journalFilename, journal.errorString()));
+        return;
+    }
+
+    // Recover the journal, a torn write at the tail is cut off. Without recovery
+    // the set file was just written in full and older entries must not touch it.
+    qint64 validSize = 0;
+    if (!m_recover || !readJournal(m_journalFilename, nullptr, &validSize)) {
+        journal.resize(0);
+        writeJournalHeader(journal);
+        syncFile(journal);
+        validSize = CARDSET_JOURNAL_HEADER_SIZE;
+    } else if (journal.size() > validSize) {
+        qWarning(qUtf8Printable(QObject::tr("Discarding %1 bytes of incomplete journal entries in '%2'.").arg(journal.size() - validSize).arg(m_journalFilename)));
+        journal.resize(validSize);
+    }
+    journal.seek(validSize);
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_journalSize = validSize;
+    }
+
+    QElapsedTimer sinceSync;
+    sinceSync.start();
+
+    forever {
+        QVector<QByteArray> batch;
+        quint64 batchEnd;
+        QByteArray compactedSet;
+        bool compactNow;
+        bool stopNow;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_pending.isEmpty() && !m_compactRequested && !m_stopRequested) {
+                m_wakeup.wait(&m_mutex);
+            }
+            // Give more edits the chance to share one sync
+            while (!m_stopRequested && !m_compactRequested && m_flushWaiters == 0 && sinceSync.elapsed() < m_syncInterval) {
+                m_wakeup.wait(&m_mutex, ulong(m_syncInterval - sinceSync.elapsed()));
+            }
+            batch.swap(m_pending);
+            batchEnd = m_enqueued;
+            compactNow = m_compactRequested;
+            compactedSet.swap(m_compactedSet);
+            m_compacting = m_compactRequested;
+            m_compactRequested = false;
+            stopNow = m_stopRequested && m_pending.isEmpty();
+        }
+
+        // The set was built from the journal as it was when compaction was requested,
+        // entries of this batch came later and have to stay
+        if (compactNow) {
+            compact(journal, compactedSet);
+        }
+
+        if (!batch.isEmpty()) {
+            QVector<QByteArray>::const_iterator it = batch.constBegin();
+            bool ok = true;
+            for (; it != batch.constEnd(); ++it) {
+                ok &= journal.write(*it) == it->size();
+            }
+            ok &= syncFile(journal);
+            if (!ok) {
+                emit writeFailed(QObject::tr("Could not write journal '%1'. (%2)").arg(m_journalFilename, journal.errorString()));
+            }
+            sinceSync.restart();
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            m_synced = batchEnd;
+            m_compacting = false;
+            m_journalSize = journal.size();
+            m_written.wakeAll();
+        }
+
+        if (stopNow) break;
+    }
+}
+
+bool CardJournalWriter::compact(QFile &journal, const QByteArray &set)
+{
+    QSaveFile file(m_setFilename);
+    if (!file.open(QIODevice::WriteOnly) || file.write(set) != set.size() || !file.commit()) {
+        emit writeFailed(QObject::tr("Could not write card set '%1'. (%2)").arg(m_setFilename, file.errorString()));
+        return false;
+    }
+
+    // Everything is in the set file now
+    journal.resize(CARDSET_JOURNAL_HEADER_SIZE);
+    journal.seek(CARDSET_JOURNAL_HEADER_SIZE);
+    syncFile(journal);
+    emit compacted();
+    return true;
+}
+
+/* Journal */
+
+CardSetJournal::CardSetJournal(QObject *parent)
+    : QObject(parent), m_writer(nullptr), m_sequence(0), m_syncInterval(200)
+{
+    QObject::connect(&m_compactionTimer, &QTimer::timeout, this, &CardSetJournal::compact);
+}
+
+CardSetJournal::~CardSetJournal()
+{
+    close();
+}
+
+bool CardSetJournal::readEntries(const QString &journalFilename, QVector<CardJournalEntry> &entries, qint64 *validSize)
+{
+    return readJournal(journalFilename, &entries, validSize);
+}
+
+bool CardSetJournal::replay(const QString &journalFilename, QVector<CardRecord> &records)
+{
+    QVector<CardJournalEntry> entries;
+    if (!readEntries(journalFilename, entries)) {
+        return false;
+    }
+    QVector<CardJournalEntry>::const_iterator it = entries.constBegin();
+    for (; it != entries.constEnd(); ++it) {
+        it->applyTo(records);
+    }
+    return true;
+}
+
+/*!
+ * \brief Starts journaling edits of a set.
+ *
+ * Right after the set was saved in full the journal starts empty. Only with
+ * \a recover entries left behind by a previous session are folded into the set.
+ */
+bool CardSetJournal::open(const QString &setFilename, bool recover)
+{
+    close();
+    m_setFilename = setFilename;
+    m_writer = new CardJournalWriter(setFilename, journalFilename(setFilename), recover, this);
+    m_writer->setSyncInterval(m_syncInterval);
+    QObject::connect(m_writer, &CardJournalWriter::compacted, this, &CardSetJournal::compacted);
+    QObject::connect(m_writer, &CardJournalWriter::writeFailed, this, &CardSetJournal::writeFailed);
+    m_writer->start(QThread::LowPriority);
+    // Entries left over from a previous session are folded into the set right away
+    if (recover) {
+        compact();
+    }
+    return true;
+}
+
+void CardSetJournal::close()
+{
+    if (!m_writer) return;
+    m_writer->stop();
+    m_writer->wait();
+    delete m_writer;
+    m_writer = nullptr;
+    m_setFilename.clear();
+}
+
+void CardSetJournal::append(const CardJournalEntry &entry)
+{
+    if (!m_writer) return;
+
+    const QByteArray payload = entry.serialize();
+    QByteArray frame;
+    frame.reserve(CARDSET_JOURNAL_FRAME_SIZE + payload.size());
+    QDataStream out(&frame, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << quint32(payload.size()) << qChecksum(payload.constData(), uint(payload.size())) << quint16(0) << m_sequence++;
+    out.writeRawData(payload.constData(), payload.size());
+
+    m_writer->enqueue(frame);
+}
+
+void CardSetJournal::flush()
+{
+    if (m_writer) m_writer->waitForWritten();
+}
+
+/*!
+ * \brief Folds the journal into the set file.
+ *
+ * The set is rebuilt here and not on the writer thread, because reading and
+ * writing records resolves ids through the models, which only this thread may
+ * touch. The writer just replaces the file and empties the journal.
+ */
+void CardSetJournal::compact()
+{
+    if (!m_writer) return;
+    // The journal file has to hold every entry appended so far
+    m_writer->waitForWritten();
+
+    QVector<CardJournalEntry> entries;
+    if (!readEntries(journalFilename(m_setFilename), entries)) {
+        emit writeFailed(QObject::tr("Could not read journal '%1'.").arg(journalFilename(m_setFilename)));
+        return;
+    }
+    if (entries.isEmpty()) return;
+
+    QVector<CardRecord> records;
+    if (QFile::exists(m_setFilename)) {
+        CardSetReader reader;
+        if (!reader.open(m_setFilename)) {
+            emit writeFailed(reader.errorString());
+            return;
+        }
+        records.reserve(reader.cardCount());
+        for (int i = 0; i < reader.cardCount(); ++i) {
+            records.append(reader.card(i));
+        }
+        // The reader maps the set, it has to be closed before the writer replaces it
+        reader.close();
+    }
+    QVector<CardJournalEntry>::const_iterator it = entries.constBegin();
+    for (; it != entries.constEnd(); ++it) {
+        it->applyTo(records);
+    }
+
+    QByteArray set;
+    QBuffer buffer(&set);
+    buffer.open(QIODevice::WriteOnly);
+    CardSetWriter writer;
+    writer.addCards(records);
+    if (!writer.write(&buffer)) {
+        emit writeFailed(writer.errorString());
+        return;
+    }
+    m_writer->requestCompaction(set);
+}
+
+void CardSetJournal::setSyncInterval(int msecs)
+{
+    m_syncInterval = msecs;
+    if (m_writer) m_writer->setSyncInterval(msecs);
+}
+
+void CardSetJournal::setCompactionInterval(int msecs)
+{
+    if (msecs > 0) {
+        m_compactionTimer.start(msecs);
+    } else {
+        m_compactionTimer.stop();
+    }
+}
+
+qint64 CardSetJournal::journalSize() const
+{
+    return m_writer ? m_writer->journalSize() : 0;
+}
+
+/* Recorder */
+
+CardJournalRecorder::CardJournalRecorder(CardSetJournal *journal, QObject *parent)
+    : QObject(parent), m_journal(journal)
+{
+}
+
+void CardJournalRecorder::watch(Card *card, int index, int side)
+{
+    if (!card || m_indices.contains(card)) return;
+    m_indices.insert(card, qMakePair(index, side));
+    QObject::connect(card, &Card::changed, this, [this, card](Card::Changes changes) { record(card, changes); });
+}
+
+void CardJournalRecorder::unwatch(Card *card)
+{
+    if (!m_indices.remove(card)) return;
+    QObject::disconnect(card, nullptr, this, nullptr);
+}
+
+void CardJournalRecorder::setIndex(Card *card, int index, int side)
+{
+    if (m_indices.contains(card)) {
+        m_indices[card] = qMakePair(index, side);
+    }
+}
+
+void CardJournalRecorder::putCard(Card *card)
+{
+    record(card, Card::AllChanges);
+}
+
+/*!
+ * \brief Inserting or removing a side moves the following records, they are stored
+ * whole. Unlike an insert or remove operation this stays safe to replay twice.
+ */
+void CardJournalRecorder::putRecords(const QVector<CardRecord> &records, int first)
+{
+    if (!m_journal->isOpen()) return;
+    m_journal->append(CardJournalEntry(quint32(records.size()), CardJournalEntry::SetCardCount));
+    for (int i = qMax(0, first); i < records.size(); ++i) {
+        m_journal->append(CardJournalEntry(quint32(i), CardJournalEntry::PutCard, records.at(i)));
+    }
+}
+
+void CardJournalRecorder::record(const Card *card, Card::Changes changes)
+{
+    if (!m_journal->isOpen()) return;
+    const QPair<int, int> position = m_indices.value(card, qMakePair(-1, 0));
+    const int index = position.first;
+    if (index < 0) return;
+
+    static const struct { Card::Changes changes; CardJournalEntry::Operation operation; } operations[] = {
+        { Card::RarityChange, CardJournalEntry::SetRarity },
+        { Card::CardTypeChange, CardJournalEntry::SetCardTypes },
+        { Card::GeneralCardTypeChange, CardJournalEntry::SetGeneralCardTypes },
+        { Card::AttributeChange, CardJournalEntry::SetAttributes },
+        { Card::ShowCostChange | Card::ShowStatsChange | Card::ShowSmallTextBoxChange | Card::ShowBorderChange
+          | Card::ShowTextBoxChange | Card::ShowQuickcastChange, CardJournalEntry::SetShowFlags },
+        { Card::CostChange, CardJournalEntry::SetCosts },
+        { Card::CardNameChange, CardJournalEntry::SetCardName },
+        { Card::FlavorTextChange, CardJournalEntry::SetFlavorText },
+        { Card::TraitChange, CardJournalEntry::SetTraits },
+        { Card::AbilityChange, CardJournalEntry::SetAbilities }
+    };
+    const int operationCount = int(sizeof(operations) / sizeof(operations[0]));
+
+    CardRecord record = CardRecord::fromCard(card);
+    record.side = quint8(position.second);
+
+    QVector<CardJournalEntry::Operation> touched;
+    for (int i = 0; i < operationCount; ++i) {
+        if (changes & operations[i].changes) touched.append(operations[i].operation);
+    }
+    // A transaction touching most of the card is cheaper to store whole
+    if (touched.size() > operationCount / 2) {
+        m_journal->append(CardJournalEntry(quint32(index), CardJournalEntry::PutCard, record));
+        return;
+    }
+    QVector<CardJournalEntry::Operation>::const_iterator it = touched.constBegin();
+    for (; it != touched.constEnd(); ++it) {
+        m_journal->append(CardJournalEntry(quint32(index), *it, record));
+    }
+}
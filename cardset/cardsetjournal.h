@@ -0,0 +1,162 @@
+#ifndef CARDSETJOURNAL_H
+#define CARDSETJOURNAL_H
+
+#include <QObject>
+#include <QFile>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QHash>
+#include <QTimer>
+#include "cardrecord.h"
+#include "card.h"
+
+#define CARDSET_JOURNAL_MAGIC 0x4A574F46 // "FOWJ"
+#define CARDSET_JOURNAL_VERSION 2
+#define CARDSET_JOURNAL_HEADER_SIZE 16
+#define CARDSET_JOURNAL_FRAME_SIZE 16 // size, checksum, reserved, sequence
+
+/*!
+ * \brief One change to a card of a set.
+ *
+ * Every operation replaces a whole field of the card, so replaying an entry
+ * twice gives the same result. This keeps recovery safe when a crash happens
+ * between compaction and truncating the journal. Model entries are stored
+ * by their string ids, so entries stay valid when the data files are reloaded.
+ */
+class CardJournalEntry
+{
+public:
+    enum Operation : quint8 {
+        PutCard = 1,
+        SetCardCount,
+        SetRarity,
+        SetCardTypes,
+        SetGeneralCardTypes,
+        SetAttributes,
+        SetShowFlags,
+        SetCosts,
+        SetCardName,
+        SetFlavorText,
+        SetTraits,
+        SetAbilities
+    };
+
+    CardJournalEntry() : card(0), operation(PutCard) {}
+    CardJournalEntry(quint32 card, Operation operation, const CardRecord &record = CardRecord())
+        : card(card), operation(operation), record(record) {}
+
+    void applyTo(QVector<CardRecord> &records) const;
+
+    QByteArray serialize() const;
+    static bool deserialize(const QByteArray &data, CardJournalEntry &entry);
+
+    quint32 card; // Index in the set, card count for SetCardCount
+    Operation operation;
+    CardRecord record; // Only the fields touched by the operation are used
+};
+
+class CardJournalWriter : public QThread
+{
+    Q_OBJECT
+public:
+    CardJournalWriter(const QString &setFilename, const QString &journalFilename, bool recover, QObject *parent = nullptr);
+
+    void enqueue(const QByteArray &frame);
+    void requestCompaction(const QByteArray &set);
+    void waitForWritten();
+    void stop();
+
+    void setSyncInterval(int msecs);
+    qint64 journalSize() const;
+
+signals:
+    void compacted();
+    void writeFailed(const QString &error);
+
+protected:
+    void run() override;
+
+private:
+    QString m_setFilename;
+    QString m_journalFilename;
+    bool m_recover;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wakeup;
+    QWaitCondition m_written;
+    QVector<QByteArray> m_pending;
+    quint64 m_enqueued;
+    quint64 m_synced;
+    int m_flushWaiters;
+    QByteArray m_compactedSet; // Set file with the journal folded in, written by compact()
+    bool m_compactRequested;
+    bool m_compacting;
+    bool m_stopRequested;
+    int m_syncInterval;
+    qint64 m_journalSize;
+
+    bool compact(QFile &journal, const QByteArray &set);
+};
+
+class CardSetJournal : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CardSetJournal(QObject *parent = nullptr);
+    ~CardSetJournal();
+
+    static const QString journalFilename(const QString &setFilename) { return setFilename + QStringLiteral(".journal"); }
+    static bool readEntries(const QString &journalFilename, QVector<CardJournalEntry> &entries, qint64 *validSize = nullptr);
+    static bool replay(const QString &journalFilename, QVector<CardRecord> &records);
+
+    bool open(const QString &setFilename, bool recover = false);
+    void close();
+    bool isOpen() const { return m_writer != nullptr; }
+    const QString setFilename() const { return m_setFilename; }
+
+    void append(const CardJournalEntry &entry);
+    void flush();
+    void compact();
+
+    void setSyncInterval(int msecs);
+    void setCompactionInterval(int msecs);
+    qint64 journalSize() const;
+
+signals:
+    void compacted();
+    void writeFailed(const QString &error);
+
+private:
+    QString m_setFilename;
+    CardJournalWriter *m_writer;
+    QTimer m_compactionTimer;
+    quint64 m_sequence;
+    int m_syncInterval;
+};
+
+/*!
+ * \brief Turns Card signals into journal entries.
+ */
+class CardJournalRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CardJournalRecorder(CardSetJournal *journal, QObject *parent = nullptr);
+
+    // Index in the set and side of the card the index belongs to
+    void watch(Card *card, int index, int side = 0);
+    void unwatch(Card *card);
+    void setIndex(Card *card, int index, int side = 0);
+    void putCard(Card *card);
+    // Stores the records from first on and the new count, after sides were inserted or removed
+    void putRecords(const QVector<CardRecord> &records, int first);
+
+private:
+    CardSetJournal *m_journal;
+    QHash<const Card*, QPair<int, int>> m_indices;
+
+    void record(const Card *card, Card::Changes changes);
+};
+
+#endif // CARDSETJOURNAL_H
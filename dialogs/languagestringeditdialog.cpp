@@ -1,6 +1,7 @@
 #include "languagestringeditdialog.h"
 #include "ui_multilanglineeditdialog.h"
 #include "util.h"
+#include "iconcache.h"
 #include "models/flanguagemodel.h"
 #include "widgets/multilangtextedit.h"
 
@@ -95,7 +96,7 @@ void LanguageStringEditDialog::init()
 
         m_inputs.push_back(lang_edit);
     }
-    ui->label_selectedLanguage->setPixmap(QIcon::fromTheme(selectedLanguage->flagIconPath()).pixmap(QSize(32,32)));
+    ui->label_selectedLanguage->setPixmap(IconCache::Instance()->pixmap(selectedLanguage->flagIconPath(), QSize(32,32)));
 //    ui->input_selectedLanguage->setRole(Qt::EditRole);
 //    ui->input_selectedLanguage->setCountryCode(selectedLanguage->countryCode());
 
@@ -112,7 +113,7 @@ void LanguageStringEditDialog::init()
         row++;
 
         QLabel *lang_iconlabel = new QLabel(this);
-        lang_iconlabel->setPixmap(QIcon::fromTheme(language->flagIconPath()).pixmap(QSize(32,32)));
+        lang_iconlabel->setPixmap(IconCache::Instance()->pixmap(language->flagIconPath(), QSize(32,32)));
         ui->gridLayout->addWidget(lang_iconlabel, row, 0);
 
         if (useTextEdit) {
@@ -205,14 +206,14 @@ void LanguageStringEditDialog::rebuildUI(const FLanguage *language)
     /*QWidget *l = ui->gridLayout->itemAtPosition(0, 0)->widget();
     if (l) {
         QLabel *label = static_cast<QLabel*>(l);
-        label->setPixmap(QIcon::fromTheme(language->flagIconPath()).pixmap(QSize(32,32)));
+        label->setPixmap(IconCache::Instance()->pixmap(language->flagIconPath(), QSize(32,32)));
     }
     QWidget *w = ui->gridLayout->itemAtPosition(0, 1)->widget();
     if (w) {
         MultiLangLineEdit *lineEdit = static_cast<MultiLangLineEdit*>(w);
         lineEdit->setCountryCode(language->countryCode());
     }*/
-    ui->label_selectedLanguage->setPixmap(QIcon::fromTheme(language->flagIconPath()).pixmap(QSize(32,32)));
+    ui->label_selectedLanguage->setPixmap(IconCache::Instance()->pixmap(language->flagIconPath(), QSize(32,32)));
     if (useTextEdit) {
         static_cast<MultiLangTextEdit*>(m_inputs[0])->setCountryCode(language->countryCode());
     } else {
@@ -251,12 +252,12 @@ void LanguageStringEditDialog::rebuildUI(const FLanguage *language)
             QWidget *l = ui->gridLayout->itemAtPosition(i, 0)->widget();
             if (l) {
                 QLabel *label = static_cast<QLabel*>(l);
-                label->setPixmap(QIcon::fromTheme(otherLanguage->flagIconPath()).pixmap(QSize(32,32)));
+                label->setPixmap(IconCache::Instance()->pixmap(otherLanguage->flagIconPath(), QSize(32,32)));
             }
         } else {
             // Create new
             QLabel *lang_iconlabel = new QLabel(this);
-            lang_iconlabel->setPixmap(QIcon::fromTheme(otherLanguage->flagIconPath()).pixmap(QSize(32,32)));
+            lang_iconlabel->setPixmap(IconCache::Instance()->pixmap(otherLanguage->flagIconPath(), QSize(32,32)));
             ui->gridLayout->addWidget(lang_iconlabel, i, 0);
 
             if (useTextEdit) {
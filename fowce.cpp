@@ -1,13 +1,14 @@
-#include <fstream>
-#include <iostream>
-
 #include <QApplication>
 #include <QSettings>
 #include <QLocale>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
 #include <QDateTime>
 #include <QPlainTextEdit>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QSharedPointer>
 
 #include <QDebug>
 
@@ -15,6 +16,21 @@
 
 #include "mainwindow.h"
 #include "util.h"
+#include "logwriter.h"
+#include "tracer.h"
+#include "render/renderdaemon.h"
+#include "render/setbuilder.h"
+#include "render/buildcheckpoint.h"
+#include "render/printsheetexporter.h"
+#include "render/atlasexporter.h"
+#include "render/archivewriter.h"
+#include "render/imageencoder.h"
+#include "render/cardrenderer.h"
+#include "render/workstealingscheduler.h"
+#include "cardset/cardsetfile.h"
+#include "models/fmodels.h"
+#include "models/flanguagemodel.h"
+#include "models/fdatawatcher.h"
 
 static QString LOG_DIR;
 
@@ -23,22 +39,287 @@ void FMessageOutput(QtMsgType type, const QMessageLogContext &context, const QSt
     const char *file = context.file ? context.file : "";
     const char *function = context.function ? context.function : "";
 
-    QString time = QDateTime::currentDateTime().toString("[yyyy-MM-dd hh:mm:ss]");
-    QString prefix = "[Debug]";
-    switch(type) {
-    case QtDebugMsg:    break;
-    case QtInfoMsg:     prefix = "[Info]"; break;
-    case QtWarningMsg:  prefix = "[Warning]"; break;
-    case QtCriticalMsg: prefix = "[Critical]"; break;
-    case QtFatalMsg:    prefix = "[Fatal]"; break;
-    }
-
-    QString out_msg = prefix + time + QString(" %1 (Line: %2, Function: %3, File: %4)\n").arg(msg, QString(context.line), QString(function), QString(file));
-    QByteArray filename = QDir(LOG_DIR).filePath(QDateTime::currentDateTime().toString("yyyyMMdd") + ".log").toUtf8();
-    std::ofstream out(filename.data(), std::ofstream::app);
-    out << out_msg.toUtf8().data();
-    out.close();
-    std::cerr << out_msg.toUtf8().data();
+    // Only queue the message, the writer thread does the file work
+    LogWriter::Instance()->log(type, QString("%1 (Line: %2, Function: %3, File: %4)").arg(msg, QString::number(context.line), QString(function), QString(file)));
+    if (type == QtFatalMsg) {
+        LogWriter::Instance()->flush();
+    }
+}
+
+/*!
+ * \brief Reports a failed command line mode on the terminal, next to the results on stdout.
+ *
+ * The message handler of release builds only queues messages for the log
+ * file, so qCritical() alone would leave the terminal without a reason.
+ */
+static int cliError(const QString &message)
+{
+    QTextStream(stderr) << message << '\n';
+    return 1;
+}
+
+/*!
+ * \brief Country codes of a comma separated --language value, the selected language without any.
+ */
+static QStringList splitLanguages(const QString &language, const FModels &models)
+{
+    QStringList countryCodes;
+    const QStringList parts = language.split(',');
+    QStringList::const_iterator it = parts.constBegin();
+    for (; it != parts.constEnd(); ++it) {
+        // Empty parts come from a trailing or doubled comma
+        const QString countryCode = it->trimmed();
+        if (!countryCode.isEmpty()) countryCodes.append(countryCode);
+    }
+    if (countryCodes.isEmpty()) {
+        countryCodes.append(models.languageModel()->selectedLanguage()->countryCode());
+    }
+    return countryCodes;
+}
+
+/*!
+ * \brief The "--build" mode, renders the cards of a set whose content hash is not cached yet.
+ *
+ * Several comma separated languages are built into a directory per language
+ * below the output directory, sharing the cache. The job keeps a checkpoint
+ * in the output directory and resumes from it when started again after an
+ * interruption.
+ *
+ * With \a watch the builders stay alive afterwards. Every time data files are
+ * edited, only the cards using a changed entry are hashed and rendered again.
+ */
+static int buildSet(const QString &setFile, const QString &outputDir, const QString &cacheDir, const QString &language, const RenderOutput &output,
+                    bool dryRun, bool watch)
+{
+    FModels models;
+    models.loadAllTexts();
+    const QStringList countryCodes = splitLanguages(language, models);
+
+    CardSetReader reader;
+    if (!reader.open(setFile)) {
+        return cliError(reader.errorString());
+    }
+
+    QTextStream out(stdout);
+    if (!dryRun) QDir().mkpath(outputDir);
+    BuildCheckpoint checkpoint(QDir(outputDir).filePath(SET_BUILD_CHECKPOINT));
+    if (!checkpoint.load()) {
+        return cliError(checkpoint.errorString());
+    }
+    if (checkpoint.count() > 0) {
+        out << QObject::tr("Resuming an interrupted build, %1 cards were rendered already.").arg(checkpoint.count()) << '\n';
+    }
+
+    WorkStealingScheduler scheduler;
+    QVector<QSharedPointer<SetBuilder>> builders; // By language
+    QStringList::const_iterator it = countryCodes.constBegin();
+    for (; it != countryCodes.constEnd(); ++it) {
+        const QString &countryCode = *it;
+        const FModelSnapshotPtr snapshot = FModelSnapshot::capture(countryCode);
+        if (!snapshot->language(countryCode)) {
+            return cliError(QObject::tr("Unknown language '%1'.").arg(countryCode));
+        }
+
+        const QString languageDir = countryCodes.size() > 1 ? QDir(outputDir).filePath(countryCode) : outputDir;
+        QSharedPointer<SetBuilder> builder(new SetBuilder(snapshot, output));
+        builder->setCacheDir(cacheDir.isEmpty() ? QDir(outputDir).filePath(".cache") : cacheDir);
+        builder->setOutputDir(languageDir);
+        builder->setCheckpoint(&checkpoint);
+        if (!builder->plan(reader)) {
+            return cliError(builder->errorString());
+        }
+        builders.append(builder);
+
+        if (dryRun) {
+            QVector<SetBuildEntry>::const_iterator entry = builder->entries().constBegin();
+            for (; entry != builder->entries().constEnd(); ++entry) {
+                if (!entry->cached) {
+                    out << countryCode << ' ' << entry->fileName << ' ' << entry->hash << ' ' << entry->record.cardName.text(countryCode) << '\n';
+                }
+            }
+            out << QObject::tr("%1 of %2 cards would be rendered.").arg(builder->staleCount()).arg(builder->entries().size()) << '\n';
+            continue;
+        }
+
+        const int stale = builder->staleCount();
+        if (!builder->build(&scheduler)) {
+            return cliError(builder->errorString());
+        }
+        out << QObject::tr("Rendered %1 of %2 cards in '%3'.").arg(stale).arg(builder->entries().size()).arg(countryCode) << '\n';
+    }
+
+    if (dryRun) return 0;
+    if (!checkpoint.remove()) {
+        return cliError(checkpoint.errorString());
+    }
+    if (!watch) return 0;
+
+    // The job is done, rebuilds must not extend its removed checkpoint
+    for (int i = 0; i < builders.size(); ++i) {
+        builders.at(i)->setCheckpoint(nullptr);
+    }
+    FDataWatcher watcher;
+    watcher.addModel(models.characteristicModel());
+    watcher.addModel(models.attributeModel());
+    watcher.addModel(models.generalCardTypeModel());
+    watcher.addModel(models.cardTypeModel());
+    watcher.addModel(models.rarityModel());
+    QObject::connect(&watcher, &FDataWatcher::modelsReloaded, [&]() {
+        for (int i = 0; i < builders.size(); ++i) {
+            SetBuilder *builder = builders.at(i).data();
+            const int changed = builder->updateSnapshot(FModelSnapshot::capture(countryCodes.at(i)));
+            if (changed == 0) continue;
+            const int stale = builder->staleCount();
+            if (!builder->build(&scheduler)) {
+                cliError(builder->errorString());
+                continue;
+            }
+            out << QObject::tr("Rendered %1 of %2 changed cards in '%3'.").arg(stale).arg(changed).arg(countryCodes.at(i)) << '\n';
+        }
+        out.flush();
+    });
+    out << QObject::tr("Watching the data files for changes, stop with Ctrl+C.") << '\n';
+    out.flush();
+    return QCoreApplication::exec();
+}
+
+/*!
+ * \brief The "--build" mode with an archive as output, streams every built card into it.
+ *
+ * Cards are rendered into the cache like directory builds, with a checkpoint
+ * beside the archive. The archive only replaces the target once it is
+ * complete, so an interrupted export resumes with the cards in the cache and
+ * only streams them into the archive again. Several comma separated languages
+ * are stored below a directory per language.
+ */
+static int buildArchive(const QString &setFile, const QString &archiveFile, const QString &cacheDir, const QString &language, const RenderOutput &output)
+{
+    FModels models;
+    models.loadAllTexts();
+    const QStringList countryCodes = splitLanguages(language, models);
+
+    // Checked up front, a typo in the last language must not leave a half written archive
+    QVector<FModelSnapshotPtr> snapshots;
+    QStringList::const_iterator it = countryCodes.constBegin();
+    for (; it != countryCodes.constEnd(); ++it) {
+        const FModelSnapshotPtr snapshot = FModelSnapshot::capture(*it);
+        if (!snapshot->language(*it)) {
+            return cliError(QObject::tr("Unknown language '%1'.").arg(*it));
+        }
+        snapshots.append(snapshot);
+    }
+
+    CardSetReader reader;
+    if (!reader.open(setFile)) {
+        return cliError(reader.errorString());
+    }
+
+    QTextStream out(stdout);
+    BuildCheckpoint checkpoint(archiveFile + SET_BUILD_CHECKPOINT);
+    if (!checkpoint.load()) {
+        return cliError(checkpoint.errorString());
+    }
+    if (checkpoint.count() > 0) {
+        out << QObject::tr("Resuming an interrupted build, %1 cards were rendered already.").arg(checkpoint.count()) << '\n';
+    }
+
+    ArchiveWriter archive(archiveFile);
+    if (!archive.open()) {
+        return cliError(archive.errorString());
+    }
+
+    const QString extension = ImageEncoder::fileExtension(output.format);
+    qint64 totalBytes = 0;
+    WorkStealingScheduler scheduler;
+    for (int l = 0; l < snapshots.size(); ++l) {
+        SetBuilder builder(snapshots.at(l), output);
+        builder.setCacheDir(cacheDir.isEmpty() ? QFileInfo(archiveFile).dir().filePath(".cache") : cacheDir);
+        builder.setCheckpoint(&checkpoint);
+        if (!builder.plan(reader) || !builder.build(&scheduler)) {
+            archive.cancel();
+            return cliError(builder.errorString());
+        }
+
+        const QString prefix = countryCodes.size() > 1 ? countryCodes.at(l) + '/' : QString();
+        QVector<SetBuildEntry>::const_iterator entry = builder.entries().constBegin();
+        for (; entry != builder.entries().constEnd(); ++entry) {
+            QFile file(builder.cachePath(entry->hash));
+            if (!file.open(QIODevice::ReadOnly)) {
+                archive.cancel();
+                return cliError(QObject::tr("Could not read '%1'. (%2)").arg(file.fileName(), file.errorString()));
+            }
+            const QByteArray data = file.readAll();
+            if (!archive.addFile(prefix + QString("%1-%2.%3").arg(entry->card, 4, 10, QChar('0')).arg(entry->record.side).arg(extension), data)) {
+                archive.cancel();
+                return cliError(archive.errorString());
+            }
+            totalBytes += data.size();
+        }
+    }
+    if (!archive.commit()) {
+        return cliError(archive.errorString());
+    }
+    if (!checkpoint.remove()) {
+        return cliError(checkpoint.errorString());
+    }
+    out << QObject::tr("Exported %1 cards, %2 bytes.").arg(archive.entryCount()).arg(totalBytes) << '\n';
+    return 0;
+}
+
+/*!
+ * \brief The "--print-sheets" mode, imposes the cards of a set onto pages with crop marks.
+ */
+static int printSheets(const QString &setFile, const QString &output, const QString &language, int dpi, bool vector)
+{
+    FModels models;
+    models.loadAllTexts();
+    const QString countryCode = language.isEmpty() ? models.languageModel()->selectedLanguage()->countryCode() : language;
+    const FModelSnapshotPtr snapshot = FModelSnapshot::capture(countryCode);
+    if (!snapshot->language(countryCode)) {
+        return cliError(QObject::tr("Unknown language '%1'.").arg(countryCode));
+    }
+
+    CardSetReader reader;
+    if (!reader.open(setFile)) {
+        return cliError(reader.errorString());
+    }
+    PrintSheetOptions options;
+    options.dpi = dpi;
+    options.vector = vector;
+    WorkStealingScheduler scheduler;
+    PrintSheetExporter exporter(&scheduler, snapshot, options);
+    const bool pdf = output.endsWith(".pdf", Qt::CaseInsensitive);
+    if (!(pdf ? exporter.exportPdf(reader, output) : exporter.exportPng(reader, output))) {
+        return cliError(exporter.errorString());
+    }
+    QTextStream(stdout) << QObject::tr("Exported %1 pages.").arg(exporter.pageCount(reader.cardCount())) << '\n';
+    return 0;
+}
+
+/*!
+ * \brief The "--atlas" mode, packs the cards of a set into texture atlases with a JSON index.
+ */
+static int exportAtlas(const QString &setFile, const QString &output, const QString &language, const AtlasOptions &options)
+{
+    FModels models;
+    models.loadAllTexts();
+    const QString countryCode = language.isEmpty() ? models.languageModel()->selectedLanguage()->countryCode() : language;
+    const FModelSnapshotPtr snapshot = FModelSnapshot::capture(countryCode);
+    if (!snapshot->language(countryCode)) {
+        return cliError(QObject::tr("Unknown language '%1'.").arg(countryCode));
+    }
+
+    CardSetReader reader;
+    if (!reader.open(setFile)) {
+        return cliError(reader.errorString());
+    }
+    WorkStealingScheduler scheduler;
+    AtlasExporter exporter(&scheduler, snapshot, options);
+    if (!exporter.exportAtlas(reader, output)) {
+        return cliError(exporter.errorString());
+    }
+    QTextStream(stdout) << QObject::tr("Exported %1 sheets.").arg(exporter.sheetSizes().size()) << '\n';
+    return 0;
 }
 
 int main(int argc, char *argv[])
@@ -50,18 +331,133 @@ int main(int argc, char *argv[])
     QDir logDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
     logDir.mkdir("logs");
     LOG_DIR = logDir.filePath("logs");
+    LogWriter::Instance()->setLogDir(LOG_DIR);
+    LogWriter::Instance()->start(QThread::LowPriority);
     qInstallMessageHandler(FMessageOutput);
 #endif
 
+    // The daemon and builds never show a window, so they must not need a display either
+    for (int i = 1; i < argc; ++i) {
+        if ((qstrcmp(argv[i], "--render-daemon") == 0 || qstrcmp(argv[i], "--build") == 0 || qstrcmp(argv[i], "--print-sheets") == 0
+             || qstrcmp(argv[i], "--atlas") == 0) && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
     QApplication a(argc, argv);
     QSettings::setDefaultFormat(QSettings::IniFormat);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption renderDaemonOption("render-daemon", QObject::tr("Render cards for clients connecting to the local socket <name> instead of starting the editor."), "name");
+    parser.addOption(renderDaemonOption);
+    QCommandLineOption buildOption("build", QObject::tr("Render the cards of the set <file> that changed since the last build."), "file");
+    parser.addOption(buildOption);
+    QCommandLineOption printSheetsOption("print-sheets", QObject::tr("Impose the cards of the set <file> onto print sheets, a PDF if the output ends in .pdf."), "file");
+    parser.addOption(printSheetsOption);
+    QCommandLineOption atlasOption("atlas", QObject::tr("Pack the cards of the set <file> into texture atlases with a JSON index."), "file");
+    parser.addOption(atlasOption);
+    QCommandLineOption outputOption("output", QObject::tr("Directory the built card images, print sheets or atlases are written to, or a .zip or .tar archive of the built cards."), "directory", "cards");
+    parser.addOption(outputOption);
+    QCommandLineOption cacheOption("cache", QObject::tr("Directory of the render cache, defaults to .cache in the output directory or beside the archive."), "directory");
+    parser.addOption(cacheOption);
+    QCommandLineOption formatOption("format", QObject::tr("Image format of the built cards."), "format", "png");
+    parser.addOption(formatOption);
+    QCommandLineOption widthOption("width", QObject::tr("Width of the built cards in pixels up to the full width of %1, 0 for the full width.").arg(CARD_WIDTH), "pixels", "0");
+    parser.addOption(widthOption);
+    QCommandLineOption languageOption("language", QObject::tr("Country code of the language to build, defaults to the selected one. Builds take a comma separated list."), "code");
+    parser.addOption(languageOption);
+    QCommandLineOption dpiOption("dpi", QObject::tr("Resolution of the print sheets."), "dpi", "300");
+    parser.addOption(dpiOption);
+    QCommandLineOption vectorOption("vector", QObject::tr("Draw text and symbols of PDF print sheets as vectors instead of images."));
+    parser.addOption(vectorOption);
+    QCommandLineOption atlasWidthsOption("atlas-widths", QObject::tr("Comma separated card widths of the atlas variants."), "pixels", "256");
+    parser.addOption(atlasWidthsOption);
+    QCommandLineOption atlasGridOption("atlas-grid", QObject::tr("Columns and rows of an atlas grid sheet."), "columnsxrows", "10x7");
+    parser.addOption(atlasGridOption);
+    QCommandLineOption atlasPackedOption("atlas-packed", QObject::tr("Bin-pack the atlas into power-of-two sheets of at most <pixels>."), "pixels");
+    parser.addOption(atlasPackedOption);
+    QCommandLineOption dryRunOption("dry-run", QObject::tr("Only list the cards a build would render."));
+    parser.addOption(dryRunOption);
+    QCommandLineOption watchOption("watch", QObject::tr("Keep running after a build into a directory, rendering the cards that use edited data files again."));
+    parser.addOption(watchOption);
+    parser.process(a);
+
     QSettings settings;
     QLocale locale = QLocale(settings.value("main/locale", "en_US").toString());
     QLocale::setDefault(locale);
 
-    MainWindow w;
-    w.show();
+#ifdef FOWCE_TRACING
+    // FOWCE_TRACE=layout,fit,svg,paint,export or all, FOWCE_TRACE_FILE defaults to trace.json
+    const QString traceCategories = qEnvironmentVariable("FOWCE_TRACE");
+    const QString traceFile = qEnvironmentVariable("FOWCE_TRACE_FILE", "trace.json");
+    Tracer::setCategories(Tracer::parseCategories(traceCategories));
+#endif
 
-    return a.exec();
+    int result = 0;
+    if (parser.isSet(buildOption)) {
+        RenderOutput output;
+        output.format = parser.value(formatOption).toLatin1();
+        bool widthOk = false;
+        output.width = parser.value(widthOption).toInt(&widthOk);
+        if (!widthOk || output.width < 0 || output.width > CARD_WIDTH) {
+            result = cliError(QObject::tr("Invalid --width '%1', expected 0 for the full size or a number of pixels up to %2.\n\n%3")
+                              .arg(parser.value(widthOption)).arg(CARD_WIDTH).arg(parser.helpText()));
+        } else if (ArchiveWriter::isArchive(parser.value(outputOption)) && !parser.isSet(dryRunOption)) {
+            result = buildArchive(parser.value(buildOption), parser.value(outputOption), parser.value(cacheOption),
+                                  parser.value(languageOption), output);
+        } else {
+            result = buildSet(parser.value(buildOption), parser.value(outputOption), parser.value(cacheOption),
+                              parser.value(languageOption), output, parser.isSet(dryRunOption), parser.isSet(watchOption));
+        }
+    } else if (parser.isSet(printSheetsOption)) {
+        bool dpiOk = false;
+        const int dpi = parser.value(dpiOption).toInt(&dpiOk);
+        if (!dpiOk || dpi <= 0) {
+            result = cliError(QObject::tr("Invalid --dpi '%1', expected a positive number.\n\n%2")
+                              .arg(parser.value(dpiOption), parser.helpText()));
+        } else {
+            result = printSheets(parser.value(printSheetsOption), parser.value(outputOption), parser.value(languageOption),
+                                 dpi, parser.isSet(vectorOption));
+        }
+    } else if (parser.isSet(atlasOption)) {
+        AtlasOptions options;
+        options.format = parser.value(formatOption).toLatin1();
+        options.widths.clear();
+        const QStringList widths = parser.value(atlasWidthsOption).split(',');
+        QStringList::const_iterator it = widths.constBegin();
+        for (; it != widths.constEnd(); ++it) {
+            // Empty parts come from a trailing or doubled comma
+            if (it->trimmed().isEmpty()) continue;
+            options.widths.append(it->trimmed().toInt());
+        }
+        const QStringList grid = parser.value(atlasGridOption).split('x');
+        if (grid.size() == 2) {
+            options.columns = qMax(1, grid.at(0).toInt());
+            options.rows = qMax(1, grid.at(1).toInt());
+        }
+        if (parser.isSet(atlasPackedOption)) {
+            options.packed = true;
+            options.sheetSize = int(qNextPowerOfTwo(quint32(qMax(1, parser.value(atlasPackedOption).toInt()) - 1)));
+        }
+        result = exportAtlas(parser.value(atlasOption), parser.value(outputOption), parser.value(languageOption), options);
+    } else if (parser.isSet(renderDaemonOption)) {
+        RenderDaemon daemon;
+        if (daemon.start(parser.value(renderDaemonOption))) {
+            result = a.exec();
+        } else {
+            result = cliError(daemon.errorString());
+        }
+    } else {
+        MainWindow w;
+        w.show();
+        result = a.exec();
+    }
+#ifdef FOWCE_TRACING
+    if (Tracer::categories() != Tracer::NoCategory) {
+        Tracer::Instance()->writeChromeJson(traceFile);
+    }
+#endif
+    LogWriter::Instance()->stop();
+    return result;
 }
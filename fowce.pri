@@ -0,0 +1,166 @@
+# Everything but the main window and main(), shared by FOWCE.pro and the
+# benchmarks. Paths are relative to this file so other projects can include it.
+
+QT       += core gui widgets xml svg network
+
+CONFIG += c++11
+
+# Build with "CONFIG+=tracing" to compile in the render pipeline trace spans.
+# They are recorded when FOWCE_TRACE is set, e.g. FOWCE_TRACE=layout,fit or all.
+tracing: DEFINES += FOWCE_TRACING
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/util.cpp \
+    $$PWD/card.cpp \
+    $$PWD/cardrecord.cpp \
+    $$PWD/cardpreviewdebugoverlay.cpp \
+    $$PWD/cardpreviewitem.cpp \
+    $$PWD/cardpreviewpainter.cpp \
+    $$PWD/cardpreviewtextitem.cpp \
+    $$PWD/cardpreviewwidget.cpp \
+    $$PWD/cardset/cardcorpusgenerator.cpp \
+    $$PWD/cardset/carddependencyindex.cpp \
+    $$PWD/cardset/cardsearchindex.cpp \
+    $$PWD/cardset/cardsetfile.cpp \
+    $$PWD/cardset/cardsetjournal.cpp \
+    $$PWD/dialogs/addcardsidedialog.cpp \
+    $$PWD/dialogs/addtraitdialog.cpp \
+    $$PWD/iconcache.cpp \
+    $$PWD/langstringdelegate.cpp \
+    $$PWD/langstringlistmodel.cpp \
+    $$PWD/logger.cpp \
+    $$PWD/logwriter.cpp \
+    $$PWD/renderstats.cpp \
+    $$PWD/render/archivewriter.cpp \
+    $$PWD/render/atlasexporter.cpp \
+    $$PWD/render/batchrenderer.cpp \
+    $$PWD/render/buildcheckpoint.cpp \
+    $$PWD/render/cardrenderer.cpp \
+    $$PWD/render/imagecache.cpp \
+    $$PWD/render/imageencoder.cpp \
+    $$PWD/render/printsheetexporter.cpp \
+    $$PWD/render/renderclient.cpp \
+    $$PWD/render/renderdaemon.cpp \
+    $$PWD/render/renderjob.cpp \
+    $$PWD/render/renderserver.cpp \
+    $$PWD/render/renderservice.cpp \
+    $$PWD/render/setbuilder.cpp \
+    $$PWD/render/workstealingscheduler.cpp \
+    $$PWD/models/fabstractobject.cpp \
+    $$PWD/models/fabstractyamlmodel.cpp \
+    $$PWD/models/fattributemodel.cpp \
+    $$PWD/models/fcardtypemodel.cpp \
+    $$PWD/models/fdatawatcher.cpp \
+    $$PWD/models/fgeneralcardtypemodel.cpp \
+    $$PWD/models/flanguagemodel.cpp \
+    $$PWD/models/flanguagestring.cpp \
+    $$PWD/models/fmodels.cpp \
+    $$PWD/models/fmodelsnapshot.cpp \
+    $$PWD/models/fraritymodel.cpp \
+    $$PWD/models/fwillcharacteristicmodel.cpp \
+    $$PWD/text/ftextobject.cpp \
+    $$PWD/widgets/attributecheckboxgroup.cpp \
+    $$PWD/widgets/buttonlineedit.cpp \
+    $$PWD/widgets/cardsidepushbutton.cpp \
+    $$PWD/widgets/fcombobox.cpp \
+    $$PWD/widgets/multilanglineedit.cpp \
+    $$PWD/widgets/multilangtextedit.cpp \
+    $$PWD/willcostdelegate.cpp \
+    $$PWD/willcostmodel.cpp \
+    $$PWD/tracer.cpp \
+    $$PWD/text/fgraphicstextitem.cpp \
+    $$PWD/text/ftextbox.cpp \
+    $$PWD/text/ftextdocumentlayout.cpp \
+    $$PWD/text/ftextcursor.cpp \
+    $$PWD/text/ftexttokenizer.cpp \
+    $$PWD/dialogs/optionswindow.cpp \
+    $$PWD/dialogs/languagestringeditdialog.cpp
+
+HEADERS += \
+    $$PWD/util.h \
+    $$PWD/card.h \
+    $$PWD/cardrecord.h \
+    $$PWD/cardpreviewdebugoverlay.h \
+    $$PWD/cardpreviewitem.h \
+    $$PWD/cardpreviewpainter.h \
+    $$PWD/cardpreviewtextitem.h \
+    $$PWD/cardpreviewwidget.h \
+    $$PWD/cardset/cardcorpusgenerator.h \
+    $$PWD/cardset/carddependencyindex.h \
+    $$PWD/cardset/cardsearchindex.h \
+    $$PWD/cardset/cardsetfile.h \
+    $$PWD/cardset/cardsetjournal.h \
+    $$PWD/dialogs/addcardsidedialog.h \
+    $$PWD/dialogs/addtraitdialog.h \
+    $$PWD/iconcache.h \
+    $$PWD/langstringdelegate.h \
+    $$PWD/langstringlistmodel.h \
+    $$PWD/logger.h \
+    $$PWD/logwriter.h \
+    $$PWD/renderstats.h \
+    $$PWD/render/archivewriter.h \
+    $$PWD/render/atlasexporter.h \
+    $$PWD/render/batchrenderer.h \
+    $$PWD/render/buildcheckpoint.h \
+    $$PWD/render/cardrenderer.h \
+    $$PWD/render/imagecache.h \
+    $$PWD/render/imageencoder.h \
+    $$PWD/render/printsheetexporter.h \
+    $$PWD/render/renderclient.h \
+    $$PWD/render/renderdaemon.h \
+    $$PWD/render/renderjob.h \
+    $$PWD/render/renderserver.h \
+    $$PWD/render/renderservice.h \
+    $$PWD/render/setbuilder.h \
+    $$PWD/render/workstealingscheduler.h \
+    $$PWD/models/fabstractobject.h \
+    $$PWD/models/fabstractyamlmodel.h \
+    $$PWD/models/fattributemodel.h \
+    $$PWD/models/fcardtypemodel.h \
+    $$PWD/models/fdatawatcher.h \
+    $$PWD/models/fgeneralcardtypemodel.h \
+    $$PWD/models/flanguagemodel.h \
+    $$PWD/models/flanguagestring.h \
+    $$PWD/models/fmodels.h \
+    $$PWD/models/fmodelsnapshot.h \
+    $$PWD/models/fraritymodel.h \
+    $$PWD/models/fwillcharacteristicmodel.h \
+    $$PWD/models/yamlconvert.h \
+    $$PWD/text/ftextobject.h \
+    $$PWD/widgets/attributecheckboxgroup.h \
+    $$PWD/widgets/buttonlineedit.h \
+    $$PWD/widgets/cardsidepushbutton.h \
+    $$PWD/widgets/fcombobox.h \
+    $$PWD/widgets/multilanglineedit.h \
+    $$PWD/widgets/multilanglineeditwidget.h \
+    $$PWD/widgets/multilangtextedit.h \
+    $$PWD/willcostdelegate.h \
+    $$PWD/willcostmodel.h \
+    $$PWD/qfixed_p.h \
+    $$PWD/tracer.h \
+    $$PWD/text/fgraphicstextitem.h \
+    $$PWD/text/ftextbox.h \
+    $$PWD/text/ftextdocumentlayout.h \
+    $$PWD/text/ftextcursor.h \
+    $$PWD/text/ftexttokenizer.h \
+    $$PWD/dialogs/optionswindow.h \
+    $$PWD/dialogs/languagestringeditdialog.h
+
+FORMS += \
+    $$PWD/cardpreviewwidget.ui \
+    $$PWD/dialogs/addtraitdialog.ui \
+    $$PWD/dialogs/addcardsidedialog.ui \
+    $$PWD/widgets/attributecheckboxgroup.ui \
+    $$PWD/dialogs/multilanglineeditdialog.ui \
+    $$PWD/dialogs/optionswindow.ui
+
+RESOURCES += \
+    $$PWD/resources.qrc \
+    $$PWD/icons.qrc
+
+unix|win32: LIBS += -L$$PWD/../build-yaml-cpp-Desktop_Qt_5_12_2_MSVC2017_64bit-Debug/ -llibyaml-cppmdd
+
+INCLUDEPATH += $$PWD/../yaml-cpp/include
+DEPENDPATH += $$PWD/../yaml-cpp/include
@@ -0,0 +1,84 @@
+#include <QCoreApplication>
+#include "iconcache.h"
+#include "models/fattributemodel.h"
+#include "models/flanguagemodel.h"
+
+// Sizes used by the item views and the language dialogs
+static const int IconSizes[] = { 16, 24, 32 };
+
+IconCache *IconCache::Instance()
+{
+    static IconCache instance;
+    static bool connected = false;
+    // Pixmaps must be gone before QApplication, the static instance outlives it
+    if (!connected && QCoreApplication::instance()) {
+        QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, []() { instance.clear(); });
+        connected = true;
+    }
+    return &instance;
+}
+
+const QIcon IconCache::icon(const QString &name)
+{
+    const QString iconName = name.isEmpty() ? QStringLiteral("missing") : name;
+    QHash<QString, QIcon>::const_iterator it = m_icons.constFind(iconName);
+    if (it != m_icons.constEnd()) {
+        return it.value();
+    }
+
+    QIcon icon;
+    for (int size : IconSizes) {
+        icon.addPixmap(pixmap(iconName, QSize(size, size)));
+    }
+    m_icons.insert(iconName, icon);
+    return icon;
+}
+
+const QPixmap IconCache::pixmap(const QString &name, const QSize &size)
+{
+    const QString iconName = name.isEmpty() ? QStringLiteral("missing") : name;
+    const QString pixmapKey = key(iconName, size);
+    QHash<QString, QPixmap>::const_iterator it = m_pixmaps.constFind(pixmapKey);
+    if (it != m_pixmaps.constEnd()) {
+        return it.value();
+    }
+
+    QPixmap pixmap = QIcon::fromTheme(iconName).pixmap(size);
+    m_pixmaps.insert(pixmapKey, pixmap);
+    return pixmap;
+}
+
+void IconCache::preload(const QString &name)
+{
+    icon(name);
+}
+
+void IconCache::preload(const FAttributeModel *attributeModel)
+{
+    if (!attributeModel) return;
+    QVector<FAbstractObject*>::const_iterator it = attributeModel->dataVec()->constBegin();
+    for (; it != attributeModel->dataVec()->constEnd(); ++it) {
+        const FAttribute *attribute = static_cast<FAttribute*>(*it);
+        preload(attribute->iconPath());
+
+        QVector<const FWillCharacteristic*>::const_iterator cit = attribute->characteristics()->constBegin();
+        for (; cit != attribute->characteristics()->constEnd(); ++cit) {
+            preload((*cit)->iconPath());
+        }
+    }
+}
+
+void IconCache::preload(const FLanguageModel *languageModel)
+{
+    if (!languageModel) return;
+    QVector<FAbstractObject*>::const_iterator it = languageModel->dataVec()->constBegin();
+    for (; it != languageModel->dataVec()->constEnd(); ++it) {
+        preload(static_cast<FLanguage*>(*it)->flagIconPath());
+    }
+}
+
+void IconCache::clear()
+{
+    m_icons.clear();
+    m_pixmaps.clear();
+}
@@ -0,0 +1,42 @@
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QHash>
+#include <QIcon>
+#include <QPixmap>
+#include <QSize>
+
+class FAttributeModel;
+class FLanguageModel;
+
+/*!
+ * \brief Rasterized theme icons, keyed by icon name and size.
+ *
+ * Theme icons are SVGs, so QIcon::fromTheme() and QIcon::pixmap() are too
+ * slow to call from data() or paint(). Only use this from the GUI thread.
+ * The cache is cleared when the application is about to quit.
+ */
+class IconCache
+{
+public:
+    static IconCache *Instance();
+
+    // Icon made of the pre-rasterized standard sizes, "missing" for an empty name
+    const QIcon icon(const QString &name);
+    const QPixmap pixmap(const QString &name, const QSize &size);
+
+    void preload(const QString &name);
+    void preload(const FAttributeModel *attributeModel);
+    void preload(const FLanguageModel *languageModel);
+    void clear();
+
+private:
+    IconCache() {}
+
+    QHash<QString, QIcon> m_icons;
+    QHash<QString, QPixmap> m_pixmaps;
+
+    static QString key(const QString &name, const QSize &size) { return QString("%1@%2x%3").arg(name).arg(size.width()).arg(size.height()); }
+};
+
+#endif // ICONCACHE_H
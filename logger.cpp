@@ -1,35 +1,15 @@
 #include <QDateTime>
-#include <QStandardPaths>
-#include <QTextStream>
 
 #include "logger.h"
+#include "logwriter.h"
 
-Logger::Logger()
+Logger::Logger() : m_editor(nullptr)
 {
-    file = new QFile();
-    QString path = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
-    QDir *dir = new QDir(path);
-    dir->mkdir("logs");
-    dir->cd("logs");
-    m_logsDir = dir;
 }
 
 Logger::Logger(QObject *parent, QPlainTextEdit *editor) :
     QObject(parent), m_editor(editor)
 {
-    file = new QFile();
-    QString path = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
-    QDir *dir = new QDir(path);
-    dir->mkdir("logs");
-    dir->cd("logs");
-    m_logsDir = dir;
-}
-
-Logger::~Logger()
-{
-    if (file->isOpen()) {
-        file->close();
-    }
 }
 
 void Logger::setEditor(QPlainTextEdit *editor)
@@ -37,28 +17,12 @@ void Logger::setEditor(QPlainTextEdit *editor)
     m_editor = editor;
 }
 
-bool Logger::openFile()
-{
-    if (!file->isOpen()) {
-        QString today = QDateTime::currentDateTime().toString("yyyyMMdd");
-        QString errorFile = QString("error.") + today + QString(".log");
-        file->setFileName(m_logsDir->filePath(errorFile));
-        return file->open(QIODevice::Append | QIODevice::Text);
-    }
-    return true;
-}
-
 void Logger::Error(const QString &message)
 {
-    QString text = message;
-    text = QString("[Error] ") + QDateTime::currentDateTime().toString("[yyyy-MM-dd hh:mm:ss] ") + text;
-    if (openFile()) {
-        QTextStream out(file);
-        out.setCodec("UTF-8");
-        out << text;
-    }
+    // The file is written by LogWriter, into error.<day>.log
+    LogWriter::Instance()->log(QtCriticalMsg, message, LogEntry::ErrorChannel);
 
     if (m_editor) {
-        m_editor->appendPlainText(text);
+        m_editor->appendPlainText(QString("[Error] ") + QDateTime::currentDateTime().toString("[yyyy-MM-dd hh:mm:ss] ") + message);
     }
 }
@@ -3,10 +3,7 @@
 
 #include <QObject>
 #include <QPlainTextEdit>
-#include <QDir>
 #include <QDateTime>
-#include <QStandardPaths>
-#include <QTextStream>
 
 class Logger : QObject
 {
@@ -14,17 +11,11 @@ class Logger : QObject
 public:
     explicit Logger();
     explicit Logger(QObject *parent, QPlainTextEdit *editor = nullptr);
-    ~Logger();
     void setEditor(QPlainTextEdit *editor);
 
 private:
-    QFile *file;
-    QString m_errorFileName;
-    QDir *m_logsDir;
     QPlainTextEdit *m_editor;
 
-    bool openFile();
-
 public slots:
     void Error(const QString &message);
 };
@@ -0,0 +1,219 @@
+#include <iostream>
+#include <QDateTime>
+#include "logwriter.h"
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/* Ring buffer */
+
+LogRingBuffer::LogRingBuffer()
+    : m_slots(new Slot[LOG_RING_CAPACITY]), m_head(0), m_tail(0)
+{
+    for (quint64 i = 0; i < LOG_RING_CAPACITY; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+LogRingBuffer::~LogRingBuffer()
+{
+    delete[] m_slots;
+}
+
+bool LogRingBuffer::push(LogEntry &entry)
+{
+    quint64 pos = m_head.load(std::memory_order_relaxed);
+    Slot *slot;
+    forever {
+        slot = &m_slots[pos & (LOG_RING_CAPACITY - 1)];
+        quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+        qint64 diff = qint64(sequence) - qint64(pos);
+        if (diff == 0) {
+            // Slot is free, claim it
+            if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // The consumer has not freed this slot yet
+            return false;
+        } else {
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+    }
+    slot->entry = std::move(entry);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogRingBuffer::pop(LogEntry &entry)
+{
+    quint64 pos = m_tail.load(std::memory_order_relaxed);
+    Slot *slot = &m_slots[pos & (LOG_RING_CAPACITY - 1)];
+    quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+    if (qint64(sequence) - qint64(pos + 1) < 0) return false;
+
+    entry = std::move(slot->entry);
+    slot->sequence.store(pos + LOG_RING_CAPACITY, std::memory_order_release);
+    m_tail.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+/* Writer */
+
+LogWriter::LogWriter()
+    : m_dropped(0), m_droppedTotal(0), m_stopRequested(false), m_syncTarget(0), m_synced(0), m_echo(true),
+      m_dayBegin(0), m_dayEnd(0), m_lastSecond(-1)
+{
+}
+
+LogWriter *LogWriter::Instance()
+{
+    static LogWriter instance;
+    return &instance;
+}
+
+void LogWriter::log(QtMsgType type, const QString &message, LogEntry::Channel channel)
+{
+    LogEntry entry;
+    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
+    entry.type = quint8(type);
+    entry.channel = channel;
+    entry.message = message.toUtf8();
+    if (!m_buffer.push(entry)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void LogWriter::flush()
+{
+    if (!isRunning() || QThread::currentThread() == this) return;
+    // Popped entries may not be on disk yet, wait for the writer to sync them
+    const quint64 target = m_buffer.pushed();
+    quint64 requested = m_syncTarget.load();
+    while (requested < target && !m_syncTarget.compare_exchange_weak(requested, target)) {}
+    while (m_synced.load() < target && isRunning()) {
+        QThread::msleep(1);
+    }
+}
+
+void LogWriter::stop()
+{
+    m_stopRequested.store(true);
+    wait();
+}
+
+void LogWriter::run()
+{
+    LogEntry entry;
+    forever {
+        bool stopping = m_stopRequested.load();
+        int written = 0;
+        while (written < LOG_WRITE_BATCH && m_buffer.pop(entry)) {
+            write(entry);
+            written++;
+        }
+
+        quint64 dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            m_droppedTotal.fetch_add(dropped, std::memory_order_relaxed);
+            LogEntry notice;
+            notice.timestamp = QDateTime::currentMSecsSinceEpoch();
+            notice.type = QtWarningMsg;
+            notice.channel = LogEntry::MainChannel;
+            notice.message = QByteArray::number(dropped) + " log messages were dropped, the log buffer was full.";
+            write(notice);
+        }
+
+        if (written > 0 || dropped > 0) {
+            m_files[LogEntry::MainChannel].flush();
+            m_files[LogEntry::ErrorChannel].flush();
+            if (m_echo) std::cerr.flush();
+        }
+        if (m_synced.load() < m_syncTarget.load()) {
+            syncFiles();
+            m_synced.store(m_buffer.popped());
+        }
+
+        if (written == LOG_WRITE_BATCH) continue;
+        if (stopping) break;
+        // Nothing left, producers do not wake us up so they never block
+        QThread::msleep(20);
+    }
+
+    m_files[LogEntry::MainChannel].close();
+    m_files[LogEntry::ErrorChannel].close();
+}
+
+void LogWriter::write(const LogEntry &entry)
+{
+    // Formatting the date is the expensive part, the day is kept until it ends
+    // and the time as long as lines share their second
+    if (entry.timestamp < m_dayBegin || entry.timestamp >= m_dayEnd) {
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(entry.timestamp);
+        const QDateTime begin(time.date(), QTime(0, 0));
+        m_dayBegin = begin.toMSecsSinceEpoch();
+        m_dayEnd = begin.addDays(1).toMSecsSinceEpoch();
+        m_day = time.toString("yyyyMMdd");
+        m_dayPrefix = time.toString("[yyyy-MM-dd ").toUtf8();
+        m_lastSecond = -1;
+    }
+    const qint64 second = entry.timestamp / 1000;
+    if (second != m_lastSecond) {
+        m_lastSecond = second;
+        m_lastTime = m_dayPrefix + QDateTime::fromMSecsSinceEpoch(entry.timestamp).time().toString("hh:mm:ss]").toUtf8();
+    }
+
+    const char *prefix = "[Debug]";
+    if (entry.channel == LogEntry::ErrorChannel) {
+        prefix = "[Error]";
+    } else {
+        switch (entry.type) {
+        case QtDebugMsg:    break;
+        case QtInfoMsg:     prefix = "[Info]"; break;
+        case QtWarningMsg:  prefix = "[Warning]"; break;
+        case QtCriticalMsg: prefix = "[Critical]"; break;
+        case QtFatalMsg:    prefix = "[Fatal]"; break;
+        }
+    }
+
+    QByteArray line;
+    line.reserve(int(qstrlen(prefix)) + m_lastTime.size() + entry.message.size() + 2);
+    line.append(prefix).append(m_lastTime).append(' ').append(entry.message).append('\n');
+
+    if (openFile(entry.channel, m_day)) {
+        m_files[entry.channel].write(line);
+    }
+    if (m_echo) {
+        std::cerr.write(line.constData(), line.size());
+    }
+}
+
+bool LogWriter::openFile(LogEntry::Channel channel, const QString &day)
+{
+    QFile &file = m_files[channel];
+    if (file.isOpen() && m_fileDays[channel] == day) return true;
+
+    // New day or first entry, rotate
+    file.close();
+    QString filename = (channel == LogEntry::ErrorChannel ? QString("error.") : QString()) + day + QString(".log");
+    file.setFileName(m_logDir.filePath(filename));
+    m_fileDays[channel] = day;
+    if (!file.open(QIODevice::Append)) {
+        std::cerr << "Could not open log file " << qPrintable(file.fileName()) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void LogWriter::syncFiles()
+{
+    for (QFile &file : m_files) {
+        if (!file.isOpen()) continue;
+#ifdef Q_OS_WIN
+        _commit(file.handle());
+#else
+        ::fsync(file.handle());
+#endif
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef LOGWRITER_H
+#define LOGWRITER_H
+
+#include <atomic>
+#include <QThread>
+#include <QFile>
+#include <QDir>
+
+#define LOG_RING_CAPACITY 8192 // Must be a power of two
+#define LOG_WRITE_BATCH 256
+
+struct LogEntry
+{
+    enum Channel : quint8 { MainChannel, ErrorChannel };
+
+    qint64 timestamp; // msecs since epoch
+    quint8 type; // QtMsgType
+    Channel channel;
+    QByteArray message; // UTF-8, without prefix and timestamp
+};
+
+/*!
+ * \brief Bounded multi-producer, single-consumer queue of log entries.
+ *
+ * Every slot carries a sequence number telling producers and the consumer
+ * whose turn it is, so pushing never takes a lock. A full buffer rejects the
+ * entry instead of blocking the caller.
+ */
+class LogRingBuffer
+{
+public:
+    LogRingBuffer();
+    ~LogRingBuffer();
+
+    bool push(LogEntry &entry);
+    bool pop(LogEntry &entry); // Consumer thread only
+
+    quint64 pushed() const { return m_head.load(std::memory_order_acquire); }
+    quint64 popped() const { return m_tail.load(std::memory_order_acquire); }
+
+private:
+    struct Slot {
+        std::atomic<quint64> sequence;
+        LogEntry entry;
+    };
+
+    Slot *m_slots;
+    alignas(64) std::atomic<quint64> m_head;
+    alignas(64) std::atomic<quint64> m_tail;
+
+    Q_DISABLE_COPY(LogRingBuffer)
+};
+
+/*!
+ * \brief Writes queued log entries to day-rotated files in the background.
+ *
+ * Producers only format the message and push it; timestamps, prefixes and
+ * file handling are done by the writer thread. The writer must not use the
+ * Qt message handlers itself, its own problems go to stderr.
+ */
+class LogWriter : public QThread
+{
+    Q_OBJECT
+public:
+    static LogWriter *Instance();
+
+    void setLogDir(const QString &dir) { m_logDir = QDir(dir); }
+    void setEchoToStderr(bool echo) { m_echo = echo; }
+
+    void log(QtMsgType type, const QString &message, LogEntry::Channel channel = LogEntry::MainChannel);
+    void flush(); // Blocks until everything logged so far is written and synced to disk
+    void stop();
+
+    quint64 droppedCount() const { return m_droppedTotal.load(std::memory_order_relaxed); }
+
+protected:
+    void run() override;
+
+private:
+    LogWriter();
+
+    LogRingBuffer m_buffer;
+    std::atomic<quint64> m_dropped;
+    std::atomic<quint64> m_droppedTotal;
+    std::atomic<bool> m_stopRequested;
+    std::atomic<quint64> m_syncTarget; // Entries flush() waits for
+    std::atomic<quint64> m_synced;     // Entries written and synced to disk
+    QDir m_logDir;
+    bool m_echo;
+
+    QFile m_files[2];
+    QString m_fileDays[2];
+    qint64 m_dayBegin; // Local day of the cached prefix, in msecs since epoch
+    qint64 m_dayEnd;
+    QString m_day;
+    QByteArray m_dayPrefix;
+    qint64 m_lastSecond;
+    QByteArray m_lastTime;
+
+    void write(const LogEntry &entry);
+    bool openFile(LogEntry::Channel channel, const QString &day);
+    void syncFiles();
+};
+
+#endif // LOGWRITER_H
@@ -2,20 +2,25 @@
 #include <QStandardItemModel>
 #include <QLocale>
 #include <QMessageBox>
+#include <QFileDialog>
+#include <QInputDialog>
 
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "langstringdelegate.h"
 #include "willcostdelegate.h"
 #include "card.h"
+#include "cardset/cardsetfile.h"
+#include "iconcache.h"
 
 #include "models/flanguagemodel.h"
+#include "models/fmodelsnapshot.h"
 
 #include <QDebug>
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
-    ui(new Ui::MainWindow), m_selectedCardSide(0), m_activeCardTypes(1)
+    ui(new Ui::MainWindow), m_selectedCardSide(0), m_activeCardTypes(1), m_editedCard(0)
 {
     QIcon::setThemeName("FOWCE");
 
@@ -46,11 +51,54 @@ MainWindow::MainWindow(QWidget *parent) :
     m_rarityModel = new FRarityModel(this);
     FRarityModel::SetInstance(m_rarityModel);
 
+    // Renderers read the models only through the published snapshot
+    FModelSnapshot::publish(FModelSnapshot::capture(m_languageModel->selectedLanguage()->countryCode()));
+    QObject::connect(m_languageModel, &FLanguageModel::languageSelected, this, [this](const FLanguage *language) {
+        FModelSnapshot::publish(FModelSnapshot::capture(language->countryCode()));
+        ui->widget_cardpreview->updateSnapshot();
+    });
+
+    // Edited data files are reloaded in place, only the cards using a changed entry redraw
+    m_dataWatcher = new FDataWatcher(this);
+    m_dataWatcher->addModel(m_characteristicModel);
+    m_dataWatcher->addModel(m_attributeModel);
+    m_dataWatcher->addModel(m_generalCardTypeModel);
+    m_dataWatcher->addModel(m_cardTypeModel);
+    m_dataWatcher->addModel(m_rarityModel);
+    QObject::connect(m_dataWatcher, &FDataWatcher::modelsReloaded, this, [this]() {
+        WillCostSchema::invalidate(m_attributeModel);
+        QVector<Card*>::const_iterator it;
+        for (it = m_cards.begin(); it != m_cards.end(); ++it) {
+            (*it)->willCostModel()->updateSchema();
+        }
+        // Records of the set reference entries by id, which moved with the reload
+        QVector<CardRecord>::iterator record = m_setRecords.begin();
+        for (; record != m_setRecords.end(); ++record) {
+            CardSetFile::remap(*record, m_setIds);
+        }
+        m_setIds = CardSetFile::idTable();
+        FModelSnapshot::publish(FModelSnapshot::capture(m_languageModel->selectedLanguage()->countryCode()));
+        ui->widget_cardpreview->updateSnapshot();
+    });
+
+    // Rasterize theme icons once, the views ask for them on every repaint
+    IconCache::Instance()->preload(m_attributeModel);
+    IconCache::Instance()->preload(m_languageModel);
+
     Card *mainCard = new Card(this, m_attributeModel, m_languageModel);
     mainCard->addCardType(0, m_cardTypeModel->get(0));
     mainCard->addGeneralCardType(0, m_generalCardTypeModel->get(0));
     m_cards.push_back(mainCard);
     m_selectedCard = mainCard;
+    // A new set, the edited card is its only one
+    m_setRecords.append(CardRecord::fromCard(mainCard));
+    m_setIds = CardSetFile::idTable();
+
+    m_journal = new CardSetJournal(this);
+    m_journal->setCompactionInterval(5 * 60 * 1000);
+    m_journalRecorder = new CardJournalRecorder(m_journal, this);
+    m_searchIndex = new CardSearchIndex(this);
+    m_searchIndex->watch(0, mainCard);
 
     ui->setupUi(this);
 
@@ -308,11 +356,11 @@ void MainWindow::rarityChanged(int index)
     }
 }
 
-void MainWindow::switchCard(int index)
+void MainWindow::switchCard(int index, bool reload)
 {
     if (index < 0 || index >= m_cards.size()) return;
     Card *newCard = m_cards[index];
-    if (newCard == m_selectedCard) return;
+    if (newCard == m_selectedCard && !reload) return;
 
     ui->listView_trait->setModel(newCard->traitModel());
     ui->listView_abilities->setModel(newCard->abilityTextModel());
@@ -385,12 +433,28 @@ void MainWindow::editCardSideName()
 void MainWindow::deleteCardSide()
 {
     CardSidePushButton *btn = static_cast<CardSidePushButton*>(QObject::sender());
+    const int side = m_cards.indexOf(btn->card());
+    removeCardSide(btn);
+
+    // Later sides and cards of the set move up by one
+    m_setRecords.remove(m_editedCard + side);
+    syncEditedCard();
+    m_journalRecorder->putRecords(m_setRecords, m_editedCard + side);
+    watchEditedCard();
+    indexCardSet();
+}
+
+void MainWindow::removeCardSide(CardSidePushButton *btn)
+{
     if (btn->card() == m_selectedCard) {
         // Select default front side. Frontside should not be deletable!
         selectCardSide(0);
     }
     m_cardSideButtons.remove(btn->side());
     m_cards.removeOne(btn->card());
+    m_journalRecorder->unwatch(btn->card());
+    m_searchIndex->unwatch(btn->card());
+    ui->widget_cardpreview->removeCard(btn->card());
     btn->deleteLater();
     if (m_cardSideButtons.size() < MAX_CARDSIDES) {
         ui->btn_addside->setEnabled(true);
@@ -680,6 +744,20 @@ void MainWindow::dialog_addcardside_accepted(QString text, int /*side*/)
     if (text.isEmpty()) return;
     if (m_cardSideButtons.size() >= MAX_CARDSIDES) return;
 
+    addCardside_dialog->setText("");
+    addCardSide(text);
+
+    // Following cards of the set move down by one
+    const int index = m_editedCard + m_cards.size() - 1;
+    m_setRecords.insert(index, CardRecord());
+    syncEditedCard();
+    m_journalRecorder->putRecords(m_setRecords, index);
+    watchEditedCard();
+    indexCardSet();
+}
+
+Card *MainWindow::addCardSide(const QString &text)
+{
     int new_side = m_cardSideButtons.lastKey() + 1;
 
     CardSidePushButton *btn = new CardSidePushButton(new_side, this);
@@ -690,7 +768,6 @@ void MainWindow::dialog_addcardside_accepted(QString text, int /*side*/)
     QObject::connect(btn, &CardSidePushButton::clicked, this, &MainWindow::clickedCardSide);
 
     int count = ui->frame_bottom_layout->count();
-    addCardside_dialog->setText("");
     ui->frame_bottom_layout->insertWidget(count-1, btn);
     m_cardSideButtons.insert(new_side, btn);
 
@@ -706,6 +783,7 @@ void MainWindow::dialog_addcardside_accepted(QString text, int /*side*/)
     if (m_cardSideButtons.size() >= MAX_CARDSIDES) {
         ui->btn_addside->setEnabled(false);
     }
+    return card;
 }
 
 void MainWindow::dialog_editcardside_accepted(QString text, int side)
@@ -999,8 +1077,221 @@ void MainWindow::on_actionOptions_triggered()
 
 void MainWindow::on_actionExport_as_PNG_triggered()
 {
-    // Save scene to file
-    ui->widget_cardpreview->saveToPNG("Card.png");
+    // Save scene to file, or one file per card
+    QSettings settings;
+    EncoderOptions options;
+    options.format = settings.value("export/format", "png").toString().toLatin1();
+    options.compression = settings.value("export/compression", 6).toInt();
+    options.quality = settings.value("export/quality", -1).toInt();
+    const bool splitCards = settings.value("export/splitcards", false).toBool();
+    ui->widget_cardpreview->exportImages("Card." + ImageEncoder::fileExtension(options.format), options, splitCards);
+}
+
+void MainWindow::on_action_Open_triggered()
+{
+    QString filename = QFileDialog::getOpenFileName(this, tr("Open card set"), m_cardSetPath, tr("Card sets (*.fows)"));
+    if (filename.isEmpty()) return;
+    openCardSet(filename);
+}
+
+void MainWindow::on_action_Find_card_triggered()
+{
+    bool ok = false;
+    const QString query = QInputDialog::getText(this, tr("Find card"), tr("Words, symbols or keywords the card contains:"), QLineEdit::Normal, QString(), &ok);
+    if (!ok || query.trimmed().isEmpty()) return;
+
+    const QVector<int> found = m_searchIndex->search(query);
+    if (found.isEmpty()) {
+        QMessageBox msg;
+        msg.setText(tr("No card contains '%1'.").arg(query));
+        msg.exec();
+        return;
+    }
+
+    // Names are taken from the records, they have to hold the edits of the current card
+    syncEditedCard();
+    const QString countryCode = m_languageModel->selectedLanguage()->countryCode();
+    QStringList items;
+    QVector<int> cards;
+    QVector<int>::const_iterator it = found.constBegin();
+    for (; it != found.constEnd(); ++it) {
+        // A card is listed once, by its front side
+        int first = *it;
+        while (first > 0 && m_setRecords.at(first).side != 0) first--;
+        if (cards.contains(first)) continue;
+        cards.append(first);
+        QString name = m_setRecords.at(first).cardName.text(countryCode);
+        items.append(tr("%1: %2").arg(cards.size()).arg(name.isEmpty() ? tr("(unnamed)") : name));
+    }
+
+    const QString item = QInputDialog::getItem(this, tr("Find card"), tr("Cards found:"), items, 0, false, &ok);
+    if (!ok) return;
+    const int first = cards.at(items.indexOf(item));
+    if (first == m_editedCard) return;
+    loadCard(first);
+    watchEditedCard();
+}
+
+void MainWindow::on_action_Save_triggered()
+{
+    if (m_cardSetPath.isEmpty()) {
+        on_actionSave_as_triggered();
+    } else {
+        saveCardSet(m_cardSetPath);
+    }
+}
+
+void MainWindow::on_actionSave_as_triggered()
+{
+    QString filename = QFileDialog::getSaveFileName(this, tr("Save card set"), m_cardSetPath, tr("Card sets (*.fows)"));
+    if (filename.isEmpty()) return;
+    if (saveCardSet(filename)) {
+        m_cardSetPath = filename;
+    }
+}
+
+/*!
+ * \brief Reads every side of the set and shows its first card in the editor.
+ * Changes left in the journal by a crashed session are replayed on top.
+ */
+bool MainWindow::openCardSet(const QString &filename)
+{
+    CardSetReader reader;
+    if (!reader.open(filename)) {
+        QMessageBox msg;
+        msg.setText(tr("Could not open card set '%1'. (%2)").arg(filename, reader.errorString()));
+        msg.exec();
+        return false;
+    }
+    QVector<CardRecord> records;
+    records.reserve(reader.cardCount());
+    for (int i = 0; i < reader.cardCount(); ++i) {
+        records.append(reader.card(i));
+    }
+    reader.close();
+    if (records.isEmpty()) {
+        QMessageBox msg;
+        msg.setText(tr("Card set '%1' has no cards.").arg(filename));
+        msg.exec();
+        return false;
+    }
+
+    // A journal with entries was left behind by a session that did not end cleanly
+    QVector<CardJournalEntry> entries;
+    CardSetJournal::readEntries(CardSetJournal::journalFilename(filename), entries);
+    QVector<CardJournalEntry>::const_iterator it = entries.constBegin();
+    for (; it != entries.constEnd(); ++it) {
+        it->applyTo(records);
+    }
+    if (records.isEmpty()) {
+        records.append(CardRecord());
+    }
+
+    // Edits of the previous set are in its journal already
+    m_journal->close();
+    m_setRecords = records;
+    m_setIds = CardSetFile::idTable();
+    m_editedCard = 0;
+    loadCard(0);
+
+    m_cardSetPath = filename;
+    // With recovery the entries are kept and folded into the set by the journal
+    m_journal->open(filename, !entries.isEmpty());
+    watchEditedCard();
+    indexCardSet();
+    if (!entries.isEmpty()) {
+        QMessageBox msg;
+        msg.setText(tr("Recovered %1 unsaved changes of card set '%2' from its journal.").arg(entries.size()).arg(filename));
+        msg.exec();
+    }
+    return true;
+}
+
+bool MainWindow::saveCardSet(const QString &filename)
+{
+    syncEditedCard();
+    CardSetWriter writer;
+    writer.addCards(m_setRecords);
+    if (!writer.write(filename)) {
+        QMessageBox msg;
+        msg.setText(tr("Could not save card set '%1'. (%2)").arg(filename, writer.errorString()));
+        msg.exec();
+        return false;
+    }
+
+    // From now on edits are appended to the journal instead of rewriting the set.
+    // The set holds every edit now, so the journal starts over empty.
+    m_journal->open(filename);
+    watchEditedCard();
+    return true;
+}
+
+/*!
+ * \brief Shows the card whose front side is at \a first in m_setRecords in the
+ * editor, with as many sides as it has. Edits of the current card have to be
+ * synced before.
+ */
+void MainWindow::loadCard(int first)
+{
+    int count = 1;
+    while (count < MAX_CARDSIDES && first + count < m_setRecords.size() && m_setRecords.at(first + count).side != 0) {
+        count++;
+    }
+
+    // Nothing of this is an edit of the set
+    QVector<Card*>::const_iterator it = m_cards.constBegin();
+    for (; it != m_cards.constEnd(); ++it) {
+        m_journalRecorder->unwatch(*it);
+        m_searchIndex->unwatch(*it);
+    }
+    const QList<int> sides = m_cardSideButtons.keys();
+    QList<int>::const_iterator sideIter = sides.constBegin();
+    for (; sideIter != sides.constEnd(); ++sideIter) {
+        if (*sideIter != 0) removeCardSide(m_cardSideButtons.value(*sideIter));
+    }
+    for (int i = 1; i < count; ++i) {
+        addCardSide(tr("Side %1").arg(i + 1));
+    }
+
+    m_editedCard = first;
+    for (int i = 0; i < count; ++i) {
+        m_setRecords.at(first + i).applyTo(m_cards[i]);
+        m_searchIndex->watch(first + i, m_cards[i]);
+    }
+    selectCardSide(0);
+    switchCard(0, true);
+}
+
+/*!
+ * \brief Rebuilds the search index after records of the set moved.
+ */
+void MainWindow::indexCardSet()
+{
+    m_searchIndex->clear();
+    for (int i = 0; i < m_setRecords.size(); ++i) {
+        m_searchIndex->setCard(i, m_setRecords.at(i));
+    }
+    for (int i = 0; i < m_cards.size(); ++i) {
+        m_searchIndex->watch(m_editedCard + i, m_cards[i]);
+    }
+}
+
+void MainWindow::syncEditedCard()
+{
+    for (int i = 0; i < m_cards.size(); ++i) {
+        CardRecord record = CardRecord::fromCard(m_cards.at(i));
+        record.side = quint8(i);
+        m_setRecords[m_editedCard + i] = record;
+    }
+}
+
+void MainWindow::watchEditedCard()
+{
+    if (!m_journal->isOpen()) return;
+    for (int i = 0; i < m_cards.size(); ++i) {
+        m_journalRecorder->watch(m_cards[i], m_editedCard + i, i);
+        m_journalRecorder->setIndex(m_cards[i], m_editedCard + i, i);
+    }
 }
 
 void MainWindow::on_btn_ability_text_add_clicked()
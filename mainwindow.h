@@ -18,7 +18,11 @@
 #include "models/fattributemodel.h"
 #include "models/fcardtypemodel.h"
 #include "models/fraritymodel.h"
+#include "models/fdatawatcher.h"
 #include "card.h"
+#include "cardset/cardsetfile.h"
+#include "cardset/cardsetjournal.h"
+#include "cardset/cardsearchindex.h"
 
 namespace Ui {
 class MainWindow;
@@ -41,7 +45,7 @@ public slots:
     void cardTypeChanged(int index);
     void generalCardTypeChanged(int index);
     void rarityChanged(int index);
-    void switchCard(int index = 0);
+    void switchCard(int index = 0, bool reload = false);
 
 private slots:
     void on_btn_trait_add_clicked();
@@ -73,6 +77,11 @@ private slots:
 
     void on_actionExport_as_PNG_triggered();
 
+    void on_action_Open_triggered();
+    void on_action_Find_card_triggered();
+    void on_action_Save_triggered();
+    void on_actionSave_as_triggered();
+
     void on_btn_ability_text_add_clicked();
     void on_btn_ability_text_edit_clicked();
     void on_btn_ability_text_remove_clicked();
@@ -88,7 +97,7 @@ private:
     FGeneralCardTypeModel *m_generalCardTypeModel;
     FCardTypeModel *m_cardTypeModel;
     FRarityModel *m_rarityModel;
-
+    FDataWatcher *m_dataWatcher;
 
     AddCardSideDialog *addCardside_dialog;
     LanguageStringEditDialog *m_lineEditDialog;
@@ -105,11 +114,20 @@ private:
 
     QVector<Card*> m_cards;
     Card* m_selectedCard;
+    QString m_cardSetPath;
+    QVector<CardRecord> m_setRecords; // Sides of every card in the set
+    CardSetFile::IdTable m_setIds; // String ids of the model ids in m_setRecords
+    int m_editedCard; // Index of the front side of the edited card in m_setRecords
+    CardSetJournal *m_journal;
+    CardJournalRecorder *m_journalRecorder;
+    CardSearchIndex *m_searchIndex; // Over m_setRecords, the edited card is watched
 
     void readSettings();
 
     void editCardSideName();
     void deleteCardSide();
+    Card *addCardSide(const QString &text);
+    void removeCardSide(CardSidePushButton *btn);
     void updateTraitButtonStates();
     void updateAbilityButtonStates();
     void updateTypeOptions();
@@ -118,6 +136,12 @@ private:
     void loadCardTypes(const Card *fromCard);
     void buildCardTypeComboBox(int indexCardType = 0, int indexGeneralCardType = 0, bool blockSignal = false);
     int getFirstUnusedCardType();
+    bool openCardSet(const QString &filename);
+    bool saveCardSet(const QString &filename);
+    void loadCard(int first);
+    void syncEditedCard();
+    void watchEditedCard();
+    void indexCardSet();
 };
 
 #endif // MAINWINDOW_H
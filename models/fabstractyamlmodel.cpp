@@ -1,12 +1,17 @@
+#include <algorithm>
+#include <yaml-cpp/yaml.h>
 #include "fabstractyamlmodel.h"
 
-FAbstractYAMLModel::FAbstractYAMLModel(QObject *parent) : QObject(parent), m_loading(false) {}
+FAbstractYAMLModel::FAbstractYAMLModel(QObject *parent) : QObject(parent), m_loading(false), m_strict(true) {}
 FAbstractYAMLModel::~FAbstractYAMLModel()
 {
     QVector<FAbstractObject*>::iterator it = m_vec.begin();
     for (; it != m_vec.end(); ++it) {
         delete (*it);
     }
+    for (it = m_removed.begin(); it != m_removed.end(); ++it) {
+        delete (*it);
+    }
 }
 
 /*void FAbstractYAMLModel::insert(const QString &key, const QVariant &value)
@@ -55,7 +60,7 @@ bool FAbstractYAMLModel::remove(const QString &key)
         FAbstractObject *value = m_data.value(key);
         m_data.remove(key);
         m_vec.remove(m_vec.indexOf(value));
-        delete value;
+        m_removed.append(value);
         if (!m_loading)
             emit dataDeleted(key);
         return true;
@@ -78,12 +83,104 @@ bool FAbstractYAMLModel::modify(const QString &key, FAbstractObject *value)
 {
     if (m_data.contains(key)) {
         FAbstractObject *old = m_data.value(key);
-        m_data[key] = value;
-        m_vec.replace(m_vec.indexOf(old), value);
-        delete old;
+        if (assignData(old, value)) {
+            delete value;
+        } else {
+            m_data[key] = value;
+            m_vec.replace(m_vec.indexOf(old), value);
+            m_removed.append(old);
+        }
         if (!m_loading)
             emit dataModified(key);
         return true;
     }
     return false;
 }
+
+/*!
+ * \brief Takes over the entries of a freshly parsed model of the same type.
+ *
+ * Only entries that were added, removed or differ in sameData() are passed
+ * to insert(), remove() and modify(), so the signals fire for real changes
+ * only. The ids are positions in YAMLFile(), m_vec is sorted by them again.
+ * Added entries come without texts, the caller loads them when this
+ * returns true.
+ */
+bool FAbstractYAMLModel::update(FAbstractYAMLModel *parsed)
+{
+    const QList<QString> keys = m_data.keys();
+    QList<QString>::const_iterator keyIter = keys.constBegin();
+    for (; keyIter != keys.constEnd(); ++keyIter) {
+        if (!parsed->m_data.contains(*keyIter)) remove(*keyIter);
+    }
+
+    bool inserted = false;
+    const QList<QString> parsedKeys = parsed->m_data.keys();
+    for (keyIter = parsedKeys.constBegin(); keyIter != parsedKeys.constEnd(); ++keyIter) {
+        const FAbstractObject *current = m_data.value(*keyIter);
+        if (!current) {
+            insert(*keyIter, parsed->take(*keyIter));
+            inserted = true;
+        } else if (!sameData(current, parsed->m_data.value(*keyIter))) {
+            modify(*keyIter, parsed->take(*keyIter));
+        }
+    }
+
+    std::sort(m_vec.begin(), m_vec.end(), [](const FAbstractObject *a, const FAbstractObject *b) { return a->id() < b->id(); });
+    return inserted;
+}
+
+/*!
+ * \brief Removes an entry without deleting it, the caller owns it afterwards.
+ */
+FAbstractObject *FAbstractYAMLModel::take(const QString &key)
+{
+    FAbstractObject *value = m_data.take(key);
+    if (value) m_vec.remove(m_vec.indexOf(value));
+    return value;
+}
+
+/*!
+ * \brief Loads texts of entries update() just added, for every language loaded so far.
+ */
+void FAbstractYAMLModel::reloadTexts()
+{
+    const QSet<QString> countryCodes = m_textCountryCodes;
+    QSet<QString>::const_iterator it = countryCodes.constBegin();
+    for (; it != countryCodes.constEnd(); ++it) {
+        YAML::Node node;
+        QString error;
+        if (!parseFile("data/text/" + *it + "/" + YAMLFile(), &node, &error) || !reloadText(*it, node)) {
+            qWarning(qUtf8Printable(QObject::tr("Could not load the texts of new entries from 'text/%1/%2'. (%3)").arg(*it, YAMLFile(), error.isEmpty() ? m_errorString : error)));
+        }
+    }
+}
+
+bool FAbstractYAMLModel::parseFile(const QString &path, YAML::Node *node, QString *errorString)
+{
+    try {
+        *node = YAML::LoadFile(path.toStdString());
+    } catch (YAML::Exception e) {
+        *errorString = QString::fromStdString(e.msg);
+        return false;
+    }
+    return true;
+}
+
+bool FAbstractYAMLModel::fail(const QString &error)
+{
+    if (m_strict) {
+        qFatal(qUtf8Printable(error));
+    }
+    if (m_errorString.isEmpty()) m_errorString = error;
+    return false;
+}
+
+void FAbstractYAMLModel::skipEntry(const QString &warning)
+{
+    if (m_strict) {
+        qWarning(qUtf8Printable(warning));
+    } else {
+        fail(warning);
+    }
+}
@@ -6,9 +6,12 @@
 #include <QMap>
 #include <QVector>
 #include <QVariant>
+#include <QSet>
 
 #include "fabstractobject.h"
 
+namespace YAML { class Node; }
+
 class FAbstractYAMLModel : public QObject
 {
     Q_OBJECT
@@ -18,8 +21,19 @@ public:
 
     void beginLoading() { m_loading = true; }
     void endLoading() { m_loading = false; }
+    bool isLoading() const { return m_loading; }
 
     virtual void load() = 0;
+    // Apply a data or text file parsed again, only the entries that differ
+    // are changed. A file with an invalid entry is rejected, see errorString().
+    virtual bool reload(const YAML::Node &node) { Q_UNUSED(node) return false; }
+    virtual void loadText(const QString &countryCode) { Q_UNUSED(countryCode) }
+    virtual bool reloadText(const QString &countryCode, const YAML::Node &node) { Q_UNUSED(countryCode) Q_UNUSED(node) return false; }
+    const QString errorString() const { return m_errorString; }
+
+    static bool parseFile(const QString &path, YAML::Node *node, QString *errorString); // Never fatal
+
+    const QSet<QString> &textCountryCodes() const { return m_textCountryCodes; }
     //virtual int dataCount() const { return m_data.size(); }
     virtual const QString YAMLFile() const = 0;
     //virtual void insert(const QString &key, const QVariant &value);
@@ -40,9 +54,26 @@ protected:
     //QMap<QString, QVariant> m_data;
     QHash<QString, FAbstractObject*> m_data;
     QVector<FAbstractObject*> m_vec;
+    QSet<QString> m_textCountryCodes;
+    QString m_errorString;
+
+    bool update(FAbstractYAMLModel *parsed); // True if entries were added
+    void reloadTexts(); // After update() added entries
+    // Problems of the file being parsed. Fatal on startup, while reloading
+    // they only reject the file and the current data stays.
+    void setStrict(bool strict) { m_strict = strict; }
+    bool fail(const QString &error);
+    void skipEntry(const QString &warning);
+    FAbstractObject *take(const QString &key);
+    // Compare and copy what YAMLFile() holds, without the texts. Models that
+    // implement them are modified in place, so pointers held by cards stay valid.
+    virtual bool sameData(const FAbstractObject *a, const FAbstractObject *b) const { Q_UNUSED(a) Q_UNUSED(b) return false; }
+    virtual bool assignData(FAbstractObject *target, const FAbstractObject *source) { Q_UNUSED(target) Q_UNUSED(source) return false; }
 
 private:
     bool m_loading;
+    bool m_strict;
+    QVector<FAbstractObject*> m_removed; // Cards may still point to them
 
 signals:
     void dataAdded(const QString &key);
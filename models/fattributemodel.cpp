@@ -13,12 +13,13 @@ FAttribute::~FAttribute()
     }
 }
 
-void FAttribute::addText(const QString &countryCode, FAttributeText *attributeText)
+bool FAttribute::addText(const QString &countryCode, FAttributeText *attributeText)
 {
-    if (m_text.contains(countryCode)) {
-        delete m_text[countryCode];
-    }
+    FAttributeText *old = m_text.value(countryCode);
+    const bool changed = !old || !(*old == *attributeText);
+    delete old;
     m_text.insert(countryCode, attributeText);
+    return changed;
 }
 
 void FAttribute::addCharacteristic(const QString &stringId)
@@ -32,6 +33,26 @@ void FAttribute::addCharacteristic(const QString &stringId)
     }
 }
 
+bool FAttribute::sameData(const FAttribute &other) const
+{
+    return m_id == other.m_id && m_stringId == other.m_stringId && m_iconPath == other.m_iconPath
+            && m_color == other.m_color && m_color2 == other.m_color2 && m_exclusive == other.m_exclusive
+            && m_generic == other.m_generic && m_maxCost == other.m_maxCost && m_characteristics == other.m_characteristics;
+}
+
+void FAttribute::setData(const FAttribute &other)
+{
+    m_id = other.m_id;
+    m_stringId = other.m_stringId;
+    m_iconPath = other.m_iconPath;
+    m_color = other.m_color;
+    m_color2 = other.m_color2;
+    m_exclusive = other.m_exclusive;
+    m_generic = other.m_generic;
+    m_maxCost = other.m_maxCost;
+    m_characteristics = other.m_characteristics;
+}
+
 const QString FAttribute::shortName() const
 {
     const FLanguageModel *languageModel = FLanguageModel::Instance();
@@ -109,6 +130,53 @@ FAttributeModel::FAttributeModel(QObject *parent) : FAbstractYAMLModel(parent)
     endLoading();
 }
 
+FAttributeModel::FAttributeModel(const YAML::Node &node) : FAbstractYAMLModel(nullptr)
+{
+    m_defaultAttribute = nullptr;
+    setStrict(false);
+    beginLoading();
+    parse(node);
+    endLoading();
+}
+
+bool FAttributeModel::reload(const YAML::Node &node)
+{
+    FAttributeModel parsed(node);
+    if (!parsed.errorString().isEmpty()) {
+        m_errorString = parsed.errorString();
+        return false;
+    }
+    const QString defaultId = parsed.defaultAttribute()->stringId();
+    const bool inserted = update(&parsed);
+    m_defaultAttribute = value_p(defaultId);
+
+    // New entries come without texts
+    if (inserted) {
+        reloadTexts();
+    }
+    return true;
+}
+
+bool FAttributeModel::reloadText(const QString &countryCode, const YAML::Node &node)
+{
+    m_errorString.clear();
+    setStrict(false);
+    const bool parsed = parseText(countryCode, node);
+    setStrict(true);
+    return parsed;
+}
+
+bool FAttributeModel::sameData(const FAbstractObject *a, const FAbstractObject *b) const
+{
+    return static_cast<const FAttribute*>(a)->sameData(*static_cast<const FAttribute*>(b));
+}
+
+bool FAttributeModel::assignData(FAbstractObject *target, const FAbstractObject *source)
+{
+    static_cast<FAttribute*>(target)->setData(*static_cast<const FAttribute*>(source));
+    return true;
+}
+
 void FAttributeModel::load()
 {
     YAML::Node node;
@@ -120,13 +188,16 @@ void FAttributeModel::load()
         qFatal(e.msg.data());
     }
 
+    parse(node);
+}
+
+bool FAttributeModel::parse(const YAML::Node &node)
+{
     if (!node.IsSequence()) {
-        qFatal(qUtf8Printable((QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"))));
-        return;
+        return fail(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"));
     }
     if (node.size() == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Attribute"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Attribute"), m_yamlFile));
     }
 
     m_vec.reserve(int(node.size()));
@@ -136,13 +207,13 @@ void FAttributeModel::load()
     YAML::const_iterator it;
     for (it = node.begin(); it != node.end(); ++it) {
         if (!it->IsMap()) {
-            qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map")));
+            skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map"));
             continue;
         }
         try {
             const YAML::Node& attributeNode = *it;
             if (!attributeNode["Id"] || !attributeNode["Id"].IsScalar()) {
-                qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar")));
+                skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar"));
                 continue;
             }
 
@@ -223,15 +294,13 @@ void FAttributeModel::load()
             i++;
 
         } catch (YAML::Exception e) {
-            qFatal(e.msg.data());
-            return;
+            return fail(QString::fromStdString(e.msg));
         }
     }
 
     // Entries exist, but none were valid
     if (i == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Attribute"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Attribute"), m_yamlFile));
     }
 
     if (!m_defaultAttribute) {
@@ -239,6 +308,7 @@ void FAttributeModel::load()
         FAttribute *attribute = static_cast<FAttribute*>(dataVec()->first());
         m_defaultAttribute = attribute;
     }
+    return true;
 }
 
 void FAttributeModel::loadText(const QString &countryCode)
@@ -253,27 +323,34 @@ void FAttributeModel::loadText(const QString &countryCode)
         qFatal(e.msg.data());
     }
 
+    parseText(countryCode, node);
+}
+
+bool FAttributeModel::parseText(const QString &countryCode, const YAML::Node &node)
+{
+    m_textCountryCodes.insert(countryCode);
+
     if (!node.IsSequence()) {
-        qFatal(qUtf8Printable((QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"))));
-        return;
+        return fail(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"));
     }
     if (node.size() == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Attribute"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Attribute"), m_yamlFile));
     }
 
+    // Applied once the whole file is valid, a rejected file leaves the current texts
+    QHash<QString, FAttributeText*> texts;
     int i = 0;
 
     YAML::const_iterator it;
     for (it = node.begin(); it != node.end(); ++it) {
         if (!it->IsMap()) {
-            qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map")));
+            skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map"));
             continue;
         }
         try {
             const YAML::Node& textNode = *it;
             if (!textNode["Id"] || !textNode["Id"].IsScalar()) {
-                qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar")));
+                skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar"));
                 continue;
             }
 
@@ -300,24 +377,34 @@ void FAttributeModel::loadText(const QString &countryCode)
 
             FAttributeText *attributeText = new FAttributeText(shortName, name, altName);
 
-            FAttribute *attribute = value_p(textId);
-            if (attribute) {
-                attribute->addText(countryCode, attributeText);
-            }
+            delete texts.value(textId);
+            texts.insert(textId, attributeText);
 
             i++;
 
         } catch (YAML::Exception e) {
-            qFatal(e.msg.data());
-            return;
+            qDeleteAll(texts);
+            return fail(QString::fromStdString(e.msg));
         }
     }
 
     // Entries exist, but none were valid
     if (i == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Attribute"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Attribute"), m_yamlFile));
+    }
+    if (!m_errorString.isEmpty()) {
+        qDeleteAll(texts);
+        return false;
+    }
+
+    QHash<QString, FAttributeText*>::const_iterator textIter = texts.constBegin();
+    for (; textIter != texts.constEnd(); ++textIter) {
+        FAttribute *attribute = value_p(textIter.key());
+        if (attribute->addText(countryCode, textIter.value()) && !isLoading()) {
+            emit dataModified(textIter.key());
+        }
     }
+    return true;
 }
 
 const FAttribute *FAttributeModel::get(const QString &stringId) const
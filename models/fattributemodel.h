@@ -18,6 +18,8 @@ public:
     const QString name() const { return m_name; }
     const QString altName() const { return m_alt; }
 
+    bool operator==(const FAttributeText &other) const { return m_short == other.m_short && m_name == other.m_name && m_alt == other.m_alt; }
+
 private:
     QString m_short;
     QString m_name;
@@ -32,13 +34,16 @@ public:
         : FAbstractObject(id), m_stringId(stringId), m_iconPath(iconPath), m_color(color), m_color2(color2), m_exclusive(exclusive), m_generic(generic), m_maxCost(maxCost) {}
     ~FAttribute();
 
-    void addText(const QString &countryCode, FAttributeText *attributeText);
+    bool addText(const QString &countryCode, FAttributeText *attributeText); // True if the text changed
     void addCharacteristic(const QString &stringId);
+    bool sameData(const FAttribute &other) const;
+    void setData(const FAttribute &other);
 
     const QString iconPath() const { return m_iconPath; }
     const QString stringId() const { return m_stringId; }
     const QColor color() const { return m_color; }
     const QColor color2() const { return m_color2; }
+    bool hasText(const QString &countryCode) const { return m_text.contains(countryCode); }
 
     const QString shortName() const;
     const QString shortName(const QString &countryCode) const;
@@ -75,15 +80,25 @@ public:
 
     explicit FAttributeModel(QObject *parent = nullptr);
 
-    void loadText(const QString &countryCode);
+    void loadText(const QString &countryCode) override;
     const FAttribute* get(const QString &stringId) const;
     const FAttribute* get(int id) const;
     const FAttribute* defaultAttribute() const { return m_defaultAttribute; }
 
     void load() override;
+    bool reload(const YAML::Node &node) override;
+    bool reloadText(const QString &countryCode, const YAML::Node &node) override;
     const QString YAMLFile() const override { return m_yamlFile; }
 
+protected:
+    bool sameData(const FAbstractObject *a, const FAbstractObject *b) const override;
+    bool assignData(FAbstractObject *target, const FAbstractObject *source) override;
+
 private:
+    explicit FAttributeModel(const YAML::Node &node); // A file being reloaded, problems are not fatal
+    bool parse(const YAML::Node &node);
+    bool parseText(const QString &countryCode, const YAML::Node &node);
+
     static const FAttributeModel *m_instance;
     const QString m_yamlFile = "Attributes.yaml";
     FAttribute *m_defaultAttribute;
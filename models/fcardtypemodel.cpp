@@ -25,12 +25,29 @@ FCardType::~FCardType()
     }
 }
 
-void FCardType::addText(const QString &countryCode, FCardTypeText *cardTypeText)
+bool FCardType::addText(const QString &countryCode, FCardTypeText *cardTypeText)
 {
-    if (m_text.contains(countryCode)) {
-        delete m_text[countryCode];
-    }
+    FCardTypeText *old = m_text.value(countryCode);
+    const bool changed = !old || !(*old == *cardTypeText);
+    delete old;
     m_text.insert(countryCode, cardTypeText);
+    return changed;
+}
+
+bool FCardType::sameData(const FCardType &other) const
+{
+    return m_id == other.m_id && m_stringId == other.m_stringId && m_canFight == other.m_canFight
+            && m_hasDivinity == other.m_hasDivinity && m_hasCost == other.m_hasCost && m_generalCardTypes == other.m_generalCardTypes;
+}
+
+void FCardType::setData(const FCardType &other)
+{
+    m_id = other.m_id;
+    m_stringId = other.m_stringId;
+    m_canFight = other.m_canFight;
+    m_hasDivinity = other.m_hasDivinity;
+    m_hasCost = other.m_hasCost;
+    m_generalCardTypes = other.m_generalCardTypes;
 }
 
 void FCardType::addGeneralCardType(const QString &stringId)
@@ -114,6 +131,49 @@ FCardTypeModel::FCardTypeModel(QObject *parent) : FAbstractYAMLModel(parent)
     endLoading();
 }
 
+FCardTypeModel::FCardTypeModel(const YAML::Node &node) : FAbstractYAMLModel(nullptr)
+{
+    setStrict(false);
+    beginLoading();
+    parse(node);
+    endLoading();
+}
+
+bool FCardTypeModel::reload(const YAML::Node &node)
+{
+    FCardTypeModel parsed(node);
+    if (!parsed.errorString().isEmpty()) {
+        m_errorString = parsed.errorString();
+        return false;
+    }
+
+    // New entries come without texts
+    if (update(&parsed)) {
+        reloadTexts();
+    }
+    return true;
+}
+
+bool FCardTypeModel::reloadText(const QString &countryCode, const YAML::Node &node)
+{
+    m_errorString.clear();
+    setStrict(false);
+    const bool parsed = parseText(countryCode, node);
+    setStrict(true);
+    return parsed;
+}
+
+bool FCardTypeModel::sameData(const FAbstractObject *a, const FAbstractObject *b) const
+{
+    return static_cast<const FCardType*>(a)->sameData(*static_cast<const FCardType*>(b));
+}
+
+bool FCardTypeModel::assignData(FAbstractObject *target, const FAbstractObject *source)
+{
+    static_cast<FCardType*>(target)->setData(*static_cast<const FCardType*>(source));
+    return true;
+}
+
 void FCardTypeModel::load()
 {
     YAML::Node node;
@@ -125,13 +185,16 @@ void FCardTypeModel::load()
         qFatal(e.msg.data());
     }
 
+    parse(node);
+}
+
+bool FCardTypeModel::parse(const YAML::Node &node)
+{
     if (!node.IsSequence()) {
-        qFatal(qUtf8Printable((QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"))));
-        return;
+        return fail(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"));
     }
     if (node.size() == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Card Type"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Card Type"), m_yamlFile));
     }
 
     m_vec.reserve(int(node.size()));
@@ -141,13 +204,13 @@ void FCardTypeModel::load()
     YAML::const_iterator it;
     for (it = node.begin(); it != node.end(); ++it) {
         if (!it->IsMap()) {
-            qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map")));
+            skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map"));
             continue;
         }
         try {
             const YAML::Node& cardTypeNode = *it;
             if (!cardTypeNode["Id"] || !cardTypeNode["Id"].IsScalar()) {
-                qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar")));
+                skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar"));
                 continue;
             }
 
@@ -187,16 +250,15 @@ void FCardTypeModel::load()
             i++;
 
         } catch (YAML::Exception e) {
-            qFatal(e.msg.data());
-            return;
+            return fail(QString::fromStdString(e.msg));
         }
     }
 
     // Entries exist, but none were valid
     if (i == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Will Characteristic"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Will Characteristic"), m_yamlFile));
     }
+    return true;
 }
 
 void FCardTypeModel::loadText(const QString &countryCode)
@@ -211,27 +273,34 @@ void FCardTypeModel::loadText(const QString &countryCode)
         qFatal(e.msg.data());
     }
 
+    parseText(countryCode, node);
+}
+
+bool FCardTypeModel::parseText(const QString &countryCode, const YAML::Node &node)
+{
+    m_textCountryCodes.insert(countryCode);
+
     if (!node.IsSequence()) {
-        qFatal(qUtf8Printable((QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"))));
-        return;
+        return fail(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"));
     }
     if (node.size() == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Attribute"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Attribute"), m_yamlFile));
     }
 
+    // Applied once the whole file is valid, a rejected file leaves the current texts
+    QHash<QString, FCardTypeText*> texts;
     int i = 0;
 
     YAML::const_iterator it;
     for (it = node.begin(); it != node.end(); ++it) {
         if (!it->IsMap()) {
-            qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map")));
+            skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map"));
             continue;
         }
         try {
             const YAML::Node& textNode = *it;
             if (!textNode["Id"] || !textNode["Id"].IsScalar()) {
-                qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar")));
+                skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar"));
                 continue;
             }
 
@@ -265,24 +334,34 @@ void FCardTypeModel::loadText(const QString &countryCode)
                 }
             }
 
-            FCardType *cardType = value_p(textId);
-            if (cardType) {
-                cardType->addText(countryCode, cardTypeText);
-            }
+            delete texts.value(textId);
+            texts.insert(textId, cardTypeText);
 
             i++;
 
         } catch (YAML::Exception e) {
-            qFatal(e.msg.data());
-            return;
+            qDeleteAll(texts);
+            return fail(QString::fromStdString(e.msg));
         }
     }
 
     // Entries exist, but none were valid
     if (i == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Card Type"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Card Type"), m_yamlFile));
+    }
+    if (!m_errorString.isEmpty()) {
+        qDeleteAll(texts);
+        return false;
+    }
+
+    QHash<QString, FCardTypeText*>::const_iterator textIter = texts.constBegin();
+    for (; textIter != texts.constEnd(); ++textIter) {
+        FCardType *cardType = value_p(textIter.key());
+        if (cardType->addText(countryCode, textIter.value()) && !isLoading()) {
+            emit dataModified(textIter.key());
+        }
     }
+    return true;
 }
 
 const FCardType *FCardTypeModel::get(const QString &stringId) const
@@ -14,6 +14,8 @@ public:
     const QString name() const { return m_name; }
     const QString name(const QString &generalCardTypeId);
 
+    bool operator==(const FCardTypeText &other) const { return m_name == other.m_name && m_combinedName == other.m_combinedName; }
+
     void addCombinedName(const QString &typeId, const QString &name);
 private:
     QString m_name;
@@ -28,13 +30,16 @@ public:
         : FAbstractObject(id), m_stringId(stringId), m_canFight(canFight), m_hasDivinity(hasDivinity), m_hasCost(hasCost) {}
     ~FCardType();
 
-    void addText(const QString &countryCode, FCardTypeText *cardTypeText);
+    bool addText(const QString &countryCode, FCardTypeText *cardTypeText); // True if the text changed
     void addGeneralCardType(const QString &stringId);
+    bool sameData(const FCardType &other) const;
+    void setData(const FCardType &other);
 
     const QString stringId() const { return m_stringId; }
     bool canFight() const { return m_canFight; }
     bool hasDivinity() const { return m_hasDivinity; }
     bool hasCost() const { return m_hasCost; }
+    bool hasText(const QString &countryCode) const { return m_text.contains(countryCode); }
 
     const QString name() const;
     const QString name(const QString &countryCode) const;
@@ -61,14 +66,24 @@ public:
 
     explicit FCardTypeModel(QObject *parent = nullptr);
 
-    void loadText(const QString &countryCode);
+    void loadText(const QString &countryCode) override;
     const FCardType* get(const QString &stringId) const;
     const FCardType* get(int id) const;
 
     void load() override;
+    bool reload(const YAML::Node &node) override;
+    bool reloadText(const QString &countryCode, const YAML::Node &node) override;
     const QString YAMLFile() const override { return m_yamlFile; }
 
+protected:
+    bool sameData(const FAbstractObject *a, const FAbstractObject *b) const override;
+    bool assignData(FAbstractObject *target, const FAbstractObject *source) override;
+
 private:
+    explicit FCardTypeModel(const YAML::Node &node); // A file being reloaded, problems are not fatal
+    bool parse(const YAML::Node &node);
+    bool parseText(const QString &countryCode, const YAML::Node &node);
+
     static const FCardTypeModel *m_instance;
     const QString m_yamlFile = "CardTypes.yaml";
 
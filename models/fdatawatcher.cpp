@@ -0,0 +1,79 @@
+#include <yaml-cpp/yaml.h>
+#include <QFileInfo>
+#include <QDir>
+
+#include "fdatawatcher.h"
+#include "fabstractyamlmodel.h"
+
+FDataWatcher::FDataWatcher(QObject *parent) : QObject(parent)
+{
+    m_watcher = new QFileSystemWatcher(this);
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(DATA_WATCHER_DELAY);
+
+    QObject::connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &FDataWatcher::fileChanged);
+    QObject::connect(&m_timer, &QTimer::timeout, this, &FDataWatcher::reloadChanged);
+}
+
+void FDataWatcher::addModel(FAbstractYAMLModel *model)
+{
+    if (!model || m_models.contains(model)) return;
+    m_models.append(model);
+
+    QStringList paths;
+    paths.append(QFileInfo("data/" + model->YAMLFile()).absoluteFilePath());
+    QSet<QString>::const_iterator it = model->textCountryCodes().constBegin();
+    for (; it != model->textCountryCodes().constEnd(); ++it) {
+        paths.append(QFileInfo("data/text/" + *it + "/" + model->YAMLFile()).absoluteFilePath());
+    }
+    m_watcher->addPaths(paths);
+}
+
+void FDataWatcher::fileChanged(const QString &path)
+{
+    m_changed.insert(path);
+    m_timer.start();
+}
+
+void FDataWatcher::reloadChanged()
+{
+    const QSet<QString> changed = m_changed;
+    m_changed.clear();
+
+    bool reloaded = false;
+    QVector<FAbstractYAMLModel*>::const_iterator modelIter = m_models.constBegin();
+    for (; modelIter != m_models.constEnd(); ++modelIter) {
+        FAbstractYAMLModel *model = *modelIter;
+        QSet<QString>::const_iterator it = changed.constBegin();
+        for (; it != changed.constEnd(); ++it) {
+            const QFileInfo info(*it);
+            if (info.fileName() != model->YAMLFile()) continue;
+
+            // Saving by replacing the file drops it from the watcher
+            if (info.exists() && !m_watcher->files().contains(*it)) {
+                m_watcher->addPath(*it);
+            }
+
+            // Parsed once and handed to the model, which rejects it if any entry is invalid
+            YAML::Node node;
+            QString error;
+            bool applied = FAbstractYAMLModel::parseFile(*it, &node, &error);
+            if (applied) {
+                const QDir dir = info.dir();
+                if (QFileInfo(dir.path()).dir().dirName() == "text") {
+                    applied = model->reloadText(dir.dirName(), node);
+                } else {
+                    applied = model->reload(node);
+                }
+                if (!applied) error = model->errorString();
+            }
+            if (!applied) {
+                // A file saved halfway keeps the current data
+                qWarning(qUtf8Printable(QObject::tr("Not reloading '%1'. (%2)").arg(*it, error)));
+                continue;
+            }
+            reloaded = true;
+        }
+    }
+    if (reloaded) emit modelsReloaded();
+}
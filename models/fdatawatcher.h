@@ -0,0 +1,49 @@
+#ifndef FDATAWATCHER_H
+#define FDATAWATCHER_H
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QVector>
+#include <QSet>
+
+class FAbstractYAMLModel;
+
+#define DATA_WATCHER_DELAY 200 // msecs, editors save a file in several steps
+
+/*!
+ * \brief Reloads the data files of the models while the application runs.
+ *
+ * Changed files are collected for DATA_WATCHER_DELAY and parsed once, then
+ * only the model owning a file applies it: reload() for "data/<file>" and
+ * reloadText() for "data/text/<cc>/<file>". A file with any invalid entry
+ * is rejected and the current data stays. The models emit
+ * dataAdded(), dataModified() and dataDeleted() for the entries that really
+ * changed, modelsReloaded() follows once per batch.
+ *
+ * Models are reloaded in the order they were added, add them in the order
+ * they are constructed since they look each other up through Instance().
+ */
+class FDataWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FDataWatcher(QObject *parent = nullptr);
+
+    void addModel(FAbstractYAMLModel *model);
+
+signals:
+    void modelsReloaded();
+
+private slots:
+    void fileChanged(const QString &path);
+    void reloadChanged();
+
+private:
+    QFileSystemWatcher *m_watcher;
+    QTimer m_timer;
+    QVector<FAbstractYAMLModel*> m_models;
+    QSet<QString> m_changed;
+};
+
+#endif // FDATAWATCHER_H
@@ -12,12 +12,24 @@ FGeneralCardType::~FGeneralCardType()
     }
 }
 
-void FGeneralCardType::addText(const QString &countryCode, FGeneralCardTypeText *text)
+bool FGeneralCardType::addText(const QString &countryCode, FGeneralCardTypeText *text)
 {
-    if (m_text.contains(countryCode)) {
-        delete m_text[countryCode];
-    }
+    FGeneralCardTypeText *old = m_text.value(countryCode);
+    const bool changed = !old || !(*old == *text);
+    delete old;
     m_text.insert(countryCode, text);
+    return changed;
+}
+
+bool FGeneralCardType::sameData(const FGeneralCardType &other) const
+{
+    return m_id == other.m_id && m_stringId == other.m_stringId;
+}
+
+void FGeneralCardType::setData(const FGeneralCardType &other)
+{
+    m_id = other.m_id;
+    m_stringId = other.m_stringId;
 }
 
 const QString FGeneralCardType::name() const
@@ -54,6 +66,49 @@ FGeneralCardTypeModel::FGeneralCardTypeModel(QObject *parent) : FAbstractYAMLMod
     endLoading();
 }
 
+FGeneralCardTypeModel::FGeneralCardTypeModel(const YAML::Node &node) : FAbstractYAMLModel(nullptr)
+{
+    setStrict(false);
+    beginLoading();
+    parse(node);
+    endLoading();
+}
+
+bool FGeneralCardTypeModel::reload(const YAML::Node &node)
+{
+    FGeneralCardTypeModel parsed(node);
+    if (!parsed.errorString().isEmpty()) {
+        m_errorString = parsed.errorString();
+        return false;
+    }
+
+    // New entries come without texts
+    if (update(&parsed)) {
+        reloadTexts();
+    }
+    return true;
+}
+
+bool FGeneralCardTypeModel::reloadText(const QString &countryCode, const YAML::Node &node)
+{
+    m_errorString.clear();
+    setStrict(false);
+    const bool parsed = parseText(countryCode, node);
+    setStrict(true);
+    return parsed;
+}
+
+bool FGeneralCardTypeModel::sameData(const FAbstractObject *a, const FAbstractObject *b) const
+{
+    return static_cast<const FGeneralCardType*>(a)->sameData(*static_cast<const FGeneralCardType*>(b));
+}
+
+bool FGeneralCardTypeModel::assignData(FAbstractObject *target, const FAbstractObject *source)
+{
+    static_cast<FGeneralCardType*>(target)->setData(*static_cast<const FGeneralCardType*>(source));
+    return true;
+}
+
 void FGeneralCardTypeModel::load()
 {
     YAML::Node node;
@@ -65,13 +120,16 @@ void FGeneralCardTypeModel::load()
         qFatal(e.msg.data());
     }
 
+    parse(node);
+}
+
+bool FGeneralCardTypeModel::parse(const YAML::Node &node)
+{
     if (!node.IsSequence()) {
-        qFatal(qUtf8Printable((QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"))));
-        return;
+        return fail(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"));
     }
     if (node.size() == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("General Card Type"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("General Card Type"), m_yamlFile));
     }
 
     m_vec.reserve(int(node.size()));
@@ -81,13 +139,13 @@ void FGeneralCardTypeModel::load()
     YAML::const_iterator it;
     for (it = node.begin(); it != node.end(); ++it) {
         if (!it->IsMap()) {
-            qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map")));
+            skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map"));
             continue;
         }
         try {
             const YAML::Node& generalCardTypeNode = *it;
             if (!generalCardTypeNode["Id"] || !generalCardTypeNode["Id"].IsScalar()) {
-                qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar")));
+                skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar"));
                 continue;
             }
 
@@ -99,16 +157,15 @@ void FGeneralCardTypeModel::load()
             i++;
 
         } catch (YAML::Exception e) {
-            qFatal(e.msg.data());
-            return;
+            return fail(QString::fromStdString(e.msg));
         }
     }
 
     // Entries exist, but none were valid
     if (i == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("General Card Type"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("General Card Type"), m_yamlFile));
     }
+    return true;
 }
 
 void FGeneralCardTypeModel::loadText(const QString &countryCode)
@@ -123,27 +180,34 @@ void FGeneralCardTypeModel::loadText(const QString &countryCode)
         qFatal(e.msg.data());
     }
 
+    parseText(countryCode, node);
+}
+
+bool FGeneralCardTypeModel::parseText(const QString &countryCode, const YAML::Node &node)
+{
+    m_textCountryCodes.insert(countryCode);
+
     if (!node.IsSequence()) {
-        qFatal(qUtf8Printable((QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"))));
-        return;
+        return fail(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"));
     }
     if (node.size() == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("General Card Type"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("General Card Type"), m_yamlFile));
     }
 
+    // Applied once the whole file is valid, a rejected file leaves the current texts
+    QHash<QString, FGeneralCardTypeText*> texts;
     int i = 0;
 
     YAML::const_iterator it;
     for (it = node.begin(); it != node.end(); ++it) {
         if (!it->IsMap()) {
-            qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map")));
+            skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map"));
             continue;
         }
         try {
             const YAML::Node& textNode = *it;
             if (!textNode["Id"] || !textNode["Id"].IsScalar()) {
-                qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar")));
+                skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar"));
                 continue;
             }
 
@@ -160,24 +224,34 @@ void FGeneralCardTypeModel::loadText(const QString &countryCode)
 
             FGeneralCardTypeText *generalCardTypeText = new FGeneralCardTypeText(name);
 
-            FGeneralCardType *generalCardType = value_p(textId);
-            if (generalCardType) {
-                generalCardType->addText(countryCode, generalCardTypeText);
-            }
+            delete texts.value(textId);
+            texts.insert(textId, generalCardTypeText);
 
             i++;
 
         } catch (YAML::Exception e) {
-            qFatal(e.msg.data());
-            return;
+            qDeleteAll(texts);
+            return fail(QString::fromStdString(e.msg));
         }
     }
 
     // Entries exist, but none were valid
     if (i == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("General Card Type"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("General Card Type"), m_yamlFile));
+    }
+    if (!m_errorString.isEmpty()) {
+        qDeleteAll(texts);
+        return false;
+    }
+
+    QHash<QString, FGeneralCardTypeText*>::const_iterator textIter = texts.constBegin();
+    for (; textIter != texts.constEnd(); ++textIter) {
+        FGeneralCardType *generalCardType = value_p(textIter.key());
+        if (generalCardType->addText(countryCode, textIter.value()) && !isLoading()) {
+            emit dataModified(textIter.key());
+        }
     }
+    return true;
 }
 
 const FGeneralCardType *FGeneralCardTypeModel::get(const QString &stringId) const
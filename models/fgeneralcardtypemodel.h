@@ -12,6 +12,8 @@ public:
 
     const QString name() const { return m_name; }
 
+    bool operator==(const FGeneralCardTypeText &other) const { return m_name == other.m_name; }
+
 private:
     QString m_name;
 };
@@ -23,9 +25,12 @@ public:
     FGeneralCardType(int id, const QString &stringId) : FAbstractObject(id), m_stringId(stringId) {}
     ~FGeneralCardType();
 
-    void addText(const QString &countryCode, FGeneralCardTypeText *text);
+    bool addText(const QString &countryCode, FGeneralCardTypeText *text); // True if the text changed
+    bool sameData(const FGeneralCardType &other) const;
+    void setData(const FGeneralCardType &other);
 
     const QString stringId() const { return m_stringId; }
+    bool hasText(const QString &countryCode) const { return m_text.contains(countryCode); }
     const QString name() const;
     const QString name(const QString &countryCode) const;
 
@@ -42,14 +47,24 @@ public:
 
     explicit FGeneralCardTypeModel(QObject *parent = nullptr);
 
-    void loadText(const QString &countryCode);
+    void loadText(const QString &countryCode) override;
     const FGeneralCardType* get(const QString &stringId) const;
     const FGeneralCardType* get(int id) const;
 
     void load() override;
+    bool reload(const YAML::Node &node) override;
+    bool reloadText(const QString &countryCode, const YAML::Node &node) override;
     const QString YAMLFile() const override { return m_yamlFile; }
 
+protected:
+    bool sameData(const FAbstractObject *a, const FAbstractObject *b) const override;
+    bool assignData(FAbstractObject *target, const FAbstractObject *source) override;
+
 private:
+    explicit FGeneralCardTypeModel(const YAML::Node &node); // A file being reloaded, problems are not fatal
+    bool parse(const YAML::Node &node);
+    bool parseText(const QString &countryCode, const YAML::Node &node);
+
     static const FGeneralCardTypeModel *m_instance;
     const QString m_yamlFile = "GeneralCardTypes.yaml";
 
@@ -124,3 +124,21 @@ void FLanguageString::updateFilledOut()
     }
     d->filledOut = filled_out;
 }
+
+QDataStream &operator<<(QDataStream &out, const FLanguageString &string)
+{
+    out << *string.data();
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, FLanguageString &string)
+{
+    QHash<QString, QString> data;
+    in >> data;
+    string = FLanguageString(FLanguageModel::Instance());
+    QHash<QString, QString>::const_iterator it = data.constBegin();
+    for (; it != data.constEnd(); ++it) {
+        string.setText(it.key(), it.value());
+    }
+    return in;
+}
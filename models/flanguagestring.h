@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QMap>
+#include <QDataStream>
 
 #include "flanguagemodel.h"
 
@@ -48,6 +49,9 @@ private:
 Q_DECLARE_METATYPE(FLanguageString);
 Q_DECLARE_METATYPE(FLanguageString*);
 
+QDataStream &operator<<(QDataStream &out, const FLanguageString &string);
+QDataStream &operator>>(QDataStream &in, FLanguageString &string);
+
 /*class FLanguageString
 {
 public:
@@ -0,0 +1,44 @@
+#include <QSettings>
+#include "fmodels.h"
+#include "flanguagemodel.h"
+#include "fwillcharacteristicmodel.h"
+#include "fattributemodel.h"
+#include "fgeneralcardtypemodel.h"
+#include "fcardtypemodel.h"
+#include "fraritymodel.h"
+
+FModels::FModels(QObject *parent) : QObject(parent)
+{
+    // Same order as MainWindow, the models look each other up through Instance()
+    m_languageModel = new FLanguageModel(this);
+    FLanguageModel::SetInstance(m_languageModel);
+    QSettings settings;
+    m_languageModel->selectLanguage(settings.value("main/selected_language").toString());
+
+    m_characteristicModel = new FWillCharacteristicModel(this);
+    FWillCharacteristicModel::SetInstance(m_characteristicModel);
+    m_attributeModel = new FAttributeModel(this);
+    FAttributeModel::SetInstance(m_attributeModel);
+    m_generalCardTypeModel = new FGeneralCardTypeModel(this);
+    FGeneralCardTypeModel::SetInstance(m_generalCardTypeModel);
+    m_cardTypeModel = new FCardTypeModel(this);
+    FCardTypeModel::SetInstance(m_cardTypeModel);
+    m_rarityModel = new FRarityModel(this);
+    FRarityModel::SetInstance(m_rarityModel);
+}
+
+void FModels::loadAllTexts()
+{
+    const QString defaultCountryCode = m_languageModel->defaultLanguage()->countryCode();
+    const QString selectedCountryCode = m_languageModel->selectedLanguage()->countryCode();
+    QVector<FAbstractObject*>::const_iterator it = m_languageModel->dataVec()->constBegin();
+    for (; it != m_languageModel->dataVec()->constEnd(); ++it) {
+        const QString countryCode = static_cast<const FLanguage*>(*it)->countryCode();
+        if (countryCode == defaultCountryCode || countryCode == selectedCountryCode) continue;
+        m_characteristicModel->loadText(countryCode);
+        m_attributeModel->loadText(countryCode);
+        m_generalCardTypeModel->loadText(countryCode);
+        m_cardTypeModel->loadText(countryCode);
+        m_rarityModel->loadText(countryCode);
+    }
+}
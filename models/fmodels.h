@@ -0,0 +1,41 @@
+#ifndef FMODELS_H
+#define FMODELS_H
+
+#include <QObject>
+
+class FLanguageModel;
+class FWillCharacteristicModel;
+class FAttributeModel;
+class FGeneralCardTypeModel;
+class FCardTypeModel;
+class FRarityModel;
+
+/*!
+ * \brief Loads every model and sets it as the Instance(), for the modes without MainWindow.
+ */
+class FModels : public QObject
+{
+    Q_OBJECT
+public:
+    explicit FModels(QObject *parent = nullptr);
+
+    // The models only load the default and the selected language
+    void loadAllTexts();
+
+    FLanguageModel *languageModel() const { return m_languageModel; }
+    FWillCharacteristicModel *characteristicModel() const { return m_characteristicModel; }
+    FAttributeModel *attributeModel() const { return m_attributeModel; }
+    FGeneralCardTypeModel *generalCardTypeModel() const { return m_generalCardTypeModel; }
+    FCardTypeModel *cardTypeModel() const { return m_cardTypeModel; }
+    FRarityModel *rarityModel() const { return m_rarityModel; }
+
+private:
+    FLanguageModel *m_languageModel;
+    FWillCharacteristicModel *m_characteristicModel;
+    FAttributeModel *m_attributeModel;
+    FGeneralCardTypeModel *m_generalCardTypeModel;
+    FCardTypeModel *m_cardTypeModel;
+    FRarityModel *m_rarityModel;
+};
+
+#endif // FMODELS_H
@@ -0,0 +1,137 @@
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "fmodelsnapshot.h"
+#include "flanguagemodel.h"
+#include "fattributemodel.h"
+#include "fgeneralcardtypemodel.h"
+#include "fcardtypemodel.h"
+#include "fraritymodel.h"
+
+static QAtomicInteger<quint64> s_nextVersion(1);
+static QMutex s_currentMutex;
+static FModelSnapshotPtr s_current;
+
+// The models only hold texts of the selected and the default language
+template <typename T>
+static QString textCountryCode(const T *object, const QString &countryCode, const QString &defaultCountryCode)
+{
+    return object->hasText(countryCode) ? countryCode : defaultCountryCode;
+}
+
+FModelSnapshotPtr FModelSnapshot::capture(const QString &countryCode)
+{
+    FModelSnapshot *snapshot = new FModelSnapshot();
+    snapshot->m_version = s_nextVersion.fetchAndAddOrdered(1);
+    snapshot->m_countryCode = countryCode;
+
+    const FLanguageModel *languageModel = FLanguageModel::Instance();
+    if (languageModel) {
+        if (languageModel->defaultLanguage()) {
+            snapshot->m_defaultCountryCode = languageModel->defaultLanguage()->countryCode();
+        }
+        QVector<FAbstractObject*>::const_iterator it = languageModel->dataVec()->constBegin();
+        for (; it != languageModel->dataVec()->constEnd(); ++it) {
+            const FLanguage *language = static_cast<const FLanguage*>(*it);
+            Language entry;
+            entry.id = language->id();
+            entry.stringId = language->countryCode();
+            entry.language = language->language();
+            entry.name = language->name();
+            entry.nativeName = language->nativeName();
+            snapshot->m_languages.append(entry);
+        }
+    }
+    const QString &defaultCountryCode = snapshot->m_defaultCountryCode;
+
+    const FAttributeModel *attributeModel = FAttributeModel::Instance();
+    if (attributeModel) {
+        QVector<FAbstractObject*>::const_iterator it = attributeModel->dataVec()->constBegin();
+        for (; it != attributeModel->dataVec()->constEnd(); ++it) {
+            const FAttribute *attribute = static_cast<const FAttribute*>(*it);
+            const QString cc = textCountryCode(attribute, countryCode, defaultCountryCode);
+            Attribute entry;
+            entry.id = attribute->id();
+            entry.stringId = attribute->stringId();
+            entry.iconPath = attribute->iconPath();
+            entry.color = attribute->color();
+            entry.color2 = attribute->color2();
+            entry.exclusive = attribute->isExclusive();
+            entry.generic = attribute->isGeneric();
+            entry.maxCost = attribute->maxCost();
+            entry.name = attribute->name(cc);
+            entry.shortName = attribute->shortName(cc);
+            snapshot->m_attributes.append(entry);
+        }
+    }
+
+    const FGeneralCardTypeModel *generalCardTypeModel = FGeneralCardTypeModel::Instance();
+    if (generalCardTypeModel) {
+        QVector<FAbstractObject*>::const_iterator it = generalCardTypeModel->dataVec()->constBegin();
+        for (; it != generalCardTypeModel->dataVec()->constEnd(); ++it) {
+            const FGeneralCardType *generalCardType = static_cast<const FGeneralCardType*>(*it);
+            GeneralCardType entry;
+            entry.id = generalCardType->id();
+            entry.stringId = generalCardType->stringId();
+            entry.name = generalCardType->name(textCountryCode(generalCardType, countryCode, defaultCountryCode));
+            snapshot->m_generalCardTypes.append(entry);
+        }
+    }
+
+    const FCardTypeModel *cardTypeModel = FCardTypeModel::Instance();
+    if (cardTypeModel) {
+        QVector<FAbstractObject*>::const_iterator it = cardTypeModel->dataVec()->constBegin();
+        for (; it != cardTypeModel->dataVec()->constEnd(); ++it) {
+            const FCardType *cardType = static_cast<const FCardType*>(*it);
+            const QString cc = textCountryCode(cardType, countryCode, defaultCountryCode);
+            CardType entry;
+            entry.id = cardType->id();
+            entry.stringId = cardType->stringId();
+            entry.canFight = cardType->canFight();
+            entry.hasDivinity = cardType->hasDivinity();
+            entry.hasCost = cardType->hasCost();
+            entry.name = cardType->name(cc);
+            // Any card type can be combined with any general card type on a card
+            QVector<GeneralCardType>::const_iterator gctIt = snapshot->m_generalCardTypes.entries().constBegin();
+            for (; gctIt != snapshot->m_generalCardTypes.entries().constEnd(); ++gctIt) {
+                entry.combinedNames.insert(gctIt->stringId, cardType->nameCombined(cc, gctIt->stringId));
+            }
+            snapshot->m_cardTypes.append(entry);
+        }
+    }
+
+    const FRarityModel *rarityModel = FRarityModel::Instance();
+    if (rarityModel) {
+        QVector<FAbstractObject*>::const_iterator it = rarityModel->dataVec()->constBegin();
+        for (; it != rarityModel->dataVec()->constEnd(); ++it) {
+            const FRarity *rarity = static_cast<const FRarity*>(*it);
+            const QString cc = textCountryCode(rarity, countryCode, defaultCountryCode);
+            Rarity entry;
+            entry.id = rarity->id();
+            entry.stringId = rarity->stringId();
+            entry.name = rarity->name(cc);
+            entry.shortName = rarity->shortName(cc);
+            snapshot->m_rarities.append(entry);
+        }
+    }
+
+    return FModelSnapshotPtr(snapshot);
+}
+
+FModelSnapshotPtr FModelSnapshot::current()
+{
+    QMutexLocker locker(&s_currentMutex);
+    if (s_current.isNull()) {
+        const FLanguageModel *languageModel = FLanguageModel::Instance();
+        const QString countryCode = languageModel && languageModel->selectedLanguage() ? languageModel->selectedLanguage()->countryCode() : QString();
+        s_current = capture(countryCode);
+    }
+    return s_current;
+}
+
+void FModelSnapshot::publish(const FModelSnapshotPtr &snapshot)
+{
+    QMutexLocker locker(&s_currentMutex);
+    s_current = snapshot;
+}
@@ -0,0 +1,148 @@
+#ifndef FMODELSNAPSHOT_H
+#define FMODELSNAPSHOT_H
+
+#include <QSharedPointer>
+#include <QVector>
+#include <QHash>
+#include <QColor>
+#include <QLocale>
+#include <QStringList>
+
+class FModelSnapshot;
+typedef QSharedPointer<const FModelSnapshot> FModelSnapshotPtr;
+
+/*!
+ * \brief Entries of one model in a snapshot, looked up by id or string id.
+ */
+template <typename T>
+class FSnapshotTable
+{
+public:
+    void append(const T &entry)
+    {
+        m_byId.insert(entry.id, m_entries.size());
+        m_byStringId.insert(entry.stringId, m_entries.size());
+        m_entries.append(entry);
+    }
+
+    const T *get(int id) const
+    {
+        QHash<int, int>::const_iterator it = m_byId.constFind(id);
+        return it == m_byId.constEnd() ? nullptr : &m_entries.at(it.value());
+    }
+    const T *get(const QString &stringId) const
+    {
+        QHash<QString, int>::const_iterator it = m_byStringId.constFind(stringId);
+        return it == m_byStringId.constEnd() ? nullptr : &m_entries.at(it.value());
+    }
+    const QVector<T> &entries() const { return m_entries; }
+
+private:
+    QVector<T> m_entries;
+    QHash<int, int> m_byId;
+    QHash<QString, int> m_byStringId;
+};
+
+/*!
+ * \brief Immutable copy of the models with all texts resolved for one language.
+ *
+ * The models are global, mutable and read the selected language on every
+ * call, which render workers cannot rely on while the editor changes them.
+ * A snapshot is captured once in the GUI thread and then shared by
+ * reference counting: a render job keeps its snapshot for as long as it
+ * runs and reads from it without locking, no matter what the editor
+ * publishes in the meantime. Every capture gets a new version.
+ */
+class FModelSnapshot
+{
+public:
+    struct Language {
+        int id;
+        QString stringId; // Country code
+        QLocale::Language language;
+        QString name;
+        QString nativeName;
+    };
+
+    struct Attribute {
+        int id;
+        QString stringId;
+        QString iconPath;
+        QColor color;
+        QColor color2;
+        bool exclusive;
+        bool generic;
+        int maxCost;
+        QString name;
+        QString shortName;
+    };
+
+    struct GeneralCardType {
+        int id;
+        QString stringId;
+        QString name;
+    };
+
+    struct CardType {
+        int id;
+        QString stringId;
+        bool canFight;
+        bool hasDivinity;
+        bool hasCost;
+        QString name;
+        QHash<QString, QString> combinedNames; // By general card type string id
+
+        const QString nameCombined(const QString &generalCardTypeId) const { return combinedNames.value(generalCardTypeId, name); }
+    };
+
+    struct Rarity {
+        int id;
+        QString stringId;
+        QString name;
+        QString shortName;
+    };
+
+    // Copies the models behind the Instance() pointers, call from the GUI thread
+    static FModelSnapshotPtr capture(const QString &countryCode);
+
+    // The snapshot published last, from any thread. Captures one in the
+    // selected language when nothing was published yet.
+    static FModelSnapshotPtr current();
+    static void publish(const FModelSnapshotPtr &snapshot);
+
+    quint64 version() const { return m_version; }
+    const QString &countryCode() const { return m_countryCode; }
+    const QString &defaultCountryCode() const { return m_defaultCountryCode; }
+
+    const Language *language(const QString &countryCode) const { return m_languages.get(countryCode); }
+    const Attribute *attribute(int id) const { return m_attributes.get(id); }
+    const Attribute *attribute(const QString &stringId) const { return m_attributes.get(stringId); }
+    const GeneralCardType *generalCardType(int id) const { return m_generalCardTypes.get(id); }
+    const GeneralCardType *generalCardType(const QString &stringId) const { return m_generalCardTypes.get(stringId); }
+    const CardType *cardType(int id) const { return m_cardTypes.get(id); }
+    const CardType *cardType(const QString &stringId) const { return m_cardTypes.get(stringId); }
+    const Rarity *rarity(int id) const { return m_rarities.get(id); }
+    const Rarity *rarity(const QString &stringId) const { return m_rarities.get(stringId); }
+
+    const QVector<Language> &languages() const { return m_languages.entries(); }
+    const QVector<Attribute> &attributes() const { return m_attributes.entries(); }
+    const QVector<GeneralCardType> &generalCardTypes() const { return m_generalCardTypes.entries(); }
+    const QVector<CardType> &cardTypes() const { return m_cardTypes.entries(); }
+    const QVector<Rarity> &rarities() const { return m_rarities.entries(); }
+
+private:
+    FModelSnapshot() : m_version(0) {}
+
+    quint64 m_version;
+    QString m_countryCode;
+    QString m_defaultCountryCode;
+    FSnapshotTable<Language> m_languages;
+    FSnapshotTable<Attribute> m_attributes;
+    FSnapshotTable<GeneralCardType> m_generalCardTypes;
+    FSnapshotTable<CardType> m_cardTypes;
+    FSnapshotTable<Rarity> m_rarities;
+
+    Q_DISABLE_COPY(FModelSnapshot)
+};
+
+#endif // FMODELSNAPSHOT_H
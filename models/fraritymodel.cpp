@@ -12,12 +12,24 @@ FRarity::~FRarity()
     }
 }
 
-void FRarity::addText(const QString &countryCode, FRarityText *text)
+bool FRarity::addText(const QString &countryCode, FRarityText *text)
 {
-    if (m_text.contains(countryCode)) {
-        delete m_text[countryCode];
-    }
+    FRarityText *old = m_text.value(countryCode);
+    const bool changed = !old || !(*old == *text);
+    delete old;
     m_text.insert(countryCode, text);
+    return changed;
+}
+
+bool FRarity::sameData(const FRarity &other) const
+{
+    return m_id == other.m_id && m_stringId == other.m_stringId;
+}
+
+void FRarity::setData(const FRarity &other)
+{
+    m_id = other.m_id;
+    m_stringId = other.m_stringId;
 }
 
 const QString FRarity::name() const
@@ -75,6 +87,49 @@ FRarityModel::FRarityModel(QObject *parent) : FAbstractYAMLModel(parent)
     endLoading();
 }
 
+FRarityModel::FRarityModel(const YAML::Node &node) : FAbstractYAMLModel(nullptr)
+{
+    setStrict(false);
+    beginLoading();
+    parse(node);
+    endLoading();
+}
+
+bool FRarityModel::reload(const YAML::Node &node)
+{
+    FRarityModel parsed(node);
+    if (!parsed.errorString().isEmpty()) {
+        m_errorString = parsed.errorString();
+        return false;
+    }
+
+    // New entries come without texts
+    if (update(&parsed)) {
+        reloadTexts();
+    }
+    return true;
+}
+
+bool FRarityModel::reloadText(const QString &countryCode, const YAML::Node &node)
+{
+    m_errorString.clear();
+    setStrict(false);
+    const bool parsed = parseText(countryCode, node);
+    setStrict(true);
+    return parsed;
+}
+
+bool FRarityModel::sameData(const FAbstractObject *a, const FAbstractObject *b) const
+{
+    return static_cast<const FRarity*>(a)->sameData(*static_cast<const FRarity*>(b));
+}
+
+bool FRarityModel::assignData(FAbstractObject *target, const FAbstractObject *source)
+{
+    static_cast<FRarity*>(target)->setData(*static_cast<const FRarity*>(source));
+    return true;
+}
+
 void FRarityModel::load()
 {
     YAML::Node node;
@@ -86,13 +141,16 @@ void FRarityModel::load()
         qFatal(e.msg.data());
     }
 
+    parse(node);
+}
+
+bool FRarityModel::parse(const YAML::Node &node)
+{
     if (!node.IsSequence()) {
-        qFatal(qUtf8Printable((QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"))));
-        return;
+        return fail(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"));
     }
     if (node.size() == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Rarity"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Rarity"), m_yamlFile));
     }
 
     m_vec.reserve(int(node.size()));
@@ -102,13 +160,13 @@ void FRarityModel::load()
     YAML::const_iterator it;
     for (it = node.begin(); it != node.end(); ++it) {
         if (!it->IsMap()) {
-            qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map")));
+            skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map"));
             continue;
         }
         try {
             const YAML::Node& rarityNode = *it;
             if (!rarityNode["Id"] || !rarityNode["Id"].IsScalar()) {
-                qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar")));
+                skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar"));
                 continue;
             }
 
@@ -120,16 +178,15 @@ void FRarityModel::load()
             i++;
 
         } catch (YAML::Exception e) {
-            qFatal(e.msg.data());
-            return;
+            return fail(QString::fromStdString(e.msg));
         }
     }
 
     // Entries exist, but none were valid
     if (i == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Rarity"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Rarity"), m_yamlFile));
     }
+    return true;
 }
 
 void FRarityModel::loadText(const QString &countryCode)
@@ -144,27 +201,34 @@ void FRarityModel::loadText(const QString &countryCode)
         qFatal(e.msg.data());
     }
 
+    parseText(countryCode, node);
+}
+
+bool FRarityModel::parseText(const QString &countryCode, const YAML::Node &node)
+{
+    m_textCountryCodes.insert(countryCode);
+
     if (!node.IsSequence()) {
-        qFatal(qUtf8Printable((QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"))));
-        return;
+        return fail(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"));
     }
     if (node.size() == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Rarity"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Rarity"), m_yamlFile));
     }
 
+    // Applied once the whole file is valid, a rejected file leaves the current texts
+    QHash<QString, FRarityText*> texts;
     int i = 0;
 
     YAML::const_iterator it;
     for (it = node.begin(); it != node.end(); ++it) {
         if (!it->IsMap()) {
-            qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map")));
+            skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map"));
             continue;
         }
         try {
             const YAML::Node& textNode = *it;
             if (!textNode["Id"] || !textNode["Id"].IsScalar()) {
-                qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar")));
+                skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar"));
                 continue;
             }
 
@@ -186,24 +250,34 @@ void FRarityModel::loadText(const QString &countryCode)
 
             FRarityText *rarityText = new FRarityText(name, shortName);
 
-            FRarity *rarity = value_p(textId);
-            if (rarity) {
-                rarity->addText(countryCode, rarityText);
-            }
+            delete texts.value(textId);
+            texts.insert(textId, rarityText);
 
             i++;
 
         } catch (YAML::Exception e) {
-            qFatal(e.msg.data());
-            return;
+            qDeleteAll(texts);
+            return fail(QString::fromStdString(e.msg));
         }
     }
 
     // Entries exist, but none were valid
     if (i == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Rarity"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Rarity"), m_yamlFile));
+    }
+    if (!m_errorString.isEmpty()) {
+        qDeleteAll(texts);
+        return false;
+    }
+
+    QHash<QString, FRarityText*>::const_iterator textIter = texts.constBegin();
+    for (; textIter != texts.constEnd(); ++textIter) {
+        FRarity *rarity = value_p(textIter.key());
+        if (rarity->addText(countryCode, textIter.value()) && !isLoading()) {
+            emit dataModified(textIter.key());
+        }
     }
+    return true;
 }
 
 const FRarity *FRarityModel::get(const QString &stringId) const
@@ -13,6 +13,8 @@ public:
     const QString name() const { return m_name; }
     const QString shortName() const { return m_short; }
 
+    bool operator==(const FRarityText &other) const { return m_name == other.m_name && m_short == other.m_short; }
+
 private:
     QString m_name;
     QString m_short;
@@ -25,8 +27,12 @@ public:
     FRarity(int id, const QString &stringId) : FAbstractObject(id), m_stringId(stringId) {}
     ~FRarity();
 
-    void addText(const QString &countryCode, FRarityText *text);
+    bool addText(const QString &countryCode, FRarityText *text); // True if the text changed
+    bool sameData(const FRarity &other) const;
+    void setData(const FRarity &other);
 
+    const QString stringId() const { return m_stringId; }
+    bool hasText(const QString &countryCode) const { return m_text.contains(countryCode); }
     const QString name() const;
     const QString name(const QString &countryCode) const;
     const QString shortName() const;
@@ -44,14 +50,24 @@ public:
     static void SetInstance(const FRarityModel *instance) { m_instance = instance; }
     explicit FRarityModel(QObject *parent = nullptr);
 
-    void loadText(const QString &countryCode);
+    void loadText(const QString &countryCode) override;
     const FRarity* get(const QString &stringId) const;
     const FRarity* get(int id) const;
 
     void load() override;
+    bool reload(const YAML::Node &node) override;
+    bool reloadText(const QString &countryCode, const YAML::Node &node) override;
     const QString YAMLFile() const override { return m_yamlFile; }
 
+protected:
+    bool sameData(const FAbstractObject *a, const FAbstractObject *b) const override;
+    bool assignData(FAbstractObject *target, const FAbstractObject *source) override;
+
 private:
+    explicit FRarityModel(const YAML::Node &node); // A file being reloaded, problems are not fatal
+    bool parse(const YAML::Node &node);
+    bool parseText(const QString &countryCode, const YAML::Node &node);
+
     static const FRarityModel *m_instance;
     const QString m_yamlFile = "Rarities.yaml";
 
@@ -12,12 +12,25 @@ FWillCharacteristic::~FWillCharacteristic()
     }
 }
 
-void FWillCharacteristic::addText(const QString &countryCode, FWillCharacteristicText *characteristicText)
+bool FWillCharacteristic::addText(const QString &countryCode, FWillCharacteristicText *characteristicText)
 {
-    if (m_text.contains(countryCode)) {
-        delete m_text[countryCode];
-    }
+    FWillCharacteristicText *old = m_text.value(countryCode);
+    const bool changed = !old || !(*old == *characteristicText);
+    delete old;
     m_text.insert(countryCode, characteristicText);
+    return changed;
+}
+
+bool FWillCharacteristic::sameData(const FWillCharacteristic &other) const
+{
+    return m_id == other.m_id && m_stringId == other.m_stringId && m_iconPath == other.m_iconPath;
+}
+
+void FWillCharacteristic::setData(const FWillCharacteristic &other)
+{
+    m_id = other.m_id;
+    m_stringId = other.m_stringId;
+    m_iconPath = other.m_iconPath;
 }
 
 const QString FWillCharacteristic::name() const
@@ -54,6 +67,49 @@ FWillCharacteristicModel::FWillCharacteristicModel(QObject *parent) : FAbstractY
     endLoading();
 }
 
+FWillCharacteristicModel::FWillCharacteristicModel(const YAML::Node &node) : FAbstractYAMLModel(nullptr)
+{
+    setStrict(false);
+    beginLoading();
+    parse(node);
+    endLoading();
+}
+
+bool FWillCharacteristicModel::reload(const YAML::Node &node)
+{
+    FWillCharacteristicModel parsed(node);
+    if (!parsed.errorString().isEmpty()) {
+        m_errorString = parsed.errorString();
+        return false;
+    }
+
+    // New entries come without texts
+    if (update(&parsed)) {
+        reloadTexts();
+    }
+    return true;
+}
+
+bool FWillCharacteristicModel::reloadText(const QString &countryCode, const YAML::Node &node)
+{
+    m_errorString.clear();
+    setStrict(false);
+    const bool parsed = parseText(countryCode, node);
+    setStrict(true);
+    return parsed;
+}
+
+bool FWillCharacteristicModel::sameData(const FAbstractObject *a, const FAbstractObject *b) const
+{
+    return static_cast<const FWillCharacteristic*>(a)->sameData(*static_cast<const FWillCharacteristic*>(b));
+}
+
+bool FWillCharacteristicModel::assignData(FAbstractObject *target, const FAbstractObject *source)
+{
+    static_cast<FWillCharacteristic*>(target)->setData(*static_cast<const FWillCharacteristic*>(source));
+    return true;
+}
+
 void FWillCharacteristicModel::load()
 {
     YAML::Node node;
@@ -65,13 +121,16 @@ void FWillCharacteristicModel::load()
         qFatal(e.msg.data());
     }
 
+    parse(node);
+}
+
+bool FWillCharacteristicModel::parse(const YAML::Node &node)
+{
     if (!node.IsSequence()) {
-        qFatal(qUtf8Printable((QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"))));
-        return;
+        return fail(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"));
     }
     if (node.size() == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Will Characteristic"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Will Characteristic"), m_yamlFile));
     }
 
     m_vec.reserve(int(node.size()));
@@ -81,13 +140,13 @@ void FWillCharacteristicModel::load()
     YAML::const_iterator it;
     for (it = node.begin(); it != node.end(); ++it) {
         if (!it->IsMap()) {
-            qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map")));
+            skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map"));
             continue;
         }
         try {
             const YAML::Node& characteristicNode = *it;
             if (!characteristicNode["Id"] || !characteristicNode["Id"].IsScalar()) {
-                qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar")));
+                skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar"));
                 continue;
             }
 
@@ -104,16 +163,15 @@ void FWillCharacteristicModel::load()
             i++;
 
         } catch (YAML::Exception e) {
-            qFatal(e.msg.data());
-            return;
+            return fail(QString::fromStdString(e.msg));
         }
     }
 
     // Entries exist, but none were valid
     if (i == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Will Characteristic"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 in file '%2'.").arg(QObject::tr("Will Characteristic"), m_yamlFile));
     }
+    return true;
 }
 
 void FWillCharacteristicModel::loadText(const QString &countryCode)
@@ -128,26 +186,33 @@ void FWillCharacteristicModel::loadText(const QString &countryCode)
         qFatal(e.msg.data());
     }
 
+    parseText(countryCode, node);
+}
+
+bool FWillCharacteristicModel::parseText(const QString &countryCode, const YAML::Node &node)
+{
+    m_textCountryCodes.insert(countryCode);
+
     if (!node.IsSequence()) {
-        qFatal(qUtf8Printable((QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"))));
-        return;
+        return fail(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Sequence"));
     }
     if (node.size() == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Will Characteristic"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Will Characteristic"), m_yamlFile));
     }
 
+    // Applied once the whole file is valid, a rejected file leaves the current texts
+    QHash<QString, FWillCharacteristicText*> texts;
     unsigned int i = 0;
 
     for (YAML::const_iterator it = node.begin(); it != node.end(); ++it) {
         if (!it->IsMap()) {
-            qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map")));
+            skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected type '%2'.").arg(m_yamlFile, "Map"));
             continue;
         }
         try {
             const YAML::Node& textNode = *it;
             if (!textNode["Id"] || !textNode["Id"].IsScalar()) {
-                qWarning(qUtf8Printable(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar")));
+                skipEntry(QObject::tr("Invalid node type when loading yaml file '%1'. Expected '%2' with type '%3'.").arg(m_yamlFile, "Id", "Scalar"));
                 continue;
             }
 
@@ -164,24 +229,34 @@ void FWillCharacteristicModel::loadText(const QString &countryCode)
 
             FWillCharacteristicText *characteristicText = new FWillCharacteristicText(name);
 
-            FWillCharacteristic *characteristic = value_p(textId);
-            if (characteristic) {
-                characteristic->addText(countryCode, characteristicText);
-            }
+            delete texts.value(textId);
+            texts.insert(textId, characteristicText);
 
             i++;
 
         }  catch (YAML::Exception e) {
-            qFatal(e.msg.data());
-            return;
+            qDeleteAll(texts);
+            return fail(QString::fromStdString(e.msg));
         }
     }
 
     // Entries exist, but none were valid
     if (i == 0) {
-        qFatal(qUtf8Printable(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Will Characteristic"), m_yamlFile)));
-        return;
+        return fail(QObject::tr("Need at least one %1 text in file '%2'.").arg(QObject::tr("Will Characteristic"), m_yamlFile));
+    }
+    if (!m_errorString.isEmpty()) {
+        qDeleteAll(texts);
+        return false;
+    }
+
+    QHash<QString, FWillCharacteristicText*>::const_iterator textIter = texts.constBegin();
+    for (; textIter != texts.constEnd(); ++textIter) {
+        FWillCharacteristic *characteristic = value_p(textIter.key());
+        if (characteristic->addText(countryCode, textIter.value()) && !isLoading()) {
+            emit dataModified(textIter.key());
+        }
     }
+    return true;
 }
 
 const FWillCharacteristic *FWillCharacteristicModel::get(const QString &stringId) const
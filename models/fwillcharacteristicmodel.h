@@ -10,6 +10,8 @@ public:
     FWillCharacteristicText(const QString &name) : m_name(name) {}
 
     const QString name() const { return m_name; }
+
+    bool operator==(const FWillCharacteristicText &other) const { return m_name == other.m_name; }
 private:
     QString m_name;
 };
@@ -22,7 +24,9 @@ public:
         : FAbstractObject(id), m_stringId(stringId), m_iconPath(iconPath) {}
     ~FWillCharacteristic();
 
-    void addText(const QString &countryCode, FWillCharacteristicText *characteristicText);
+    bool addText(const QString &countryCode, FWillCharacteristicText *characteristicText); // True if the text changed
+    bool sameData(const FWillCharacteristic &other) const;
+    void setData(const FWillCharacteristic &other);
 
     const QString stringId() const { return m_stringId; }
     const QString iconPath() const { return m_iconPath; }
@@ -45,14 +49,24 @@ public:
 
     explicit FWillCharacteristicModel(QObject *parent = nullptr);
 
-    void loadText(const QString &countryCode);
+    void loadText(const QString &countryCode) override;
     const FWillCharacteristic* get(const QString &stringId) const;
     const FWillCharacteristic* get(int id) const;
 
     void load() override;
+    bool reload(const YAML::Node &node) override;
+    bool reloadText(const QString &countryCode, const YAML::Node &node) override;
     const QString YAMLFile() const override { return m_yamlFile; }
 
+protected:
+    bool sameData(const FAbstractObject *a, const FAbstractObject *b) const override;
+    bool assignData(FAbstractObject *target, const FAbstractObject *source) override;
+
 private:
+    explicit FWillCharacteristicModel(const YAML::Node &node); // A file being reloaded, problems are not fatal
+    bool parse(const YAML::Node &node);
+    bool parseText(const QString &countryCode, const YAML::Node &node);
+
     static const FWillCharacteristicModel *m_instance;
     const QString m_yamlFile = "WillCharacteristics.yaml";
 
@@ -0,0 +1,274 @@
+#include <QDataStream>
+#include <cstring>
+#include "archivewriter.h"
+#include "tracer.h"
+
+// Octal with leading zeros and a terminating NUL, as tar headers want their numbers
+static bool writeOctal(char *field, int length, quint64 value)
+{
+    const QByteArray digits = QByteArray::number(value, 8).rightJustified(length - 1, '0');
+    if (digits.size() > length - 1) {
+        return false;
+    }
+    std::memcpy(field, digits.constData(), size_t(length - 1));
+    field[length - 1] = '\0';
+    return true;
+}
+
+static void dosDateTime(const QDateTime &dateTime, quint16 *time, quint16 *date)
+{
+    const QDateTime local = dateTime.toLocalTime();
+    if (local.date().year() < 1980) {
+        *time = 0;
+        *date = (1 << 5) | 1; // 1980-01-01, the earliest a zip can tell
+        return;
+    }
+    *time = quint16((local.time().hour() << 11) | (local.time().minute() << 5) | (local.time().second() / 2));
+    *date = quint16(((local.date().year() - 1980) << 9) | (local.date().month() << 5) | local.date().day());
+}
+
+ArchiveWriter::ArchiveWriter(const QString &fileName)
+    : ArchiveWriter(fileName, fileName.endsWith(".zip", Qt::CaseInsensitive) ? Zip : Tar)
+{
+}
+
+ArchiveWriter::ArchiveWriter(const QString &fileName, Format format)
+    : m_file(fileName), m_format(format), m_entryCount(0), m_offset(0)
+{
+}
+
+bool ArchiveWriter::isArchive(const QString &fileName)
+{
+    return fileName.endsWith(".zip", Qt::CaseInsensitive) || fileName.endsWith(".tar", Qt::CaseInsensitive);
+}
+
+bool ArchiveWriter::open()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_entryCount = 0;
+    m_offset = 0;
+    m_errorString.clear();
+    if (!m_file.open(QIODevice::WriteOnly)) {
+        setError(QObject::tr("Could not write '%1'. (%2)").arg(m_file.fileName(), m_file.errorString()));
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Appends a file, from any thread. The checksum is computed before taking the lock.
+ */
+bool ArchiveWriter::addFile(const QString &name, const QByteArray &data, const QDateTime &modified)
+{
+    FTRACE_SCOPE(Export, "ArchiveWriter::addFile");
+    const QByteArray utf8Name = name.toUtf8();
+    const quint32 crc = m_format == Zip ? crc32(data) : 0;
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_errorString.isEmpty()) {
+        return false;
+    }
+    const bool added = m_format == Zip ? addZipEntry(utf8Name, data, crc, modified) : addTarEntry(utf8Name, data, modified);
+    if (added) ++m_entryCount;
+    return added;
+}
+
+bool ArchiveWriter::addTarEntry(const QByteArray &name, const QByteArray &data, const QDateTime &modified)
+{
+    // Names longer than 100 bytes are split at a slash into prefix and name
+    QByteArray prefix;
+    QByteArray shortName = name;
+    if (name.size() > 100) {
+        int slash = name.indexOf('/');
+        while (slash != -1 && name.size() - slash - 1 > 100) {
+            slash = name.indexOf('/', slash + 1);
+        }
+        if (slash == -1 || slash > 155) {
+            setError(QObject::tr("The name '%1' is too long for a tar archive.").arg(QString::fromUtf8(name)));
+            return false;
+        }
+        prefix = name.left(slash);
+        shortName = name.mid(slash + 1);
+    }
+
+    QByteArray header(TAR_BLOCK_SIZE, '\0');
+    char *h = header.data();
+    std::memcpy(h, shortName.constData(), size_t(shortName.size()));
+    writeOctal(h + 100, 8, 0644); // Mode
+    writeOctal(h + 108, 8, 0);    // Uid
+    writeOctal(h + 116, 8, 0);    // Gid
+    writeOctal(h + 124, 12, quint64(data.size()));
+    writeOctal(h + 136, 12, quint64(qMax<qint64>(0, modified.toSecsSinceEpoch())));
+    std::memset(h + 148, ' ', 8); // The checksum counts its own field as spaces
+    h[156] = '0';                 // Regular file
+    std::memcpy(h + 257, "ustar", 6);
+    std::memcpy(h + 263, "00", 2);
+    std::memcpy(h + 345, prefix.constData(), size_t(prefix.size()));
+
+    quint32 checksum = 0;
+    for (int i = 0; i < TAR_BLOCK_SIZE; ++i) {
+        checksum += uchar(h[i]);
+    }
+    writeOctal(h + 148, 7, checksum); // Six digits and NUL, the trailing space stays
+
+    const int padding = (TAR_BLOCK_SIZE - data.size() % TAR_BLOCK_SIZE) % TAR_BLOCK_SIZE;
+    return write(header) && write(data) && write(QByteArray(padding, '\0'));
+}
+
+bool ArchiveWriter::addZipEntry(const QByteArray &name, const QByteArray &data, quint32 crc, const QDateTime &modified)
+{
+    if (name.size() > int(ZIP_MAX_16)) {
+        setError(QObject::tr("The name '%1' is too long for a zip archive.").arg(QString::fromUtf8(name)));
+        return false;
+    }
+    ZipEntry entry;
+    entry.name = name;
+    entry.crc = crc;
+    entry.size = quint32(data.size()); // A QByteArray stays below 2 GiB, only offsets need zip64
+    dosDateTime(modified, &entry.time, &entry.date);
+    entry.offset = m_offset;
+
+    QByteArray header;
+    QDataStream out(&header, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << quint32(0x04034b50) << quint16(20) << quint16(ZIP_UTF8_FLAG) << quint16(0) // Stored
+        << entry.time << entry.date << entry.crc << entry.size << entry.size
+        << quint16(name.size()) << quint16(0);
+    header.append(name);
+    if (!write(header) || !write(data)) {
+        return false;
+    }
+    m_entries.append(entry);
+    return true;
+}
+
+bool ArchiveWriter::writeZipDirectory()
+{
+    const quint64 directoryOffset = m_offset;
+    QByteArray directory;
+    QDataStream out(&directory, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    QVector<ZipEntry>::const_iterator it = m_entries.constBegin();
+    for (; it != m_entries.constEnd(); ++it) {
+        const bool zip64 = it->offset >= ZIP_MAX_32;
+        const quint16 version = zip64 ? 45 : 20;
+        out << quint32(0x02014b50) << version << version << quint16(ZIP_UTF8_FLAG) << quint16(0)
+            << it->time << it->date << it->crc << it->size << it->size
+            << quint16(it->name.size()) << quint16(zip64 ? 12 : 0) << quint16(0) // Comment
+            << quint16(0) << quint16(0) << quint32(0) // Disk, internal and external attributes
+            << quint32(zip64 ? ZIP_MAX_32 : it->offset);
+        out.writeRawData(it->name.constData(), it->name.size());
+        if (zip64) {
+            out << quint16(0x0001) << quint16(8) << quint64(it->offset);
+        }
+    }
+    if (!write(directory)) {
+        return false;
+    }
+
+    const quint64 directorySize = quint64(directory.size());
+    const quint64 count = quint64(m_entries.size());
+    const bool zip64 = count >= ZIP_MAX_16 || directoryOffset >= ZIP_MAX_32 || directorySize >= ZIP_MAX_32;
+    QByteArray end;
+    QDataStream endOut(&end, QIODevice::WriteOnly);
+    endOut.setByteOrder(QDataStream::LittleEndian);
+    if (zip64) {
+        const quint64 recordOffset = m_offset;
+        endOut << quint32(0x06064b50) << quint64(44) << quint16(45) << quint16(45) << quint32(0) << quint32(0)
+               << count << count << directorySize << directoryOffset;
+        endOut << quint32(0x07064b50) << quint32(0) << recordOffset << quint32(1);
+    }
+    endOut << quint32(0x06054b50) << quint16(0) << quint16(0)
+           << quint16(zip64 ? ZIP_MAX_16 : count) << quint16(zip64 ? ZIP_MAX_16 : count)
+           << quint32(zip64 ? ZIP_MAX_32 : directorySize) << quint32(zip64 ? ZIP_MAX_32 : directoryOffset)
+           << quint16(0); // Comment
+    return write(end);
+}
+
+/*!
+ * \brief Finishes the archive and replaces the target with it, nothing is left behind on failure.
+ */
+bool ArchiveWriter::commit()
+{
+    FTRACE_SCOPE(Export, "ArchiveWriter::commit");
+    QMutexLocker locker(&m_mutex);
+    if (m_errorString.isEmpty()) {
+        if (m_format == Zip) {
+            writeZipDirectory();
+        } else {
+            write(QByteArray(TAR_BLOCK_SIZE * 2, '\0'));
+        }
+    }
+    if (!m_errorString.isEmpty()) {
+        if (m_file.isOpen()) {
+            m_file.cancelWriting();
+            m_file.commit(); // Only removes the temporary file
+        }
+        return false;
+    }
+    if (!m_file.commit()) {
+        setError(QObject::tr("Could not write '%1'. (%2)").arg(m_file.fileName(), m_file.errorString()));
+        return false;
+    }
+    return true;
+}
+
+void ArchiveWriter::cancel()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_file.isOpen()) {
+        m_file.cancelWriting();
+        m_file.commit();
+    }
+}
+
+int ArchiveWriter::entryCount()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entryCount;
+}
+
+const QString ArchiveWriter::errorString()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_errorString;
+}
+
+bool ArchiveWriter::write(const QByteArray &data)
+{
+    if (m_file.write(data) != data.size()) {
+        setError(QObject::tr("Could not write '%1'. (%2)").arg(m_file.fileName(), m_file.errorString()));
+        return false;
+    }
+    m_offset += quint64(data.size());
+    return true;
+}
+
+void ArchiveWriter::setError(const QString &error)
+{
+    if (m_errorString.isEmpty()) m_errorString = error;
+}
+
+quint32 ArchiveWriter::crc32(const QByteArray &data)
+{
+    // Reflected CRC-32 of zip, zlib and PNG
+    static const QVector<quint32> table = []() {
+        QVector<quint32> entries(256);
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[int(i)] = c;
+        }
+        return entries;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    const uchar *bytes = reinterpret_cast<const uchar*>(data.constData());
+    for (int i = 0; i < data.size(); ++i) {
+        crc = table[int((crc ^ bytes[i]) & 0xFF)] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
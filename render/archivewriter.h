@@ -0,0 +1,76 @@
+#ifndef ARCHIVEWRITER_H
+#define ARCHIVEWRITER_H
+
+#include <QSaveFile>
+#include <QMutex>
+#include <QDateTime>
+#include <QVector>
+
+#define TAR_BLOCK_SIZE 512
+#define ZIP_MAX_32 0xFFFFFFFFu // Sizes and offsets from here on need zip64
+#define ZIP_MAX_16 0xFFFFu     // Entry counts from here on need zip64
+#define ZIP_UTF8_FLAG 0x0800   // Names are UTF-8
+
+/*!
+ * \brief Streams files into a tar or an uncompressed zip archive.
+ *
+ * Card images are PNG, JPEG or WebP and compressed already, so zip entries
+ * are only stored. Every entry is written as soon as addFile() is called,
+ * from any thread, without temporary files. The archive is a QSaveFile, it
+ * only replaces the target once commit() wrote the tar end blocks or the
+ * zip central directory, an interrupted export leaves no broken archive.
+ *
+ * Zip archives switch to zip64 records once they pass 4 GiB or 65535
+ * entries.
+ */
+class ArchiveWriter
+{
+public:
+    enum Format { Tar, Zip };
+
+    explicit ArchiveWriter(const QString &fileName);
+    ArchiveWriter(const QString &fileName, Format format);
+
+    static bool isArchive(const QString &fileName); // Ends in .zip or .tar
+    Format format() const { return m_format; }
+
+    bool open();
+    bool addFile(const QString &name, const QByteArray &data, const QDateTime &modified = QDateTime::currentDateTime());
+    bool commit();
+    void cancel();
+
+    int entryCount();
+    const QString errorString();
+
+    static quint32 crc32(const QByteArray &data);
+
+private:
+    // What the zip central directory repeats of an entry
+    struct ZipEntry
+    {
+        QByteArray name; // UTF-8
+        quint32 crc;
+        quint32 size;
+        quint16 time;
+        quint16 date;
+        quint64 offset; // Of the local header
+    };
+
+    QSaveFile m_file;
+    Format m_format;
+    QMutex m_mutex; // Entries come from the encoder threads
+    QVector<ZipEntry> m_entries;
+    int m_entryCount;
+    quint64 m_offset; // Bytes written so far
+    QString m_errorString;
+
+    bool write(const QByteArray &data);
+    bool addTarEntry(const QByteArray &name, const QByteArray &data, const QDateTime &modified);
+    bool addZipEntry(const QByteArray &name, const QByteArray &data, quint32 crc, const QDateTime &modified);
+    bool writeZipDirectory();
+    void setError(const QString &error);
+
+    Q_DISABLE_COPY(ArchiveWriter)
+};
+
+#endif // ARCHIVEWRITER_H
@@ -0,0 +1,257 @@
+#include <QPainter>
+#include <QSaveFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <algorithm>
+#include <functional>
+#include "atlasexporter.h"
+#include "batchrenderer.h"
+#include "cardrenderer.h"
+#include "workstealingscheduler.h"
+#include "cardset/cardsetfile.h"
+#include "tracer.h"
+
+AtlasExporter::AtlasExporter(WorkStealingScheduler *scheduler, const FModelSnapshotPtr &snapshot, const AtlasOptions &options)
+    : m_scheduler(scheduler), m_snapshot(snapshot), m_options(options), m_sheetsInFlight(2)
+{
+    // The largest width is rendered, the others are scaled down from it
+    std::sort(m_options.widths.begin(), m_options.widths.end(), std::greater<int>());
+    m_options.widths.erase(std::unique(m_options.widths.begin(), m_options.widths.end()), m_options.widths.end());
+}
+
+QSize AtlasExporter::cardSize(int width)
+{
+    return QSize(width, qRound(qreal(width) * CARD_HEIGHT / CARD_WIDTH));
+}
+
+AtlasExporter::Sheet AtlasExporter::newSheet(int width) const
+{
+    Sheet sheet;
+    sheet.width = width;
+    sheet.placed = 0;
+    return sheet;
+}
+
+/*!
+ * \brief Finds room for a side, false when the sheet is full.
+ */
+bool AtlasExporter::place(Sheet *sheet, const QSize &size, QPoint *pos) const
+{
+    if (!m_options.packed) {
+        if (sheet->placed == m_options.columns * m_options.rows) {
+            return false;
+        }
+        if (sheet->image.isNull()) {
+            const QSize card = cardSize(sheet->width);
+            sheet->image = QImage(card.width() * m_options.columns, card.height() * m_options.rows, QImage::Format_ARGB32_Premultiplied);
+            sheet->image.fill(Qt::transparent);
+        }
+        *pos = QPoint(sheet->placed % m_options.columns * size.width(), sheet->placed / m_options.columns * size.height());
+    } else {
+        // Best fit, the lowest shelf the side fits onto wastes the least
+        QRect *best = nullptr;
+        QVector<QRect>::iterator it = sheet->shelves.begin();
+        for (; it != sheet->shelves.end(); ++it) {
+            if (it->height() >= size.height() && it->x() + size.width() <= m_options.sheetSize
+                    && (!best || it->height() < best->height())) {
+                best = it;
+            }
+        }
+        if (!best) {
+            const int y = sheet->shelves.isEmpty() ? 0 : sheet->shelves.last().bottom() + 1 + m_options.padding;
+            if (y + size.height() > m_options.sheetSize || size.width() > m_options.sheetSize) {
+                return false;
+            }
+            sheet->shelves.append(QRect(0, y, m_options.sheetSize, size.height()));
+            best = &sheet->shelves.last();
+        }
+        if (sheet->image.isNull()) {
+            sheet->image = QImage(m_options.sheetSize, m_options.sheetSize, QImage::Format_ARGB32_Premultiplied);
+            sheet->image.fill(Qt::transparent);
+        }
+        *pos = best->topLeft();
+        best->setLeft(best->x() + size.width() + m_options.padding);
+    }
+    sheet->used |= QRect(*pos, size);
+    ++sheet->placed;
+    return true;
+}
+
+bool AtlasExporter::addSprite(int card, int side, int variant, const QImage &image)
+{
+    Sheet *sheet = &m_sheets[m_options.packed ? 0 : variant];
+    QPoint pos;
+    if (!place(sheet, image.size(), &pos)) {
+        closeSheet(sheet);
+        if (!place(sheet, image.size(), &pos)) {
+            setError(QObject::tr("Cards of width %1 do not fit onto a sheet of %2 pixels.").arg(image.width()).arg(m_options.sheetSize));
+            return false;
+        }
+    }
+
+    QPainter painter(&sheet->image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(pos, image);
+    painter.end();
+
+    AtlasSprite sprite;
+    sprite.card = card;
+    sprite.side = side;
+    sprite.width = m_options.widths.at(variant);
+    sprite.sheet = -1;
+    sprite.rect = QRect(pos, image.size());
+    sheet->sprites.append(m_sprites.size());
+    m_sprites.append(sprite);
+    return true;
+}
+
+/*!
+ * \brief Hands a sheet to the scheduler for encoding and leaves an empty one in its place.
+ */
+void AtlasExporter::closeSheet(Sheet *sheet)
+{
+    if (sheet->placed == 0) {
+        return;
+    }
+    QImage image = sheet->image;
+    if (m_options.packed) {
+        // Power-of-two edges, so clients can mipmap the sheet
+        const int width = int(qNextPowerOfTwo(quint32(sheet->used.right())));
+        const int height = int(qNextPowerOfTwo(quint32(sheet->used.bottom())));
+        image = image.copy(0, 0, qMin(width, m_options.sheetSize), qMin(height, m_options.sheetSize));
+    }
+
+    const int index = m_sheetSizes.size();
+    m_sheetSizes.append(image.size());
+    QVector<int>::const_iterator it = sheet->sprites.constBegin();
+    for (; it != sheet->sprites.constEnd(); ++it) {
+        m_sprites[*it].sheet = index;
+    }
+    *sheet = newSheet(sheet->width);
+
+    const QString fileName = sheetFileName(index);
+    m_sheetSlots.acquire();
+    m_scheduler->submit([this, image, fileName]() {
+        FTRACE_SCOPE(Export, "AtlasExporter sheet");
+        QSaveFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly) || !image.save(&file, m_options.format.constData()) || !file.commit()) {
+            setError(QObject::tr("Could not write '%1'. (%2)").arg(fileName, file.errorString()));
+        }
+        m_sheetSlots.release();
+    });
+}
+
+const QString AtlasExporter::sheetFileName(int sheet) const
+{
+    const QString extension = QString::fromLatin1(m_options.format).toLower();
+    return QDir(m_directory).filePath(QString("atlas-%1.%2").arg(sheet, 4, 10, QChar('0')).arg(extension));
+}
+
+bool AtlasExporter::exportAtlas(const CardSetReader &reader, const QString &directory)
+{
+    FTRACE_SCOPE(Export, "AtlasExporter::exportAtlas");
+    m_errorString.clear();
+    m_sprites.clear();
+    m_sheetSizes.clear();
+    m_sheets.clear();
+    m_directory = directory;
+    if (m_options.widths.isEmpty() || m_options.widths.last() <= 0) {
+        m_errorString = QObject::tr("No card widths for the atlas.");
+        return false;
+    }
+    if (!QDir(directory).mkpath(".")) {
+        m_errorString = QObject::tr("Could not create the output directory '%1'.").arg(directory);
+        return false;
+    }
+    for (int i = 0; i < (m_options.packed ? 1 : m_options.widths.size()); ++i) {
+        m_sheets.append(newSheet(m_options.packed ? 0 : m_options.widths.at(i)));
+    }
+    m_sheetSlots.release(m_sheetsInFlight);
+
+    BatchRenderer renderer(m_scheduler, m_snapshot);
+    bool added = true;
+    for (int first = 0; added && first < reader.cardCount(); first += ATLAS_BATCH_SIZE) {
+        const int count = qMin(ATLAS_BATCH_SIZE, reader.cardCount() - first);
+        QVector<CardRecord> records;
+        records.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            records.append(reader.card(first + i));
+        }
+
+        const QVector<QImage> images = renderer.renderImages(records, cardSize(m_options.widths.first()));
+        for (int i = 0; added && i < images.size(); ++i) {
+            for (int variant = 0; added && variant < m_options.widths.size(); ++variant) {
+                const QImage image = variant == 0 ? images.at(i)
+                        : images.at(i).scaled(cardSize(m_options.widths.at(variant)), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+                added = addSprite(first + i, records.at(i).side, variant, image);
+            }
+        }
+        added = added && !hasError();
+        qInfo(qUtf8Printable(QObject::tr("Packed %1 of %2 cards.").arg(first + count).arg(reader.cardCount())));
+    }
+    if (added) {
+        QVector<Sheet>::iterator it = m_sheets.begin();
+        for (; it != m_sheets.end(); ++it) {
+            closeSheet(it);
+        }
+    }
+    m_sheets.clear();
+    // Every slot back means every sheet is written
+    m_sheetSlots.acquire(m_sheetsInFlight);
+
+    return !hasError() && writeIndex();
+}
+
+bool AtlasExporter::writeIndex()
+{
+    QJsonArray sheets;
+    for (int i = 0; i < m_sheetSizes.size(); ++i) {
+        QJsonObject sheet;
+        sheet["file"] = QFileInfo(sheetFileName(i)).fileName();
+        sheet["width"] = m_sheetSizes.at(i).width();
+        sheet["height"] = m_sheetSizes.at(i).height();
+        sheets.append(sheet);
+    }
+
+    QJsonArray sprites;
+    QVector<AtlasSprite>::const_iterator it = m_sprites.constBegin();
+    for (; it != m_sprites.constEnd(); ++it) {
+        const QSizeF sheetSize = m_sheetSizes.at(it->sheet);
+        QJsonObject sprite;
+        sprite["card"] = it->card;
+        sprite["side"] = it->side;
+        sprite["width"] = it->width;
+        sprite["sheet"] = it->sheet;
+        sprite["rect"] = QJsonArray({ it->rect.x(), it->rect.y(), it->rect.width(), it->rect.height() });
+        sprite["uv"] = QJsonArray({ it->rect.x() / sheetSize.width(), it->rect.y() / sheetSize.height(),
+                                    (it->rect.x() + it->rect.width()) / sheetSize.width(), (it->rect.y() + it->rect.height()) / sheetSize.height() });
+        sprites.append(sprite);
+    }
+
+    QJsonObject index;
+    index["sheets"] = sheets;
+    index["sprites"] = sprites;
+
+    QSaveFile file(QDir(m_directory).filePath(ATLAS_INDEX_FILE));
+    const QByteArray data = QJsonDocument(index).toJson(QJsonDocument::Compact);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        m_errorString = QObject::tr("Could not write '%1'. (%2)").arg(file.fileName(), file.errorString());
+        return false;
+    }
+    return true;
+}
+
+void AtlasExporter::setError(const QString &error)
+{
+    QMutexLocker locker(&m_errorMutex);
+    if (m_errorString.isEmpty()) m_errorString = error;
+}
+
+bool AtlasExporter::hasError()
+{
+    QMutexLocker locker(&m_errorMutex);
+    return !m_errorString.isEmpty();
+}
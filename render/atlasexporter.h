@@ -0,0 +1,105 @@
+#ifndef ATLASEXPORTER_H
+#define ATLASEXPORTER_H
+
+#include <QVector>
+#include <QImage>
+#include <QRect>
+#include <QMutex>
+#include <QSemaphore>
+#include "models/fmodelsnapshot.h"
+
+class CardSetReader;
+class WorkStealingScheduler;
+
+#define ATLAS_BATCH_SIZE 64 // Sides rendered and held in memory at once
+#define ATLAS_INDEX_FILE "atlas.json"
+
+struct AtlasOptions
+{
+    AtlasOptions() : packed(false), columns(10), rows(7), sheetSize(4096), padding(2), format("png") { widths << 256; }
+
+    bool packed;         // Bin-packed sheets of power-of-two sizes instead of grids
+    int columns;         // Of a grid sheet
+    int rows;
+    int sheetSize;       // Largest edge of a packed sheet, a power of two
+    int padding;         // Between packed cards, keeps filtering from bleeding into neighbours
+    QVector<int> widths; // One variant per width, the largest is rendered, the others downscaled from it
+    QByteArray format;   // Any format QImageWriter supports
+};
+
+// Where a variant of a side ended up
+struct AtlasSprite
+{
+    int card;
+    int side;
+    int width;
+    int sheet;
+    QRect rect;
+};
+
+/*!
+ * \brief Packs the sides of a set into texture atlases with a JSON index of their UV rects.
+ *
+ * Sides are rendered ATLAS_BATCH_SIZE at a time by a BatchRenderer and put
+ * onto the open sheets in order. A grid sheet holds columns x rows sides of
+ * one width, while a packed sheet takes every width and is filled shelf by
+ * shelf: a side goes onto the first shelf tall enough with room left, or
+ * onto a new one below. A packed sheet is cropped to the smallest power of
+ * two holding its sides once it is full.
+ *
+ * Full sheets are encoded and written on the scheduler while the next
+ * sides render, at most sheetsInFlight() at once since every open sheet of
+ * sheetSize 4096 holds 64 MiB. The index lists every sheet and sprite in
+ * pixels and in UV coordinates, with v pointing down like in the image.
+ */
+class AtlasExporter
+{
+public:
+    AtlasExporter(WorkStealingScheduler *scheduler, const FModelSnapshotPtr &snapshot, const AtlasOptions &options = AtlasOptions());
+
+    int sheetsInFlight() const { return m_sheetsInFlight; }
+    void setSheetsInFlight(int sheets) { m_sheetsInFlight = qMax(1, sheets); }
+
+    bool exportAtlas(const CardSetReader &reader, const QString &directory); // atlas-0000.png and atlas.json
+    const QString errorString() const { return m_errorString; }
+
+    const QVector<AtlasSprite> &sprites() const { return m_sprites; }
+    const QVector<QSize> &sheetSizes() const { return m_sheetSizes; }
+
+    static QSize cardSize(int width);
+
+private:
+    // A sheet still being filled
+    struct Sheet
+    {
+        QImage image; // Allocated with the first side
+        int width;    // Of the sides on a grid sheet, 0 for a packed one
+        int placed;
+        QVector<QRect> shelves; // Of a packed sheet, x is where the next side goes
+        QRect used;
+        QVector<int> sprites;   // Indexes in m_sprites, they get the sheet number once it is written
+    };
+
+    WorkStealingScheduler *m_scheduler;
+    FModelSnapshotPtr m_snapshot;
+    AtlasOptions m_options;
+    int m_sheetsInFlight;
+    QString m_directory;
+    QVector<Sheet> m_sheets; // Open ones, one per width on grids
+    QVector<AtlasSprite> m_sprites;
+    QVector<QSize> m_sheetSizes; // Of the written sheets
+    QSemaphore m_sheetSlots;
+    QString m_errorString;
+    QMutex m_errorMutex; // Sheet tasks report errors from workers
+
+    Sheet newSheet(int width) const;
+    bool place(Sheet *sheet, const QSize &size, QPoint *pos) const;
+    bool addSprite(int card, int side, int variant, const QImage &image);
+    void closeSheet(Sheet *sheet);
+    bool writeIndex();
+    const QString sheetFileName(int sheet) const;
+    void setError(const QString &error);
+    bool hasError();
+};
+
+#endif // ATLASEXPORTER_H
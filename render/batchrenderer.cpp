@@ -0,0 +1,188 @@
+#include <QPainter>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThreadStorage>
+#include <QElapsedTimer>
+#include "batchrenderer.h"
+#include "cardrenderer.h"
+#include "renderservice.h"
+#include "workstealingscheduler.h"
+#include "tracer.h"
+
+namespace {
+
+struct TextBoxes
+{
+    TextBoxes()
+    {
+        for (int i = 0; i < CardRenderer::TextFieldCount; ++i) {
+            CardRenderer::setupTextBox(CardRenderer::TextField(i), &boxes[i]);
+        }
+    }
+
+    FTextBox boxes[CardRenderer::TextFieldCount];
+};
+
+// Per worker, a layout and the text documents are only ever used by one thread
+QThreadStorage<CardRenderer*> s_renderers;
+QThreadStorage<TextBoxes*> s_textBoxes;
+
+CardRenderer *threadRenderer(const FModelSnapshotPtr &snapshot)
+{
+    if (!s_renderers.hasLocalData()) {
+        CardRenderer *renderer = new CardRenderer(snapshot);
+        renderer->setTextEnabled(false);
+        s_renderers.setLocalData(renderer);
+    }
+    CardRenderer *renderer = s_renderers.localData();
+    renderer->setSnapshot(snapshot);
+    return renderer;
+}
+
+FTextBox *threadTextBox(CardRenderer::TextField field)
+{
+    if (!s_textBoxes.hasLocalData()) {
+        s_textBoxes.setLocalData(new TextBoxes());
+    }
+    return &s_textBoxes.localData()->boxes[field];
+}
+
+struct Side
+{
+    WorkStealingScheduler *scheduler;
+    FModelSnapshotPtr snapshot;
+    RenderJob job;
+    QElapsedTimer timer;
+
+    QVector<CardRenderer::TextRegion> regions;
+    QVector<CardRenderer::TextImage> texts; // Same order as regions
+    QImage image;
+    QAtomicInt pendingParts;
+
+    RenderResult *result;
+    QImage *imageResult; // Set for renderImages(), the side is scaled instead of encoded
+    QSize imageSize;
+    QSemaphore *done;
+};
+typedef QSharedPointer<Side> SidePtr;
+
+void encodeSide(const SidePtr &side)
+{
+    if (side->imageResult) {
+        *side->imageResult = side->imageSize.isEmpty() ? side->image
+                : side->image.scaled(side->imageSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    } else {
+        RenderService::encode(side->image, side->job.output, side->result);
+        side->result->id = side->job.id;
+        side->result->renderNsecs = side->timer.nsecsElapsed();
+    }
+    side->done->release();
+}
+
+void compositeSide(const SidePtr &side)
+{
+    FTRACE_SCOPE(Paint, "BatchRenderer composite");
+    QPainter painter(&side->image);
+    CardRenderer::drawTextImages(&painter, side->texts);
+    painter.end();
+    side->scheduler->submit([side]() { encodeSide(side); });
+}
+
+void finishPart(const SidePtr &side)
+{
+    if (!side->pendingParts.deref()) {
+        side->scheduler->submit([side]() { compositeSide(side); });
+    }
+}
+
+void drawDecorations(const SidePtr &side)
+{
+    FTRACE_SCOPE(Paint, "BatchRenderer decorations");
+    CardRenderer *renderer = threadRenderer(side->snapshot);
+    renderer->setRecord(side->job.record);
+    side->image = renderer->render();
+    finishPart(side);
+}
+
+void fitText(const SidePtr &side, int index)
+{
+    const CardRenderer::TextRegion &region = side->regions.at(index);
+    side->texts[index] = CardRenderer::fitTextRegion(region, threadTextBox(region.field));
+    finishPart(side);
+}
+
+void layoutSide(const SidePtr &side)
+{
+    FTRACE_SCOPE(Layout, "BatchRenderer layout");
+    CardRenderer *renderer = threadRenderer(side->snapshot);
+    renderer->setRecord(side->job.record);
+
+    const QVector<CardRenderer::TextRegion> regions = renderer->textRegions();
+    QVector<CardRenderer::TextRegion>::const_iterator it = regions.constBegin();
+    for (; it != regions.constEnd(); ++it) {
+        if (!it->blocks.join(QString()).isEmpty()) {
+            side->regions.append(*it);
+        }
+    }
+    side->texts.resize(side->regions.size());
+    side->pendingParts.store(side->regions.size() + 1);
+
+    side->scheduler->submit([side]() { drawDecorations(side); });
+    for (int i = 0; i < side->regions.size(); ++i) {
+        side->scheduler->submit([side, i]() { fitText(side, i); });
+    }
+}
+
+} // namespace
+
+BatchRenderer::BatchRenderer(WorkStealingScheduler *scheduler, const FModelSnapshotPtr &snapshot)
+    : m_scheduler(scheduler), m_snapshot(snapshot)
+{
+}
+
+/*!
+ * \brief Renders the jobs with the snapshot's language, the jobs' country codes are not used.
+ */
+QVector<RenderResult> BatchRenderer::render(const QVector<RenderJob> &jobs)
+{
+    FTRACE_SCOPE(Export, "BatchRenderer::render");
+    QVector<RenderResult> results(jobs.size());
+    RenderResult *resultData = results.data(); // Detach once, workers write to their own entry
+    QSemaphore done;
+    for (int i = 0; i < jobs.size(); ++i) {
+        SidePtr side(new Side());
+        side->scheduler = m_scheduler;
+        side->snapshot = m_snapshot;
+        side->job = jobs.at(i);
+        side->timer.start();
+        side->result = resultData + i;
+        side->imageResult = nullptr;
+        side->done = &done;
+        m_scheduler->submit([side]() { layoutSide(side); });
+    }
+    done.acquire(jobs.size());
+    return results;
+}
+
+QVector<QImage> BatchRenderer::renderImages(const QVector<CardRecord> &records, const QSize &size)
+{
+    FTRACE_SCOPE(Export, "BatchRenderer::renderImages");
+    QVector<QImage> images(records.size());
+    QImage *imageData = images.data();
+    QSemaphore done;
+    for (int i = 0; i < records.size(); ++i) {
+        SidePtr side(new Side());
+        side->scheduler = m_scheduler;
+        side->snapshot = m_snapshot;
+        side->job.id = quint32(i);
+        side->job.record = records.at(i);
+        side->timer.start();
+        side->result = nullptr;
+        side->imageResult = imageData + i;
+        side->imageSize = size;
+        side->done = &done;
+        m_scheduler->submit([side]() { layoutSide(side); });
+    }
+    done.acquire(records.size());
+    return images;
+}
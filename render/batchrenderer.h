@@ -0,0 +1,40 @@
+#ifndef BATCHRENDERER_H
+#define BATCHRENDERER_H
+
+#include <QVector>
+#include <QImage>
+#include "renderjob.h"
+#include "models/fmodelsnapshot.h"
+
+class WorkStealingScheduler;
+
+/*!
+ * \brief Renders many card sides at once on a WorkStealingScheduler.
+ *
+ * Render cost differs a lot between cards, a resonator without text is
+ * cheap while a ruler with long abilities needs many fitting passes. So
+ * every side is split into subtasks that idle workers can steal:
+ *
+ *   layout        lays out the side and submits everything below
+ *   decorations   draws the side without text
+ *   text fit      one per text region, fits and rasterizes it
+ *   composite     draws the text images onto the decorations, once all are done
+ *   encode        scales and encodes the finished side, or only scales it
+ *                 for renderImages()
+ */
+class BatchRenderer
+{
+public:
+    BatchRenderer(WorkStealingScheduler *scheduler, const FModelSnapshotPtr &snapshot);
+
+    // Blocks until all jobs are done, results are in the order of the jobs
+    QVector<RenderResult> render(const QVector<RenderJob> &jobs);
+    // Same for callers that compose the sides further, scaled to size unless it is empty
+    QVector<QImage> renderImages(const QVector<CardRecord> &records, const QSize &size = QSize());
+
+private:
+    WorkStealingScheduler *m_scheduler;
+    FModelSnapshotPtr m_snapshot;
+};
+
+#endif // BATCHRENDERER_H
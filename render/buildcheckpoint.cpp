@@ -0,0 +1,69 @@
+#include <QObject>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+#include "buildcheckpoint.h"
+
+BuildCheckpoint::BuildCheckpoint(const QString &fileName)
+    : m_fileName(fileName)
+{
+}
+
+bool BuildCheckpoint::load()
+{
+    m_sizes.clear();
+    QFile file(m_fileName);
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_errorString = QObject::tr("Could not read '%1'. (%2)").arg(m_fileName, file.errorString());
+        return false;
+    }
+    while (!file.atEnd()) {
+        const QList<QByteArray> fields = file.readLine().trimmed().split(' ');
+        bool ok = false;
+        const qint64 size = fields.size() == 2 ? fields.at(1).toLongLong(&ok) : 0;
+        if (ok) {
+            m_sizes.insert(fields.at(0), size);
+        }
+    }
+    return true;
+}
+
+bool BuildCheckpoint::save()
+{
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_errorString = QObject::tr("Could not write '%1'. (%2)").arg(m_fileName, file.errorString());
+        return false;
+    }
+    QTextStream out(&file);
+    QHash<QByteArray, qint64>::const_iterator it = m_sizes.constBegin();
+    for (; it != m_sizes.constEnd(); ++it) {
+        out << it.key() << ' ' << it.value() << '\n';
+    }
+    out.flush();
+    if (!file.commit()) {
+        m_errorString = QObject::tr("Could not write '%1'. (%2)").arg(m_fileName, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool BuildCheckpoint::remove()
+{
+    m_sizes.clear();
+    if (QFile::exists(m_fileName) && !QFile::remove(m_fileName)) {
+        m_errorString = QObject::tr("Could not remove '%1'.").arg(m_fileName);
+        return false;
+    }
+    return true;
+}
+
+bool BuildCheckpoint::verify(const QByteArray &hash, const QString &cachePath) const
+{
+    const QFileInfo info(cachePath);
+    return info.exists() && info.size() == m_sizes.value(hash, -1);
+}
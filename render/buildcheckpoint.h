@@ -0,0 +1,45 @@
+#ifndef BUILDCHECKPOINT_H
+#define BUILDCHECKPOINT_H
+
+#include <QHash>
+#include <QByteArray>
+#include <QString>
+
+#define SET_BUILD_CHECKPOINT ".checkpoint" // In the output directory
+
+/*!
+ * \brief Progress of a build job, the content hashes of the sides it rendered so far.
+ *
+ * SetBuilder adds every side written to the cache and saves the checkpoint
+ * after each batch, through QSaveFile so a crash leaves either the old or
+ * the new file. When an interrupted job is started again, sides listed
+ * here are verified by comparing the size of their cache file with the
+ * recorded one, a stat instead of decoding or rendering them again.
+ *
+ * The job removes the checkpoint once every language is built.
+ */
+class BuildCheckpoint
+{
+public:
+    explicit BuildCheckpoint(const QString &fileName);
+
+    const QString &fileName() const { return m_fileName; }
+
+    bool load(); // A missing file is an empty checkpoint
+    bool save();
+    bool remove();
+
+    void add(const QByteArray &hash, qint64 size) { m_sizes.insert(hash, size); }
+    bool contains(const QByteArray &hash) const { return m_sizes.contains(hash); }
+    bool verify(const QByteArray &hash, const QString &cachePath) const; // The cache file has the recorded size
+    int count() const { return m_sizes.size(); }
+
+    const QString errorString() const { return m_errorString; }
+
+private:
+    QString m_fileName;
+    QHash<QByteArray, qint64> m_sizes;
+    QString m_errorString;
+};
+
+#endif // BUILDCHECKPOINT_H
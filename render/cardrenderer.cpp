@@ -0,0 +1,816 @@
+#include <QPainter>
+#include <QSettings>
+#include <QFontInfo>
+#include <QCryptographicHash>
+#include <cstring>
+#include "cardrenderer.h"
+#include "imagecache.h"
+#include "renderstats.h"
+#include "tracer.h"
+#include "util.h"
+
+// QPainter::drawTiledPixmap has no QImage overload, a texture brush tiles the same way
+static void drawTiledImage(QPainter *painter, const QRect &rect, const QImage &image, const QPointF &offset = QPointF())
+{
+    if (image.isNull()) return;
+    QBrush brush(image);
+    brush.setTransform(QTransform::fromTranslate(rect.x() - offset.x(), rect.y() - offset.y()));
+    painter->fillRect(rect, brush);
+}
+
+CardRenderer::CardRenderer(const FModelSnapshotPtr &snapshot)
+    : m_snapshot(snapshot), m_hasRecord(false), m_textEnabled(true)
+{
+    cardPath.addRoundedRect(rect(), 50, 50);
+
+    background = decoration(":/card_decoration/dummy.jpg");
+    if (!background.isNull()) {
+        if (qreal(CARD_WIDTH) / background.width() > qreal(CARD_HEIGHT) / background.height()) {
+            backgroundScale = QRect(0, 0, CARD_WIDTH, int(qreal(CARD_WIDTH) / background.width() * background.height()));
+        } else {
+            backgroundScale = QRect(0, 0, int(qreal(CARD_HEIGHT) / background.height() * background.width()), CARD_HEIGHT);
+        }
+    }
+
+    for (int i = 0; i < TextFieldCount; ++i) {
+        setupTextBox(TextField(i), &m_texts[i]);
+    }
+
+    for (int i = 0; i < LayerCount; ++i) {
+        m_layerNsecs[i] = 0;
+    }
+
+    // Layout of the empty record
+    updateDecorations();
+    layoutNameBox();
+    layoutTextBox();
+    updateAttributeGradient();
+}
+
+/*!
+ * \brief Switches to other model data and lays out the current record again from scratch.
+ */
+void CardRenderer::setSnapshot(const FModelSnapshotPtr &snapshot)
+{
+    if (snapshot.isNull() || snapshot->version() == m_snapshot->version()) return;
+    m_snapshot = snapshot;
+    if (m_hasRecord) {
+        m_hasRecord = false;
+        setRecord(m_record);
+    }
+}
+
+/*!
+ * \brief Rebuilds what depends on the fields that differ from the previous record.
+ */
+void CardRenderer::setRecord(const CardRecord &record)
+{
+    const bool first = !m_hasRecord;
+    const CardRecord previous = m_record;
+    m_record = record;
+    m_hasRecord = true;
+
+    const bool typesChanged = first
+            || std::memcmp(previous.cardTypes, record.cardTypes, sizeof(record.cardTypes)) != 0
+            || std::memcmp(previous.generalCardTypes, record.generalCardTypes, sizeof(record.generalCardTypes)) != 0;
+    const bool rarityChanged = first || previous.rarity != record.rarity;
+    const bool attributesChanged = first || previous.attributeCount != record.attributeCount
+            || std::memcmp(previous.attributes, record.attributes, sizeof(record.attributes)) != 0;
+    const quint8 flagsChanged = first ? quint8(0xFF) : quint8(previous.showFlags ^ record.showFlags);
+
+    if (typesChanged || rarityChanged || (flagsChanged & (CardRecord::ShowStats | CardRecord::ShowBorder | CardRecord::ShowQuickcast))) {
+        updateDecorations();
+    }
+    if (typesChanged || rarityChanged || (flagsChanged & CardRecord::ShowCost)) {
+        layoutNameBox();
+    }
+    if (flagsChanged & CardRecord::ShowSmallTextBox) {
+        layoutTextBox();
+    }
+    if (attributesChanged || typesChanged || rarityChanged || (flagsChanged & (CardRecord::ShowCost | CardRecord::ShowSmallTextBox))) {
+        updateAttributeGradient();
+    }
+
+    if (m_textEnabled) {
+        updateTexts(flagsChanged & CardRecord::ShowSmallTextBox);
+    }
+}
+
+void CardRenderer::setTextEnabled(bool enabled)
+{
+    if (enabled == m_textEnabled) return;
+    m_textEnabled = enabled;
+    if (m_textEnabled && m_hasRecord) {
+        updateTexts(true);
+    }
+}
+
+QVector<CardRenderer::TextRegion> CardRenderer::textRegions() const
+{
+    QVector<TextRegion> regions;
+    regions.reserve(TextFieldCount);
+    for (int i = 0; i < TextFieldCount; ++i) {
+        TextRegion region;
+        region.field = TextField(i);
+        region.rect = textRect(region.field);
+        region.blocks = textBlocks(region.field);
+        regions.append(region);
+    }
+    return regions;
+}
+
+void CardRenderer::setFontFamily(TextField field, const QString &family)
+{
+    m_texts[field].setFontFamily(family);
+}
+
+void CardRenderer::setVoidCostFont(const QFont &font)
+{
+    m_texts[AbilityText].setVoidCostFont(font);
+}
+
+void CardRenderer::invalidateText()
+{
+    for (int i = 0; i < TextFieldCount; ++i) {
+        m_texts[i].invalidate();
+    }
+}
+
+void CardRenderer::paint(QPainter *painter)
+{
+    FTRACE_SCOPE(Paint, "CardRenderer::paint");
+    QElapsedTimer layerTimer;
+    layerTimer.start();
+    painter->save();
+    const QPen p = painter->pen();
+    const QBrush b = painter->brush();
+
+    // White card background
+    painter->setPen(Qt::white);
+    painter->drawPath(cardPath);
+    painter->fillPath(cardPath, Qt::white);
+    painter->setClipPath(cardPath);
+
+    painter->drawImage(backgroundScale, background); // TODO STRETCH
+    painter->setPen(p);
+    finishLayer(BackgroundLayer, layerTimer);
+
+    // Border
+    if (m_record.showFlag(CardRecord::ShowBorder)) {
+        painter->drawImage(BORDER_X, BORDER_Y, cornerTL);
+        painter->drawImage(CARD_WIDTH - cornerTR.width() - BORDER_X, BORDER_Y, cornerTR);
+        drawTiledImage(painter, borderTopRect, borderHorizontal);
+
+        drawTiledImage(painter, borderRightRect, borderVertical);
+
+        if (m_record.showFlag(CardRecord::ShowStats)) {
+            drawTiledImage(painter, borderLeftTopRect, borderVertical);
+            drawTiledImage(painter, borderLeftBotRect, borderVertical, borderLeftBotOffset);
+        } else {
+            drawTiledImage(painter, borderLeftRect, borderVertical);
+        }
+    }
+    if (m_record.showFlag(CardRecord::ShowStats)) {
+        painter->drawImage(0, STATS_BOX_Y, statsBox);
+    }
+
+    finishLayer(BorderLayer, layerTimer);
+
+    // Name
+    painter->setPen(Qt::transparent);
+    painter->setBrush(attributeNameGradient);
+    if (m_record.showFlag(CardRecord::ShowCost)) {
+        painter->drawRect(NAME_BOX_X + 2, NAME_BOX_Y + 2, CARD_WIDTH - NAME_BOX_X - NAME_BOX_RIGHT_OFFSET - 4, nameBoxM.height() - 4);
+        painter->setBrush(b);
+        painter->setPen(p);
+
+        painter->drawImage(NAME_BOX_X, NAME_BOX_Y, nameBoxL);
+        painter->drawImage(CARD_WIDTH - nameBoxR.width() - NAME_BOX_RIGHT_OFFSET, NAME_BOX_Y, nameBoxR);
+        drawTiledImage(painter, nameBoxRect, nameBoxM);
+
+        painter->drawImage(COST_WHEEL_X, COST_WHEEL_Y, costWheel);
+    } else {
+        painter->drawRect(NAME_BOX_NO_COST_X + 2, NAME_BOX_NO_COST_Y + 2, CARD_WIDTH - (NAME_BOX_NO_COST_X * 2) - 4, nameBoxM.height() - 4);
+        painter->setBrush(b);
+        painter->setPen(p);
+
+        painter->drawImage(NAME_BOX_NO_COST_X, NAME_BOX_NO_COST_Y, nameBoxL);
+        painter->drawImage(CARD_WIDTH - nameBoxR.width() - NAME_BOX_NO_COST_X, NAME_BOX_NO_COST_Y, nameBoxR);
+        drawTiledImage(painter, nameBoxRect, nameBoxM);
+    }
+
+    finishLayer(NameBoxLayer, layerTimer);
+
+    // Footer
+    painter->setPen(Qt::transparent);
+    painter->setBrush(QBrush(Util::BoxDefaultColor, Qt::SolidPattern));
+    painter->drawRect(FOOTER_BOX_X + 2, footerBoxRect.y() + 2, CARD_WIDTH - (FOOTER_BOX_X * 2) - 4, footerBoxM.height());
+    painter->setBrush(b);
+    painter->setPen(p);
+    painter->drawImage(FOOTER_BOX_X, footerBoxRect.y(), footerBoxL);
+    painter->drawImage(CARD_WIDTH - footerBoxR.width() - FOOTER_BOX_X, footerBoxRect.y(), footerBoxR);
+    drawTiledImage(painter, footerBoxRect, footerBoxM);
+
+    finishLayer(FooterLayer, layerTimer);
+
+    // Textbox
+    if (m_record.showFlag(CardRecord::ShowTextBox)) {
+        painter->setPen(Qt::transparent);
+        painter->setBrush(attributeTextBoxGradient);
+        painter->setClipPath(textBoxPath);
+        // Top region
+        painter->drawRect(textBoxRect.x(), textBoxRect.y(), textBoxRect.width(), TEXT_BOX_TOP_HEIGHT);
+        // Bottom region
+        painter->setBrush(QBrush(Util::TextBoxBottomRegionColor, Qt::SolidPattern));
+        painter->drawRect(textBoxRect.x(), textBoxRect.y() + TEXT_BOX_TOP_HEIGHT, textBoxRect.width(), textBoxRect.height() - TEXT_BOX_TOP_HEIGHT);
+        painter->setBrush(b);
+    }
+
+    finishLayer(TextBoxLayer, layerTimer);
+
+    // Draw attribute icons, as paths on vector devices
+    const bool vector = Util::isVectorDevice(painter);
+    int step = 0;
+    QVector<QImage>::const_iterator it = attributeIcons.constBegin();
+    for (int i = 0; it != attributeIcons.constEnd(); ++it, ++i, step += TEXT_BOX_ATTRIBUTE_STEP) {
+        const QPoint pos(int(textBoxAttributeStartOffset.x()) + step, int(textBoxAttributeStartOffset.y()));
+        painter->setOpacity(0.75);
+        if (vector) {
+            Util::XML::drawSvg(painter, QRectF(pos, it->size()), attributeIconFiles.at(i), QSize(TEXT_BOX_ATTRIBUTE_SIZE, -1), QPen(Qt::white, 8), false);
+        } else {
+            painter->drawImage(pos, *it);
+        }
+        painter->setOpacity(1.0);
+        if (Util::DrawDebugInfo) {
+            painter->drawRect(QRect(pos, it->size()));
+        }
+    }
+    finishLayer(AttributeLayer, layerTimer);
+
+    painter->setClipPath(cardPath);
+    painter->setBrush(b);
+    painter->setPen(p);
+
+    if (Util::DrawDebugInfo) {
+        // Debugging
+        painter->drawRect(textBoxRectInner);
+        painter->drawRect(textBoxTopRectInner);
+    }
+
+    if (m_textEnabled) {
+        m_texts[CardNameText].draw(painter);
+        m_texts[AbilityText].draw(painter);
+        m_texts[CardTypeText].draw(painter);
+        m_texts[FlavorText].draw(painter);
+    }
+    finishLayer(TextLayer, layerTimer);
+
+    painter->restore();
+}
+
+QImage CardRenderer::render()
+{
+    QImage image(size(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    paint(&painter);
+    painter.end();
+    return image;
+}
+
+QImage CardRenderer::renderRecord(const CardRecord &record, const FModelSnapshotPtr &snapshot)
+{
+    CardRenderer renderer(snapshot);
+    renderer.setRecord(record);
+    return renderer.render();
+}
+
+QFont CardRenderer::textFont(TextField field)
+{
+    QSettings settings;
+    QFont font;
+    switch (field) {
+    case CardNameText:
+        font.fromString(settings.value("font/cardname", "Times New Roman").value<QString>());
+        font.setWeight(QFont::Bold);
+        font.setPointSize(52);
+        font.setLetterSpacing(QFont::PercentageSpacing, 105);
+        break;
+    case CardTypeText:
+        font.fromString(settings.value("font/cardtype", "Times New Roman").value<QString>());
+        font.setPointSize(36);
+        font.setLetterSpacing(QFont::PercentageSpacing, 105);
+        break;
+    case AbilityText:
+        font.fromString(settings.value("font/abilities", "Ryo Text PlusN M").value<QString>());
+        font.setPointSize(38);
+        font.setLetterSpacing(QFont::PercentageSpacing, 105);
+        break;
+    case FlavorText:
+        font.fromString(settings.value("font/flavor", "Times New Roman").value<QString>());
+        font.setPointSize(32);
+        font.setLetterSpacing(QFont::PercentageSpacing, 90);
+        break;
+    default:
+        break;
+    }
+    font.setStyleStrategy(QFont::StyleStrategy::NoAntialias);
+    return font;
+}
+
+/*!
+ * \brief The requested and the actually matched fonts, a missing font changes the output too.
+ */
+QByteArray CardRenderer::fontKey()
+{
+    QByteArray key;
+    QDataStream out(&key, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_9);
+    for (int i = 0; i < TextFieldCount; ++i) {
+        const QFont font = textFont(TextField(i));
+        out << font.toString() << QFontInfo(font).family();
+    }
+    return key;
+}
+
+/*!
+ * \brief Hashes the renderer version, the fonts and the parts of the record and models paint() reads.
+ *
+ * Only the model entries the record references are included, with the
+ * texts of the snapshot's language. Decorations and symbols are compiled
+ * in, changing them requires bumping CARD_RENDERER_VERSION.
+ */
+QByteArray CardRenderer::contentHash(const CardRecord &record, const FModelSnapshot &snapshot, const QByteArray &fontKey)
+{
+    const QString &countryCode = snapshot.countryCode();
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_9);
+    out << quint32(CARD_RENDERER_VERSION) << fontKey << countryCode << record.showFlags;
+
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        const FModelSnapshot::CardType *ct = snapshot.cardType(record.cardTypes[i]);
+        const FModelSnapshot::GeneralCardType *gct = snapshot.generalCardType(record.generalCardTypes[i]);
+        out << (ct ? ct->stringId : QString()) << (ct ? ct->name : QString());
+        out << (gct ? gct->stringId : QString()) << (ct && gct ? ct->nameCombined(gct->stringId) : QString());
+    }
+    for (int i = 0; i < record.attributeCount; ++i) {
+        const FModelSnapshot::Attribute *attribute = snapshot.attribute(record.attributes[i]);
+        if (!attribute) continue;
+        out << attribute->stringId << attribute->iconPath << attribute->color.rgba() << attribute->color2.rgba();
+    }
+    const FModelSnapshot::Rarity *rarity = snapshot.rarity(record.rarity);
+    out << (rarity ? rarity->stringId : QString());
+
+    out << record.cardName.text(countryCode) << record.flavorText.text(countryCode);
+    out << quint32(record.traits.size());
+    QVector<FLanguageString>::const_iterator it = record.traits.constBegin();
+    for (; it != record.traits.constEnd(); ++it) {
+        out << it->text(countryCode);
+    }
+    out << quint32(record.abilities.size());
+    for (it = record.abilities.constBegin(); it != record.abilities.constEnd(); ++it) {
+        out << it->text(countryCode);
+    }
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha256).toHex();
+}
+
+void CardRenderer::setupTextBox(TextField field, FTextBox *box)
+{
+    switch (field) {
+    case CardNameText:
+        box->setAlignment(Qt::AlignCenter);
+        box->setDefaultTextColor(Qt::white);
+        box->setOutlinePen(QPen(Qt::black, 10, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+        box->showOutline(true);
+        break;
+    case AbilityText:
+        box->setFitToRectOrder(FTextBox::SizeSpacingStretch);
+        break;
+    case FlavorText:
+        box->setAlignment(Qt::AlignCenter);
+        break;
+    default:
+        break;
+    }
+    box->setFont(textFont(field));
+}
+
+/*!
+ * \brief Fits a region into a box set up with setupTextBox() and rasterizes it.
+ *
+ * The box is fitted from its default font every time, so reusing one for
+ * many cards gives the same result as a fresh one.
+ */
+CardRenderer::TextImage CardRenderer::fitTextRegion(const TextRegion &region, FTextBox *box)
+{
+    box->setTargetRect(region.rect);
+    box->clear();
+    if (region.field == AbilityText) {
+        QStringList::const_iterator it = region.blocks.constBegin();
+        for (; it != region.blocks.constEnd(); ++it) {
+            box->insertTextBlock(*it);
+        }
+    } else {
+        box->setText(region.blocks.value(0));
+    }
+    box->fitToRect();
+
+    TextImage textImage;
+    textImage.image = box->image();
+    textImage.rect = box->rect();
+    return textImage;
+}
+
+void CardRenderer::drawTextImages(QPainter *painter, const QVector<TextImage> &images)
+{
+    QPainterPath path;
+    path.addRoundedRect(rect(), 50, 50);
+    painter->save();
+    painter->setClipPath(path);
+    QVector<TextImage>::const_iterator it = images.constBegin();
+    for (; it != images.constEnd(); ++it) {
+        if (!it->image.isNull()) {
+            painter->drawImage(it->rect, it->image, QRectF(it->image.rect()));
+        }
+    }
+    painter->restore();
+}
+
+const char *CardRenderer::layerName(Layer layer)
+{
+    switch (layer) {
+    case BackgroundLayer: return "Background";
+    case BorderLayer:     return "Border";
+    case NameBoxLayer:    return "Name box";
+    case FooterLayer:     return "Footer";
+    case TextBoxLayer:    return "Text box";
+    case AttributeLayer:  return "Attributes";
+    case TextLayer:       return "Text";
+    default:              return "";
+    }
+}
+
+void CardRenderer::finishLayer(Layer layer, QElapsedTimer &timer)
+{
+    m_layerNsecs[layer] = timer.nsecsElapsed();
+    timer.start();
+}
+
+ImageCache *CardRenderer::imageCache()
+{
+    static ImageCache cache(&RenderStats::Instance()->decorations, DECORATION_CACHE_LIMIT);
+    return &cache;
+}
+
+QImage CardRenderer::decoration(const QString &filename)
+{
+    QImage image;
+    if (imageCache()->find(filename, &image)) {
+        return image;
+    }
+    image = QImage(filename).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    imageCache()->insert(filename, image);
+    return image;
+}
+
+QImage CardRenderer::mirrored(const QString &filename)
+{
+    const QString key = QStringLiteral("mirrored:") + filename;
+    QImage image;
+    if (imageCache()->find(key, &image)) {
+        return image;
+    }
+    image = decoration(filename).mirrored(true, false);
+    imageCache()->insert(key, image);
+    return image;
+}
+
+QImage CardRenderer::attributeIcon(const FModelSnapshot::Attribute *attribute)
+{
+    const QString filename = QString(":/svg/" + attribute->iconPath + ".svg");
+    const QString key = QStringLiteral("attribute:") + filename;
+    QImage image;
+    if (imageCache()->find(key, &image)) {
+        return image;
+    }
+    image = Util::XML::svgToImage(filename, QSize(TEXT_BOX_ATTRIBUTE_SIZE, -1), QPen(Qt::white, 8), false);
+    imageCache()->insert(key, image);
+    return image;
+}
+
+void CardRenderer::updateDecorations()
+{
+    const FModelSnapshot::CardType *rulerType = m_snapshot->cardType(QStringLiteral("RULER"));
+    const FModelSnapshot::CardType *jRulerType = m_snapshot->cardType(QStringLiteral("JRULER"));
+    bool ruler = false;
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        if ((rulerType && m_record.cardTypes[i] == rulerType->id) || (jRulerType && m_record.cardTypes[i] == jRulerType->id)) {
+            ruler = true;
+        }
+    }
+    const FModelSnapshot::Rarity *superRareRarity = m_snapshot->rarity(QStringLiteral("SUPERRARE"));
+    const FModelSnapshot::Rarity *rareRarity = m_snapshot->rarity(QStringLiteral("RARE"));
+    const bool superRare = !ruler && superRareRarity && m_record.rarity == superRareRarity->id;
+    const QString style = ruler || superRare ? QStringLiteral("superrare") : QStringLiteral("standard");
+    QString cornerFile;
+
+    if (ruler) {
+        cornerFile = ":/card_decoration/border-corner-ruler.png";
+        borderVertical = decoration(":/card_decoration/border-vertical-superrare.png");
+    } else if (superRare) {
+        cornerFile = ":/card_decoration/border-corner-superrare.png";
+        borderVertical = decoration(":/card_decoration/border-vertical-superrare-diamond.png");
+    } else {
+        if (rareRarity && m_record.rarity == rareRarity->id) {
+            cornerFile = ":/card_decoration/border-corner-rare.png";
+        } else {
+            cornerFile = ":/card_decoration/border-corner-standard.png";
+        }
+        borderVertical = decoration(":/card_decoration/border-vertical-standard.png");
+    }
+    const QString nameBoxFile = QString(":/card_decoration/name-box-%1-left.png").arg(style);
+    const QString footerBoxFile = QString(":/card_decoration/footer-box-%1-left.png").arg(style);
+
+    cornerTL = decoration(cornerFile);
+    borderHorizontal = decoration(QString(":/card_decoration/border-horizontal-%1.png").arg(style));
+    nameBoxL = decoration(nameBoxFile);
+    nameBoxM = decoration(QString(":/card_decoration/name-box-%1-mid.png").arg(style));
+    footerBoxL = decoration(footerBoxFile);
+    footerBoxM = decoration(QString(":/card_decoration/footer-box-%1-mid.png").arg(style));
+
+    costWheel = decoration(QString(":/card_decoration/cost-wheel-%1%2.png").arg(style, m_record.showFlag(CardRecord::ShowQuickcast) ? "-quickcast" : ""));
+
+    // The stats box reaches the card edge when there is no border
+    statsBox = decoration(QString(":/card_decoration/stats-box-%1%2%3.png").arg(style,
+                                                                            m_record.showFlag(CardRecord::ShowStats) && !m_record.showFlag(CardRecord::ShowBorder) ? "-edge" : "",
+                                                                            superRare ? "-diamond" : ""));
+
+    cornerTR = mirrored(cornerFile);
+    nameBoxR = mirrored(nameBoxFile);
+    footerBoxR = mirrored(footerBoxFile);
+
+    borderTopRect = QRect(
+                cornerTL.width() + BORDER_X,
+                BORDER_Y,
+                CARD_WIDTH - cornerTR.width() - BORDER_X - (BORDER_X + cornerTL.width()),
+                borderHorizontal.height());
+
+    borderRightRect = QRect(
+                CARD_WIDTH - borderVertical.width() - BORDER_X,
+                cornerTR.height() + BORDER_Y,
+                borderVertical.width(),
+                CARD_HEIGHT - cornerTR.height() - BORDER_Y);
+
+    borderLeftRect = QRect(
+                BORDER_X,
+                cornerTL.height() + BORDER_Y,
+                borderVertical.width(),
+                CARD_HEIGHT - cornerTL.height() - BORDER_Y);
+
+    borderLeftTopRect = QRect(
+                BORDER_X,
+                cornerTL.height() + BORDER_Y,
+                borderVertical.width(),
+                STATS_BOX_Y - (cornerTL.height() + BORDER_Y));
+
+    borderLeftBotRect = QRect(
+                BORDER_X,
+                borderLeftTopRect.y() + borderLeftTopRect.height() + statsBox.height(),
+                borderVertical.width(),
+                CARD_HEIGHT - (borderLeftTopRect.y() + borderLeftTopRect.height() + statsBox.height()));
+
+    borderLeftBotOffset = QPointF(0, borderLeftBotRect.y() - (borderLeftRect.y() + borderVertical.height()));
+
+    footerBoxRect = QRect(
+                footerBoxL.width() + FOOTER_BOX_X,
+                CARD_HEIGHT - FOOTER_BOX_BOT_OFFSET,
+                CARD_WIDTH - footerBoxR.width() - FOOTER_BOX_X - (footerBoxL.width() + FOOTER_BOX_X),
+                FOOTER_BOX_BOT_OFFSET);
+}
+
+void CardRenderer::layoutNameBox()
+{
+    QRect nameTextBoxRect_new = QRect();
+    if (m_record.showFlag(CardRecord::ShowCost)) {
+        nameBoxRect = QRect(
+                    NAME_BOX_X + nameBoxL.width(),
+                    NAME_BOX_Y,
+                    CARD_WIDTH - nameBoxR.width() - NAME_BOX_RIGHT_OFFSET - (NAME_BOX_X + nameBoxL.width()),
+                    nameBoxM.height());
+        nameTextBoxRect_new.setTopLeft(QPoint(nameBoxRect.left() + NAME_BOX_NO_COST_LEFTMARGIN, nameBoxRect.top()));
+    } else {
+        nameBoxRect = QRect(
+                    NAME_BOX_NO_COST_X + nameBoxL.width(),
+                    NAME_BOX_NO_COST_Y,
+                    CARD_WIDTH - nameBoxR.width() - NAME_BOX_NO_COST_X - (NAME_BOX_NO_COST_X + nameBoxL.width()),
+                    nameBoxM.height());
+        nameTextBoxRect_new.setTopLeft(QPoint(nameBoxRect.left() + NAME_BOX_H_MARGIN, nameBoxRect.top()));
+    }
+    nameTextBoxRect_new.setBottomRight(QPoint(nameBoxRect.right() - NAME_BOX_H_MARGIN, nameBoxRect.bottom()));
+    if (nameTextBoxRect_new != nameTextBoxRect) {
+        nameTextBoxRect = nameTextBoxRect_new;
+        m_texts[CardNameText].setTargetRect(nameTextBoxRect);
+    }
+}
+
+void CardRenderer::layoutTextBox()
+{
+    const int textBoxY = m_record.showFlag(CardRecord::ShowSmallTextBox) ? TEXT_BOX_SMALL_Y : TEXT_BOX_Y;
+    textBoxRect = QRect(TEXT_BOX_X, textBoxY, CARD_WIDTH - (TEXT_BOX_X * 2), footerBoxRect.y() - textBoxY - 1);
+    textBoxPath = QPainterPath();
+    textBoxPath.addRoundedRect(textBoxRect, 6, 6);
+    textBoxAttributeStartOffset.setY(textBoxY + TEXT_BOX_TOP_HEIGHT / 2 - TEXT_BOX_ATTRIBUTE_SIZE / 2);
+
+    textBoxTopRectInner.setTopLeft(QPoint(TEXT_BOX_X + 40, textBoxY));
+    textBoxTopRectInner.setBottomRight(QPoint(textBoxRect.right() - 40, textBoxY + TEXT_BOX_TOP_HEIGHT));
+
+    textBoxRectInner.setTopLeft(QPoint(textBoxRect.left() + 40, textBoxRect.top() + 20 + TEXT_BOX_TOP_HEIGHT));
+    textBoxRectInner.setBottomRight(QPoint(textBoxRect.right() - 40, textBoxRect.bottom() - TEXT_BOX_FLAVOR_HEIGHT));
+
+    textFlavorBox.setTopLeft(QPoint(textBoxRect.left() + 40, textBoxRect.bottom() - TEXT_BOX_FLAVOR_HEIGHT));
+    textFlavorBox.setBottomRight(QPoint(textBoxRect.right() - 40, textBoxRect.bottom()));
+
+    m_texts[CardTypeText].setTargetRect(textBoxTopRectInner);
+    m_texts[AbilityText].setTargetRect(textBoxRectInner);
+    m_texts[FlavorText].setTargetRect(textFlavorBox);
+}
+
+void CardRenderer::updateAttributeGradient()
+{
+    attributeNameGradient = QLinearGradient(nameBoxRect.topLeft(), nameBoxRect.topRight());
+    attributeTextBoxGradient = QLinearGradient(textBoxRect.topLeft(), textBoxRect.topRight());
+    attributeIcons.clear();
+    attributeIconFiles.clear();
+
+    QVector<const FModelSnapshot::Attribute*> data;
+    for (int i = 0; i < m_record.attributeCount; ++i) {
+        const FModelSnapshot::Attribute *attribute = m_snapshot->attribute(m_record.attributes[i]);
+        if (attribute) {
+            data.append(attribute);
+            attributeIcons.append(attributeIcon(attribute));
+            attributeIconFiles.append(":/svg/" + attribute->iconPath + ".svg");
+        }
+    }
+
+    if (data.size() == 0) {
+        attributeNameGradient.setColorAt(0, Util::BoxDefaultColor);
+        attributeNameGradient.setColorAt(1, Util::BoxDefaultColor);
+        attributeTextBoxGradient.setColorAt(0, Util::TextBoxTopRegionColor);
+        attributeTextBoxGradient.setColorAt(1, Util::TextBoxTopRegionColor);
+    } else if (data.size() == 1) {
+        QColor color = data.first()->color2;
+        attributeNameGradient.setColorAt(0, color);
+        attributeNameGradient.setColorAt(1, color);
+
+        QColor colorTextBox = data.first()->color;
+        attributeTextBoxGradient.setColorAt(0, colorTextBox);
+        attributeTextBoxGradient.setColorAt(1, colorTextBox);
+
+        textBoxAttributeStartOffset.setX(TEXT_BOX_X + textBoxRect.width() - TEXT_BOX_ATTRIBUTE_STEP);
+    } else {
+        qreal step = 1.0 / (data.size() - 1);
+        qreal halfStep = step / 2.0;
+        qreal currentStep = 0;
+
+        textBoxAttributeStartOffset.setX(TEXT_BOX_X + textBoxRect.width() - TEXT_BOX_ATTRIBUTE_STEP * data.size());
+
+        QVector<const FModelSnapshot::Attribute*>::const_iterator it = data.constBegin();
+        for (; it != data.constEnd(); ++it) {
+            QColor color = (*it)->color2;
+            QColor colorTextBox = (*it)->color;
+
+            attributeNameGradient.setColorAt(currentStep, color);
+            attributeTextBoxGradient.setColorAt(currentStep, colorTextBox);
+
+            // Squish colors closer together between two points
+            if (currentStep + step <= 1.0) {
+                qreal inbetween = currentStep + halfStep;
+                qreal leftPos = inbetween - halfStep * COLOR_GRADIENT_SQUISH_FACTOR;
+                qreal rightPos = inbetween + halfStep * COLOR_GRADIENT_SQUISH_FACTOR;
+
+                attributeNameGradient.setColorAt(leftPos, color);
+                attributeTextBoxGradient.setColorAt(leftPos, colorTextBox);
+
+                QColor nextColor = (*(it+1))->color2;
+                QColor nextTextBoxColor = (*(it+1))->color;
+
+                attributeNameGradient.setColorAt(rightPos, nextColor);
+                attributeTextBoxGradient.setColorAt(rightPos, nextTextBoxColor);
+            }
+
+            currentStep += step;
+        }
+    }
+}
+
+/*!
+ * \brief Sets the texts of the record in the current language, only refitting the boxes whose text changed.
+ */
+void CardRenderer::updateTexts(bool refitAbilities)
+{
+    const TextField singleBlockFields[] = { CardNameText, CardTypeText, FlavorText };
+    for (int i = 0; i < 3; ++i) {
+        FTextBox &box = m_texts[singleBlockFields[i]];
+        const QString text = textBlocks(singleBlockFields[i]).first();
+        if (text != box.text()) {
+            box.setText(text);
+        }
+    }
+
+    const QStringList abilities = textBlocks(AbilityText);
+    if (abilities != m_abilities || refitAbilities) {
+        m_abilities = abilities;
+        FTextBox &box = m_texts[AbilityText];
+        box.clear();
+        QStringList::const_iterator blockIt = m_abilities.constBegin();
+        for (; blockIt != m_abilities.constEnd(); ++blockIt) {
+            box.insertTextBlock(*blockIt);
+        }
+        box.fitToRect();
+    }
+}
+
+QStringList CardRenderer::textBlocks(TextField field) const
+{
+    switch (field) {
+    case CardNameText:
+        return QStringList(m_record.cardName.text(countryCode()));
+    case CardTypeText:
+        return QStringList(generateCardTypeText());
+    case FlavorText:
+        return QStringList(m_record.flavorText.text(countryCode()));
+    case AbilityText: {
+        QStringList abilities;
+        abilities.reserve(m_record.abilities.size());
+        QVector<FLanguageString>::const_iterator it = m_record.abilities.constBegin();
+        for (; it != m_record.abilities.constEnd(); ++it) {
+            abilities.append(it->text(countryCode()));
+        }
+        return abilities;
+    }
+    default:
+        return QStringList();
+    }
+}
+
+QRect CardRenderer::textRect(TextField field) const
+{
+    switch (field) {
+    case CardNameText: return nameTextBoxRect;
+    case CardTypeText: return textBoxTopRectInner;
+    case AbilityText:  return textBoxRectInner;
+    case FlavorText:   return textFlavorBox;
+    default:           return QRect();
+    }
+}
+
+const QString CardRenderer::generateCardTypeText() const
+{
+    QString cardTypeText = QString();
+    bool containsResonatorType = false;
+    bool containsRulerType = false;
+    QStringList typeTexts;
+    for (int i = 0; i < MAX_CARD_TYPES; ++i) {
+        const FModelSnapshot::CardType *ct = m_record.cardTypes[i] >= 0 ? m_snapshot->cardType(m_record.cardTypes[i]) : nullptr;
+        if (!ct) continue;
+        const FModelSnapshot::GeneralCardType *gct = m_record.generalCardTypes[i] > 0 ? m_snapshot->generalCardType(m_record.generalCardTypes[i]) : nullptr;
+        QString typeText;
+        if (gct) {
+            typeText = ct->nameCombined(gct->stringId);
+        } else {
+            typeText = ct->name;
+        }
+        if (ct->stringId == "RULER" || ct->stringId == "JRULER") {
+            containsRulerType = true;
+            typeText = QString("[") + typeText + QString("!]");
+        }
+
+        if (ct->stringId == "RESONATOR") {
+            containsResonatorType = true;
+        }
+        typeTexts.append(typeText);
+    }
+    cardTypeText = typeTexts.join(QString("/"));
+
+    const int traitCount = m_record.traits.size();
+    if (containsResonatorType && traitCount > 0) {
+        cardTypeText += QString(": ");
+    } else if (!containsRulerType && traitCount > 0) {
+        cardTypeText += QString(" (");
+    } else if (traitCount > 0) {
+        cardTypeText += QString(" ");
+    }
+
+    QStringList traits;
+    QVector<FLanguageString>::const_iterator it = m_record.traits.constBegin();
+    for (; it != m_record.traits.constEnd(); ++it) {
+        traits.append(it->text(countryCode()));
+    }
+    cardTypeText += traits.join(QString("/"));
+
+    if (!containsResonatorType && !containsRulerType && traitCount > 0) {
+        cardTypeText += QString(")");
+    }
+    return cardTypeText;
+}
@@ -0,0 +1,204 @@
+#ifndef CARDRENDERER_H
+#define CARDRENDERER_H
+
+#include <QImage>
+#include <QPainterPath>
+#include <QLinearGradient>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QStringList>
+#include "cardrecord.h"
+#include "text/ftextbox.h"
+#include "models/fmodelsnapshot.h"
+
+class ImageCache;
+
+#define CARD_WIDTH 1466 // High-res, low-res was 609x850
+#define CARD_HEIGHT 2048
+
+#define COLOR_GRADIENT_SQUISH_FACTOR 0.2 // Smaller means stronger squished
+
+// Positions
+#define BORDER_X  18
+#define BORDER_Y   18
+
+#define STATS_BOX_Y 363
+
+#define NAME_BOX_NO_COST_X 116
+#define NAME_BOX_NO_COST_Y 98
+#define NAME_BOX_X 268
+#define NAME_BOX_Y 72
+#define NAME_BOX_RIGHT_OFFSET 86
+#define NAME_BOX_NO_COST_LEFTMARGIN 100
+#define NAME_BOX_H_MARGIN 20
+
+#define COST_WHEEL_X 21
+#define COST_WHEEL_Y 25
+
+#define FOOTER_BOX_X 111
+#define FOOTER_BOX_BOT_OFFSET 88
+
+#define TEXT_BOX_X FOOTER_BOX_X
+#define TEXT_BOX_Y 1264
+#define TEXT_BOX_TOP_HEIGHT 96
+#define TEXT_BOX_SMALL_Y 1536
+#define TEXT_BOX_FLAVOR_HEIGHT 100
+#define TEXT_BOX_ATTRIBUTE_SIZE 72
+#define TEXT_BOX_ATTRIBUTE_STEP (TEXT_BOX_ATTRIBUTE_SIZE + TEXT_BOX_ATTRIBUTE_SIZE/2)
+
+#define DECORATION_CACHE_LIMIT (64 * 1024 * 1024)
+
+// Bump whenever the same record and fonts draw a different image, e.g. after
+// changing the layout or a decoration, so cached renders are thrown away
+#define CARD_RENDERER_VERSION 1
+
+/*!
+ * \brief Draws a card side from a CardRecord, only using QImage.
+ *
+ * Decorations, symbols and text are premultiplied ARGB32 images, so a
+ * renderer can live in any QThread (QThreadPool, QtConcurrent) and render
+ * cards next to others running in other threads. A single renderer is not
+ * thread safe, keep one per thread or per card. Types, rarities, attributes
+ * and the language come from the FModelSnapshot it was given, never from
+ * the global models, so the editor may change those while rendering.
+ *
+ * setRecord() only redoes the layout and text fitting the differences to
+ * the previous record call for, so keeping a renderer per shown card makes
+ * repaints cheap. CardPreviewItem is such an adapter for the preview.
+ *
+ * Painted on a vector device like QPdfWriter, text and symbols are drawn
+ * as glyphs and paths instead. The decorations stay the shared images of
+ * imageCache(), the PDF engine writes an image once per cacheKey() and
+ * references it from every page using it.
+ */
+class CardRenderer
+{
+public:
+    // Parts of paint(), timed separately for the debug overlay
+    enum Layer { BackgroundLayer, BorderLayer, NameBoxLayer, FooterLayer, TextBoxLayer, AttributeLayer, TextLayer, LayerCount };
+    enum TextField { CardNameText, CardTypeText, AbilityText, FlavorText, TextFieldCount };
+
+    // A text box of the layout, so it can be fitted apart from the renderer
+    struct TextRegion {
+        TextField field;
+        QRect rect;
+        QStringList blocks; // Only the abilities have more than one
+    };
+    struct TextImage {
+        QImage image;
+        QRectF rect;
+    };
+
+    explicit CardRenderer(const FModelSnapshotPtr &snapshot);
+
+    static QSize size() { return QSize(CARD_WIDTH, CARD_HEIGHT); }
+    static QRect rect() { return QRect(QPoint(0, 0), size()); }
+
+    // Model data and language the record is shown with
+    void setSnapshot(const FModelSnapshotPtr &snapshot);
+    const FModelSnapshotPtr &snapshot() const { return m_snapshot; }
+    const QString &countryCode() const { return m_snapshot->countryCode(); }
+
+    void setRecord(const CardRecord &record);
+    const CardRecord &record() const { return m_record; }
+
+    // Without text the renderer only lays out and draws the decorations,
+    // the texts are fitted from textRegions() and drawn with drawTextImages()
+    void setTextEnabled(bool enabled);
+    bool textEnabled() const { return m_textEnabled; }
+    QVector<TextRegion> textRegions() const;
+
+    void setFontFamily(TextField field, const QString &family);
+    void setVoidCostFont(const QFont &font);
+
+    void paint(QPainter *painter);
+    QImage render();
+    void invalidateText(); // Rasterize the texts again on the next paint
+
+    // One-off render, e.g. from a worker thread
+    static QImage renderRecord(const CardRecord &record, const FModelSnapshotPtr &snapshot);
+
+    static QFont textFont(TextField field); // From the settings, before fitting
+
+    // Everything but the record that changes the rendered image
+    static QByteArray fontKey();
+    // Sha256 of what a render of the record reads, hex encoded
+    static QByteArray contentHash(const CardRecord &record, const FModelSnapshot &snapshot, const QByteArray &fontKey);
+    static void setupTextBox(TextField field, FTextBox *box); // Default fonts and alignment
+    static TextImage fitTextRegion(const TextRegion &region, FTextBox *box);
+    static void drawTextImages(QPainter *painter, const QVector<TextImage> &images);
+
+    const FTextBox *textBox(TextField field) const { return &m_texts[field]; }
+    qint64 layerPaintTime(Layer layer) const { return m_layerNsecs[layer]; }
+    static const char *layerName(Layer layer);
+
+    static QImage decoration(const QString &filename);
+    static QImage mirrored(const QString &filename);
+    static QImage attributeIcon(const FModelSnapshot::Attribute *attribute);
+    static ImageCache *imageCache();
+
+private:
+    FModelSnapshotPtr m_snapshot;
+    CardRecord m_record;
+    bool m_hasRecord;
+    bool m_textEnabled;
+
+    QImage background;
+    QRect backgroundScale;
+    QImage cornerTL;
+    QImage cornerTR;
+    QImage costWheel;
+    QImage nameBoxL;
+    QImage nameBoxR;
+    QImage nameBoxM;
+    QImage borderVertical;
+    QImage borderHorizontal;
+    QImage footerBoxL;
+    QImage footerBoxR;
+    QImage footerBoxM;
+    QImage statsBox;
+    QVector<QImage> attributeIcons; // In the order of the record's attributes
+    QStringList attributeIconFiles; // Their SVGs, drawn instead on vector devices
+
+    QRect borderTopRect;
+    QRect borderRightRect;
+    QRect nameBoxRect;
+    QRect nameTextBoxRect; // adds padding
+    QRect footerBoxRect;
+    QRect borderLeftRect;
+    QRect borderLeftTopRect; // Above stats box
+    QRect borderLeftBotRect; // Below stats box
+    QRect textBoxRect;
+    QRect textBoxRectInner; // adds padding
+    QRect textBoxTopRectInner;
+    QRect textFlavorBox;
+
+    QPainterPath cardPath;
+    QPainterPath textBoxPath;
+
+    QPointF borderLeftBotOffset;
+    QPointF textBoxAttributeStartOffset;
+
+    QLinearGradient attributeNameGradient;
+    QLinearGradient attributeTextBoxGradient;
+
+    FTextBox m_texts[TextFieldCount];
+    QStringList m_abilities;
+
+    qint64 m_layerNsecs[LayerCount]; // Of the last paint
+
+    void finishLayer(Layer layer, QElapsedTimer &timer);
+
+    void updateDecorations();
+    void layoutNameBox();
+    void layoutTextBox();
+    void updateAttributeGradient();
+    void updateTexts(bool refitAbilities);
+    QStringList textBlocks(TextField field) const;
+    QRect textRect(TextField field) const;
+    const QString generateCardTypeText() const;
+
+    Q_DISABLE_COPY(CardRenderer)
+};
+
+#endif // CARDRENDERER_H
@@ -0,0 +1,52 @@
+#include <QMutexLocker>
+#include "imagecache.h"
+#include "renderstats.h"
+
+ImageCache::ImageCache(CacheCounter *counter, qint64 limitBytes)
+    : m_bytes(0), m_limitBytes(limitBytes), m_counter(counter)
+{
+}
+
+bool ImageCache::find(const QString &key, QImage *image) const
+{
+    QMutexLocker locker(&m_mutex);
+    QHash<QString, QImage>::const_iterator it = m_images.constFind(key);
+    if (it == m_images.constEnd()) {
+        if (m_counter) m_counter->miss();
+        return false;
+    }
+    if (m_counter) m_counter->hit();
+    *image = it.value();
+    return true;
+}
+
+void ImageCache::insert(const QString &key, const QImage &image)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_bytes + image.sizeInBytes() > m_limitBytes) {
+        m_images.clear();
+        m_bytes = 0;
+    }
+    QHash<QString, QImage>::iterator it = m_images.find(key);
+    if (it != m_images.end()) {
+        // Another thread rendered the same image in the meantime
+        m_bytes -= it->sizeInBytes();
+        *it = image;
+    } else {
+        m_images.insert(key, image);
+    }
+    m_bytes += image.sizeInBytes();
+}
+
+void ImageCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.clear();
+    m_bytes = 0;
+}
+
+qint64 ImageCache::bytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytes;
+}
@@ -0,0 +1,39 @@
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+
+class CacheCounter;
+
+/*!
+ * \brief QImage counterpart of QPixmapCache that can be shared between threads.
+ *
+ * QPixmapCache only works in the GUI thread. Images are implicitly shared,
+ * so find() hands out a cheap copy while the cache keeps its own. Once the
+ * images exceed the limit everything is dropped, the render caches refill
+ * within a card or two.
+ */
+class ImageCache
+{
+public:
+    ImageCache(CacheCounter *counter, qint64 limitBytes);
+
+    bool find(const QString &key, QImage *image) const;
+    void insert(const QString &key, const QImage &image);
+    void clear();
+
+    qint64 bytes() const;
+
+private:
+    mutable QMutex m_mutex;
+    QHash<QString, QImage> m_images;
+    qint64 m_bytes;
+    qint64 m_limitBytes;
+    CacheCounter *m_counter;
+
+    Q_DISABLE_COPY(ImageCache)
+};
+
+#endif // IMAGECACHE_H
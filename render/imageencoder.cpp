@@ -0,0 +1,155 @@
+#include <QRunnable>
+#include <QElapsedTimer>
+#include <QImageWriter>
+#include <QBuffer>
+#include <QSaveFile>
+#include "imageencoder.h"
+#include "archivewriter.h"
+#include "tracer.h"
+
+class EncodeTask : public QRunnable
+{
+public:
+    EncodeTask(ImageEncoder *encoder, const QImage &image, const QString &fileName)
+        : m_encoder(encoder), m_image(image), m_fileName(fileName) {}
+
+    void run() override
+    {
+        FTRACE_SCOPE(Export, "ImageEncoder task");
+        QElapsedTimer timer;
+        timer.start();
+        EncodedImage result;
+        result.fileName = m_fileName;
+        result.bytes = 0;
+
+        QByteArray data;
+        QString error;
+        if (ImageEncoder::encode(m_image, m_encoder->options(), &data, &error)) {
+            ArchiveWriter *archive = m_encoder->archive();
+            if (archive) {
+                if (!archive->addFile(m_fileName, data)) {
+                    error = archive->errorString();
+                } else {
+                    result.bytes = data.size();
+                }
+            } else {
+                QSaveFile file(m_fileName);
+                if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+                    error = QObject::tr("Could not write '%1'. (%2)").arg(m_fileName, file.errorString());
+                } else {
+                    result.bytes = data.size();
+                }
+            }
+        }
+        result.nsecs = timer.nsecsElapsed();
+        // The encoder waits for the pool in its destructor, so it outlives every task
+        m_encoder->finish(result, error);
+    }
+
+private:
+    ImageEncoder *m_encoder;
+    QImage m_image;
+    QString m_fileName;
+};
+
+ImageEncoder::ImageEncoder(const EncoderOptions &options, int threadCount)
+    : m_options(options), m_archive(nullptr), m_queueSlots(IMAGE_ENCODER_QUEUE_LIMIT)
+{
+    m_pool.setMaxThreadCount(qMax(1, threadCount));
+}
+
+ImageEncoder::~ImageEncoder()
+{
+    m_pool.waitForDone();
+}
+
+void ImageEncoder::encode(const QImage &image, const QString &fileName)
+{
+    m_queueSlots.acquire();
+    m_pool.start(new EncodeTask(this, image, fileName));
+}
+
+void ImageEncoder::finish(const EncodedImage &result, const QString &error)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (error.isEmpty()) {
+            m_results.append(result);
+        } else if (m_errorString.isEmpty()) {
+            m_errorString = error;
+        }
+    }
+    m_queueSlots.release();
+}
+
+bool ImageEncoder::waitForDone()
+{
+    m_pool.waitForDone();
+    QMutexLocker locker(&m_mutex);
+    return m_errorString.isEmpty();
+}
+
+const QString ImageEncoder::errorString()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_errorString;
+}
+
+const QVector<EncodedImage> ImageEncoder::results()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_results;
+}
+
+qint64 ImageEncoder::totalBytes()
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 bytes = 0;
+    QVector<EncodedImage>::const_iterator it = m_results.constBegin();
+    for (; it != m_results.constEnd(); ++it) {
+        bytes += it->bytes;
+    }
+    return bytes;
+}
+
+qint64 ImageEncoder::totalNsecs()
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 nsecs = 0;
+    QVector<EncodedImage>::const_iterator it = m_results.constBegin();
+    for (; it != m_results.constEnd(); ++it) {
+        nsecs += it->nsecs;
+    }
+    return nsecs;
+}
+
+/*!
+ * \brief Encodes an image with the options, the PNG compression is mapped onto the writer's quality.
+ */
+bool ImageEncoder::encode(const QImage &image, const EncoderOptions &options, QByteArray *data, QString *errorString)
+{
+    FTRACE_SCOPE(Export, "ImageEncoder::encode");
+    data->clear();
+    QBuffer buffer(data);
+    buffer.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buffer, options.format);
+    if (options.format.toLower() == "png") {
+        // Qt's PNG writer takes zlib level (100 - quality) * 9 / 91, so quality 100 writes uncompressed
+        const int level = qBound(0, options.compression, 9);
+        writer.setQuality(100 - (level * 91 + 8) / 9);
+    } else {
+        writer.setQuality(options.quality);
+    }
+    if (!writer.write(image)) {
+        *errorString = QObject::tr("Could not encode the image as '%1'. (%2)").arg(QString::fromLatin1(options.format), writer.errorString());
+        data->clear();
+        return false;
+    }
+    return true;
+}
+
+const QString ImageEncoder::fileExtension(const QByteArray &format)
+{
+    const QString extension = QString::fromLatin1(format).toLower();
+    return extension == "jpeg" ? QStringLiteral("jpg") : extension;
+}
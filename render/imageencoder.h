@@ -0,0 +1,87 @@
+#ifndef IMAGEENCODER_H
+#define IMAGEENCODER_H
+
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QMutex>
+#include <QImage>
+#include <QVector>
+
+class ArchiveWriter;
+
+#define IMAGE_ENCODER_QUEUE_LIMIT 8 // Images waiting or being encoded, encode() blocks beyond
+
+struct EncoderOptions
+{
+    EncoderOptions() : format("png"), compression(6), quality(-1) {}
+
+    QByteArray format; // png, webp, jpg or anything else QImageWriter supports
+    int compression;   // zlib level 0-9 of PNG, 9 is the smallest and slowest
+    int quality;       // 0-100 of WebP and JPEG, -1 for the format's default
+};
+
+// What encoding one image took
+struct EncodedImage
+{
+    QString fileName;
+    qint64 bytes;
+    qint64 nsecs;
+};
+
+/*!
+ * \brief Encodes images to files on its own thread pool.
+ *
+ * Rendering keeps its threads busy with painting, so the encoder does not
+ * share them: encode() queues an image and returns, and the caller renders
+ * the next one while this one is compressed. At most
+ * IMAGE_ENCODER_QUEUE_LIMIT images are queued, a caller rendering faster
+ * than the images are encoded waits in encode() instead of piling up
+ * memory.
+ *
+ * Files are written through QSaveFile, or streamed into an ArchiveWriter
+ * as soon as each image is encoded. Encoding time and size of every image
+ * are kept for results().
+ */
+class ImageEncoder
+{
+public:
+    explicit ImageEncoder(const EncoderOptions &options = EncoderOptions(), int threadCount = QThread::idealThreadCount());
+    ~ImageEncoder(); // Waits for the queued images
+
+    const EncoderOptions &options() const { return m_options; }
+
+    // Adds the images to the archive under their file names instead of writing files
+    void setArchive(ArchiveWriter *archive) { m_archive = archive; }
+    ArchiveWriter *archive() const { return m_archive; }
+    QThreadPool *threadPool() { return &m_pool; }
+
+    void encode(const QImage &image, const QString &fileName);
+    bool waitForDone(); // False if any image failed, see errorString()
+    const QString errorString();
+
+    // In the order the images finished
+    const QVector<EncodedImage> results();
+    qint64 totalBytes();
+    qint64 totalNsecs();
+
+    // Encodes on the calling thread
+    static bool encode(const QImage &image, const EncoderOptions &options, QByteArray *data, QString *errorString);
+    static const QString fileExtension(const QByteArray &format);
+
+private:
+    friend class EncodeTask;
+
+    EncoderOptions m_options;
+    ArchiveWriter *m_archive;
+    QThreadPool m_pool;
+    QSemaphore m_queueSlots;
+    QMutex m_mutex; // Guards the results and the error, tasks finish on the pool threads
+    QVector<EncodedImage> m_results;
+    QString m_errorString;
+
+    void finish(const EncodedImage &result, const QString &error);
+
+    Q_DISABLE_COPY(ImageEncoder)
+};
+
+#endif // IMAGEENCODER_H
@@ -0,0 +1,226 @@
+#include <QCoreApplication>
+#include <QPdfWriter>
+#include <QSaveFile>
+#include <QSemaphore>
+#include <QDir>
+#include "printsheetexporter.h"
+#include "batchrenderer.h"
+#include "cardrenderer.h"
+#include "workstealingscheduler.h"
+#include "cardset/cardsetfile.h"
+#include "tracer.h"
+
+PrintSheetExporter::PrintSheetExporter(WorkStealingScheduler *scheduler, const FModelSnapshotPtr &snapshot, const PrintSheetOptions &options)
+    : m_scheduler(scheduler), m_snapshot(snapshot), m_options(options), m_pagesInFlight(scheduler->workerCount())
+{
+}
+
+QSize PrintSheetExporter::pageSize() const
+{
+    return m_options.pageSize.sizePixels(m_options.dpi);
+}
+
+QSize PrintSheetExporter::cardSize() const
+{
+    return QSize(toPixels(PRINT_SHEET_CARD_WIDTH_MM), toPixels(PRINT_SHEET_CARD_HEIGHT_MM));
+}
+
+/*!
+ * \brief The rect of a slot, row by row. The cards touch so one cut separates two of them.
+ */
+QRect PrintSheetExporter::cardRect(int slot) const
+{
+    const QSize card = cardSize();
+    const QSize page = pageSize();
+    const QPoint origin((page.width() - card.width() * m_options.columns) / 2, (page.height() - card.height() * m_options.rows) / 2);
+    return QRect(origin + QPoint(slot % m_options.columns * card.width(), slot / m_options.columns * card.height()), card);
+}
+
+QVector<QLineF> PrintSheetExporter::cropMarks() const
+{
+    QVector<QLineF> marks;
+    const QRect grid = cardRect(0).united(cardRect(m_options.cardsPerPage() - 1));
+    const qreal gap = toPixels(PRINT_SHEET_CROP_MARK_GAP_MM);
+    const qreal length = toPixels(PRINT_SHEET_CROP_MARK_MM);
+    const qreal left = grid.x(), top = grid.y();
+    const qreal right = left + grid.width(), bottom = top + grid.height();
+
+    for (int column = 0; column <= m_options.columns; ++column) {
+        const qreal x = left + column * cardSize().width();
+        marks.append(QLineF(x, top - gap - length, x, top - gap));
+        marks.append(QLineF(x, bottom + gap, x, bottom + gap + length));
+    }
+    for (int row = 0; row <= m_options.rows; ++row) {
+        const qreal y = top + row * cardSize().height();
+        marks.append(QLineF(left - gap - length, y, left - gap, y));
+        marks.append(QLineF(right + gap, y, right + gap + length, y));
+    }
+    return marks;
+}
+
+void PrintSheetExporter::drawPage(QPainter *painter, const Page &cards) const
+{
+    for (int slot = 0; slot < cards.size(); ++slot) {
+        painter->drawImage(cardRect(slot), cards.at(slot));
+    }
+    drawCropMarks(painter);
+}
+
+void PrintSheetExporter::drawCropMarks(QPainter *painter) const
+{
+    if (m_options.cropMarks) {
+        painter->setPen(QPen(Qt::black, cropMarkWidth()));
+        painter->drawLines(cropMarks());
+    }
+}
+
+/*!
+ * \brief Renders pagesInFlight() pages at a time and hands them to the writer in order.
+ */
+bool PrintSheetExporter::exportPages(const CardSetReader &reader, const WindowWriter &writeWindow)
+{
+    m_errorString.clear();
+    const int perPage = m_options.cardsPerPage();
+    const int pages = pageCount(reader.cardCount());
+    BatchRenderer renderer(m_scheduler, m_snapshot);
+
+    for (int firstPage = 0; firstPage < pages; firstPage += m_pagesInFlight) {
+        const int firstCard = firstPage * perPage;
+        const int cardCount = qMin(m_pagesInFlight * perPage, reader.cardCount() - firstCard);
+        QVector<CardRecord> records;
+        records.reserve(cardCount);
+        for (int i = 0; i < cardCount; ++i) {
+            records.append(reader.card(firstCard + i));
+        }
+
+        const QVector<QImage> images = renderer.renderImages(records, cardSize());
+        QVector<Page> window;
+        for (int first = 0; first < images.size(); first += perPage) {
+            window.append(images.mid(first, perPage));
+        }
+        if (!writeWindow(firstPage, window)) {
+            return false;
+        }
+        qInfo(qUtf8Printable(QObject::tr("Exported %1 of %2 pages.").arg(firstPage + window.size()).arg(pages)));
+    }
+    return true;
+}
+
+/*!
+ * \brief Paints every card into the PDF at its slot, one after another since QPdfWriter is not thread safe.
+ */
+bool PrintSheetExporter::exportVectorPages(const CardSetReader &reader, QPdfWriter *writer, QPainter *painter)
+{
+    m_errorString.clear();
+    const int perPage = m_options.cardsPerPage();
+    const int pages = pageCount(reader.cardCount());
+    CardRenderer renderer(m_snapshot);
+
+    for (int page = 0; page < pages; ++page) {
+        if (page > 0) writer->newPage();
+        const int firstCard = page * perPage;
+        for (int slot = 0; slot < perPage && firstCard + slot < reader.cardCount(); ++slot) {
+            FTRACE_SCOPE(Export, "PrintSheetExporter vector card");
+            renderer.setRecord(reader.card(firstCard + slot));
+            const QRect rect = cardRect(slot);
+            painter->save();
+            painter->translate(rect.topLeft());
+            painter->scale(qreal(rect.width()) / CARD_WIDTH, qreal(rect.height()) / CARD_HEIGHT);
+            renderer.paint(painter);
+            painter->restore();
+        }
+        drawCropMarks(painter);
+        if ((page + 1) % m_pagesInFlight == 0 || page + 1 == pages) {
+            qInfo(qUtf8Printable(QObject::tr("Exported %1 of %2 pages.").arg(page + 1).arg(pages)));
+        }
+    }
+    return true;
+}
+
+bool PrintSheetExporter::exportPdf(const CardSetReader &reader, const QString &fileName)
+{
+    FTRACE_SCOPE(Export, "PrintSheetExporter::exportPdf");
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_errorString = QObject::tr("Could not write '%1'. (%2)").arg(fileName, file.errorString());
+        return false;
+    }
+
+    // The writer streams every page to the file as it is finished
+    QPdfWriter writer(&file);
+    writer.setCreator(QCoreApplication::applicationName());
+    writer.setResolution(m_options.dpi);
+    writer.setPageSize(m_options.pageSize);
+    writer.setPageMargins(QMarginsF(0, 0, 0, 0));
+    QPainter painter;
+    if (!painter.begin(&writer)) {
+        m_errorString = QObject::tr("Could not write '%1'.").arg(fileName);
+        file.cancelWriting();
+        return false;
+    }
+
+    const bool exported = m_options.vector ? exportVectorPages(reader, &writer, &painter)
+                                           : exportPages(reader, [this, &writer, &painter](int firstPage, const QVector<Page> &pages) {
+        for (int i = 0; i < pages.size(); ++i) {
+            if (firstPage + i > 0) writer.newPage();
+            drawPage(&painter, pages.at(i));
+        }
+        return true;
+    });
+    painter.end();
+    if (!exported) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        m_errorString = QObject::tr("Could not write '%1'. (%2)").arg(fileName, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool PrintSheetExporter::exportPng(const CardSetReader &reader, const QString &directory)
+{
+    FTRACE_SCOPE(Export, "PrintSheetExporter::exportPng");
+    const QDir dir(directory);
+    if (!dir.mkpath(".")) {
+        m_errorString = QObject::tr("Could not create the output directory '%1'.").arg(directory);
+        return false;
+    }
+
+    return exportPages(reader, [this, dir](int firstPage, const QVector<Page> &pages) {
+        // Composing and compressing a page is as slow as rendering a card, do them in parallel too
+        QSemaphore done;
+        for (int i = 0; i < pages.size(); ++i) {
+            const Page cards = pages.at(i);
+            const QString fileName = dir.filePath(QString("page-%1.png").arg(firstPage + i + 1, 4, 10, QChar('0')));
+            m_scheduler->submit([this, cards, fileName, &done]() {
+                FTRACE_SCOPE(Export, "PrintSheetExporter page");
+                QImage page(pageSize(), QImage::Format_RGB32);
+                page.fill(Qt::white);
+                page.setDotsPerMeterX(qRound(m_options.dpi / 0.0254));
+                page.setDotsPerMeterY(qRound(m_options.dpi / 0.0254));
+                QPainter painter(&page);
+                painter.setRenderHint(QPainter::Antialiasing);
+                drawPage(&painter, cards);
+                painter.end();
+
+                QSaveFile file(fileName);
+                if (!file.open(QIODevice::WriteOnly) || !page.save(&file, "png") || !file.commit()) {
+                    setError(QObject::tr("Could not write '%1'. (%2)").arg(fileName, file.errorString()));
+                }
+                done.release();
+            });
+        }
+        done.acquire(pages.size());
+
+        QMutexLocker locker(&m_errorMutex);
+        return m_errorString.isEmpty();
+    });
+}
+
+void PrintSheetExporter::setError(const QString &error)
+{
+    QMutexLocker locker(&m_errorMutex);
+    if (m_errorString.isEmpty()) m_errorString = error;
+}
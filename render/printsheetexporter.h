@@ -0,0 +1,92 @@
+#ifndef PRINTSHEETEXPORTER_H
+#define PRINTSHEETEXPORTER_H
+
+#include <QVector>
+#include <QImage>
+#include <QLineF>
+#include <QPageSize>
+#include <QMutex>
+#include <QPainter>
+#include <functional>
+#include "models/fmodelsnapshot.h"
+
+class CardSetReader;
+class QPdfWriter;
+class WorkStealingScheduler;
+
+#define PRINT_SHEET_CARD_WIDTH_MM 63.0
+#define PRINT_SHEET_CARD_HEIGHT_MM 88.0
+#define PRINT_SHEET_CROP_MARK_MM 5.0     // Length of a mark
+#define PRINT_SHEET_CROP_MARK_GAP_MM 1.0 // Between the cards and the marks
+
+struct PrintSheetOptions
+{
+    PrintSheetOptions() : dpi(300), columns(3), rows(3), pageSize(QPageSize::A4), cropMarks(true), vector(false) {}
+
+    int cardsPerPage() const { return columns * rows; }
+
+    int dpi;
+    int columns;
+    int rows;
+    QPageSize pageSize;
+    bool cropMarks;
+    bool vector; // PDF only, see exportPdf()
+};
+
+/*!
+ * \brief Imposes the sides of a set onto printable pages, by default 3x3 cards on A4.
+ *
+ * Pages are rendered a window at a time: the sides of the next pages are
+ * rendered by a BatchRenderer at their printed size, then the pages are
+ * written in order. Only the window is held in memory, so peak memory
+ * depends on pagesInFlight() and not on the size of the set.
+ *
+ * A PDF gets one page per sheet with the cards as images and the crop marks
+ * as lines. PNG pages are composed and saved on the scheduler as well.
+ *
+ * With the vector option the cards are painted straight into the PDF on the
+ * calling thread instead: text as glyphs of subset fonts, symbols as paths
+ * and each decoration image written once and referenced by every card, so
+ * the file stays small and sharp at any zoom.
+ */
+class PrintSheetExporter
+{
+public:
+    PrintSheetExporter(WorkStealingScheduler *scheduler, const FModelSnapshotPtr &snapshot, const PrintSheetOptions &options = PrintSheetOptions());
+
+    int pagesInFlight() const { return m_pagesInFlight; }
+    void setPagesInFlight(int pages) { m_pagesInFlight = qMax(1, pages); }
+
+    bool exportPdf(const CardSetReader &reader, const QString &fileName);
+    bool exportPng(const CardSetReader &reader, const QString &directory); // page-0001.png and so on
+    const QString errorString() const { return m_errorString; }
+
+    int pageCount(int cards) const { return (cards + m_options.cardsPerPage() - 1) / m_options.cardsPerPage(); }
+
+    // The layout in pixels at the chosen resolution
+    QSize pageSize() const;
+    QSize cardSize() const;
+    QRect cardRect(int slot) const;
+    QVector<QLineF> cropMarks() const;
+    qreal cropMarkWidth() const { return m_options.dpi / 288.0; } // A quarter point
+
+private:
+    typedef QVector<QImage> Page; // The cards of one page
+    typedef std::function<bool(int firstPage, const QVector<Page> &pages)> WindowWriter;
+
+    WorkStealingScheduler *m_scheduler;
+    FModelSnapshotPtr m_snapshot;
+    PrintSheetOptions m_options;
+    int m_pagesInFlight;
+    QString m_errorString;
+    QMutex m_errorMutex; // Page tasks report errors from workers
+
+    int toPixels(qreal mm) const { return qRound(mm / 25.4 * m_options.dpi); }
+    bool exportPages(const CardSetReader &reader, const WindowWriter &writeWindow);
+    bool exportVectorPages(const CardSetReader &reader, QPdfWriter *writer, QPainter *painter);
+    void drawPage(QPainter *painter, const Page &cards) const;
+    void drawCropMarks(QPainter *painter) const;
+    void setError(const QString &error);
+};
+
+#endif // PRINTSHEETEXPORTER_H
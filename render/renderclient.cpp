@@ -0,0 +1,74 @@
+#include "renderclient.h"
+#include "renderservice.h"
+
+DaemonRenderClient::DaemonRenderClient(QObject *parent) : RenderClient(parent)
+{
+    QObject::connect(&m_socket, &QLocalSocket::readyRead, this, &DaemonRenderClient::readResults);
+    QObject::connect(&m_socket, QOverload<QLocalSocket::LocalSocketError>::of(&QLocalSocket::error), this, &DaemonRenderClient::socketError);
+}
+
+bool DaemonRenderClient::connectToDaemon(const QString &name, int msecs)
+{
+    m_socket.connectToServer(name);
+    return m_socket.waitForConnected(msecs);
+}
+
+void DaemonRenderClient::disconnectFromDaemon()
+{
+    m_socket.disconnectFromServer();
+}
+
+void DaemonRenderClient::submit(const RenderJob &job)
+{
+    if (!isConnected()) {
+        RenderResult result;
+        result.id = job.id;
+        result.errorString = tr("Not connected to a render daemon.");
+        emit finished(result);
+        return;
+    }
+    QDataStream out(&m_socket);
+    out.setVersion(RENDER_STREAM_VERSION);
+    out << quint32(RENDER_PROTOCOL_MAGIC) << quint16(RENDER_PROTOCOL_VERSION) << job;
+}
+
+void DaemonRenderClient::readResults()
+{
+    QDataStream in(&m_socket);
+    in.setVersion(RENDER_STREAM_VERSION);
+    forever {
+        in.startTransaction();
+        quint32 magic = 0;
+        quint16 version = 0;
+        in >> magic >> version;
+        if (in.status() == QDataStream::Ok && (magic != RENDER_PROTOCOL_MAGIC || version != RENDER_PROTOCOL_VERSION)) {
+            in.abortTransaction();
+            emit error(tr("The render daemon speaks protocol %1, expected %2.").arg(version).arg(RENDER_PROTOCOL_VERSION));
+            m_socket.disconnectFromServer();
+            return;
+        }
+        RenderResult result;
+        in >> result;
+        if (!in.commitTransaction()) {
+            return;
+        }
+        emit finished(result);
+    }
+}
+
+void DaemonRenderClient::socketError(QLocalSocket::LocalSocketError /*socketError*/)
+{
+    emit error(m_socket.errorString());
+}
+
+InProcessRenderClient::InProcessRenderClient(const QString &defaultCountryCode, QObject *parent)
+    : RenderClient(parent), m_service(new RenderService(this))
+{
+    m_service->setDefaultCountryCode(defaultCountryCode);
+    QObject::connect(m_service, &RenderService::finished, this, &RenderClient::finished);
+}
+
+void InProcessRenderClient::submit(const RenderJob &job)
+{
+    m_service->submit(job);
+}
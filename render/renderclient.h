@@ -0,0 +1,64 @@
+#ifndef RENDERCLIENT_H
+#define RENDERCLIENT_H
+
+#include <QObject>
+#include <QLocalSocket>
+#include "renderjob.h"
+
+class RenderService;
+
+/*!
+ * \brief Submits RenderJobs, results come back through finished().
+ *
+ * DaemonRenderClient talks to a running "FOWCE --render-daemon <name>",
+ * InProcessRenderClient renders in the calling process with the same
+ * protocol types, for tools and tests that should not depend on a daemon.
+ */
+class RenderClient : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RenderClient(QObject *parent = nullptr) : QObject(parent) {}
+
+    virtual void submit(const RenderJob &job) = 0;
+
+signals:
+    void finished(const RenderResult &result);
+    void error(const QString &errorString);
+};
+
+class DaemonRenderClient : public RenderClient
+{
+    Q_OBJECT
+public:
+    explicit DaemonRenderClient(QObject *parent = nullptr);
+
+    bool connectToDaemon(const QString &name, int msecs = 5000);
+    void disconnectFromDaemon();
+    bool isConnected() const { return m_socket.state() == QLocalSocket::ConnectedState; }
+    const QString errorString() const { return m_socket.errorString(); }
+
+    void submit(const RenderJob &job) override;
+
+private slots:
+    void readResults();
+    void socketError(QLocalSocket::LocalSocketError socketError);
+
+private:
+    QLocalSocket m_socket;
+};
+
+class InProcessRenderClient : public RenderClient
+{
+    Q_OBJECT
+public:
+    // Uses the models loaded in this process, like the daemon does with its own
+    explicit InProcessRenderClient(const QString &defaultCountryCode, QObject *parent = nullptr);
+
+    void submit(const RenderJob &job) override;
+
+private:
+    RenderService *m_service;
+};
+
+#endif // RENDERCLIENT_H
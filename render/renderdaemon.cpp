@@ -0,0 +1,40 @@
+#include "renderdaemon.h"
+#include "renderservice.h"
+#include "renderserver.h"
+#include "models/fmodels.h"
+#include "models/flanguagemodel.h"
+#include "models/fdatawatcher.h"
+#include "models/fwillcharacteristicmodel.h"
+#include "models/fattributemodel.h"
+#include "models/fgeneralcardtypemodel.h"
+#include "models/fcardtypemodel.h"
+#include "models/fraritymodel.h"
+
+RenderDaemon::RenderDaemon(QObject *parent) : QObject(parent)
+{
+    m_models = new FModels(this);
+    m_models->loadAllTexts();
+
+    m_service = new RenderService(this);
+    m_service->setDefaultCountryCode(m_models->languageModel()->selectedLanguage()->countryCode());
+    m_server = new RenderServer(m_service, this);
+
+    m_dataWatcher = new FDataWatcher(this);
+    m_dataWatcher->addModel(m_models->characteristicModel());
+    m_dataWatcher->addModel(m_models->attributeModel());
+    m_dataWatcher->addModel(m_models->generalCardTypeModel());
+    m_dataWatcher->addModel(m_models->cardTypeModel());
+    m_dataWatcher->addModel(m_models->rarityModel());
+    QObject::connect(m_dataWatcher, &FDataWatcher::modelsReloaded, m_service, &RenderService::invalidateSnapshots);
+}
+
+bool RenderDaemon::start(const QString &name)
+{
+    m_service->warmUp();
+    if (!m_server->listen(name)) {
+        m_errorString = tr("Could not listen on '%1'. (%2)").arg(name, m_server->errorString());
+        return false;
+    }
+    qInfo(qUtf8Printable(tr("Render daemon listening on '%1' with %2 threads.").arg(m_server->fullServerName()).arg(m_service->threadPool()->maxThreadCount())));
+    return true;
+}
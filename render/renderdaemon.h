@@ -0,0 +1,36 @@
+#ifndef RENDERDAEMON_H
+#define RENDERDAEMON_H
+
+#include <QObject>
+
+class FModels;
+class FDataWatcher;
+class RenderService;
+class RenderServer;
+
+/*!
+ * \brief The "--render-daemon" mode of FOWCE, a RenderServer without the editor.
+ *
+ * Loads the models with the texts of every language once and renders a
+ * card before listening, so the first job already finds the font database,
+ * the decorations and the symbols warm. Edited data files are reloaded and
+ * the following jobs render with the new snapshot.
+ */
+class RenderDaemon : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RenderDaemon(QObject *parent = nullptr);
+
+    bool start(const QString &name);
+    const QString errorString() const { return m_errorString; }
+
+private:
+    FModels *m_models;
+    FDataWatcher *m_dataWatcher;
+    RenderService *m_service;
+    RenderServer *m_server;
+    QString m_errorString;
+};
+
+#endif // RENDERDAEMON_H
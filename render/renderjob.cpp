@@ -0,0 +1,41 @@
+#include "renderjob.h"
+
+QDataStream &operator<<(QDataStream &out, const RenderOutput &output)
+{
+    out << output.format << qint32(output.quality) << qint32(output.width);
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, RenderOutput &output)
+{
+    qint32 quality = -1;
+    qint32 width = 0;
+    in >> output.format >> quality >> width;
+    output.quality = quality;
+    output.width = width;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const RenderJob &job)
+{
+    out << job.id << job.countryCode << job.record << job.output;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, RenderJob &job)
+{
+    in >> job.id >> job.countryCode >> job.record >> job.output;
+    return in;
+}
+
+QDataStream &operator<<(QDataStream &out, const RenderResult &result)
+{
+    out << result.id << result.errorString << result.data << result.renderNsecs;
+    return out;
+}
+
+QDataStream &operator>>(QDataStream &in, RenderResult &result)
+{
+    in >> result.id >> result.errorString >> result.data >> result.renderNsecs;
+    return in;
+}
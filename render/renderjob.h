@@ -0,0 +1,64 @@
+#ifndef RENDERJOB_H
+#define RENDERJOB_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QMetaType>
+#include "cardrecord.h"
+
+// Every message on the daemon socket starts with magic and version,
+// followed by a RenderJob (client to daemon) or a RenderResult (back)
+#define RENDER_PROTOCOL_MAGIC 0x52574F46 // "FOWR"
+#define RENDER_PROTOCOL_VERSION 1
+#define RENDER_STREAM_VERSION QDataStream::Qt_5_9
+
+/*!
+ * \brief How a rendered card is handed back.
+ */
+struct RenderOutput
+{
+    RenderOutput() : format("png"), quality(-1), width(0) {}
+
+    QByteArray format; // Any format QImageWriter supports
+    int quality;       // -1 for the format's default
+    int width;         // Scaled keeping the aspect ratio, 0 for the full CARD_WIDTH
+};
+
+/*!
+ * \brief A card to render and what to do with the image.
+ *
+ * Model ids in the record are the ones of the data the daemon loaded, so
+ * clients need to use the same data directory.
+ */
+struct RenderJob
+{
+    RenderJob() : id(0) {}
+
+    quint32 id;          // Chosen by the client, echoed in the result
+    QString countryCode; // Empty for the default language
+    CardRecord record;
+    RenderOutput output;
+};
+
+struct RenderResult
+{
+    RenderResult() : id(0), renderNsecs(0) {}
+
+    bool isValid() const { return errorString.isNull(); }
+
+    quint32 id;
+    QString errorString; // Null on success
+    QByteArray data;     // Encoded in the job's output format
+    qint64 renderNsecs;
+};
+
+Q_DECLARE_METATYPE(RenderResult)
+
+QDataStream &operator<<(QDataStream &out, const RenderOutput &output);
+QDataStream &operator>>(QDataStream &in, RenderOutput &output);
+QDataStream &operator<<(QDataStream &out, const RenderJob &job);
+QDataStream &operator>>(QDataStream &in, RenderJob &job);
+QDataStream &operator<<(QDataStream &out, const RenderResult &result);
+QDataStream &operator>>(QDataStream &in, RenderResult &result);
+
+#endif // RENDERJOB_H
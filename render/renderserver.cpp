@@ -0,0 +1,76 @@
+#include "renderserver.h"
+#include "renderservice.h"
+
+RenderServer::RenderServer(RenderService *service, QObject *parent)
+    : QObject(parent), m_service(service), m_nextJobId(1)
+{
+    QObject::connect(&m_server, &QLocalServer::newConnection, this, &RenderServer::acceptConnections);
+    QObject::connect(m_service, &RenderService::finished, this, &RenderServer::sendResult);
+}
+
+bool RenderServer::listen(const QString &name)
+{
+    // A daemon that crashed leaves its socket file behind
+    QLocalServer::removeServer(name);
+    m_server.setSocketOptions(QLocalServer::UserAccessOption);
+    return m_server.listen(name);
+}
+
+void RenderServer::acceptConnections()
+{
+    while (m_server.hasPendingConnections()) {
+        QLocalSocket *socket = m_server.nextPendingConnection();
+        QObject::connect(socket, &QLocalSocket::readyRead, this, &RenderServer::readJobs);
+        QObject::connect(socket, &QLocalSocket::disconnected, socket, &QLocalSocket::deleteLater);
+    }
+}
+
+void RenderServer::readJobs()
+{
+    QLocalSocket *socket = qobject_cast<QLocalSocket*>(sender());
+    if (!socket) return;
+
+    QDataStream in(socket);
+    in.setVersion(RENDER_STREAM_VERSION);
+    forever {
+        in.startTransaction();
+        quint32 magic = 0;
+        quint16 version = 0;
+        in >> magic >> version;
+        if (in.status() == QDataStream::Ok && (magic != RENDER_PROTOCOL_MAGIC || version != RENDER_PROTOCOL_VERSION)) {
+            in.abortTransaction();
+            qWarning(qUtf8Printable(tr("Dropping render client speaking protocol %1, expected %2.").arg(version).arg(RENDER_PROTOCOL_VERSION)));
+            socket->disconnectFromServer();
+            return;
+        }
+        RenderJob job;
+        in >> job;
+        if (!in.commitTransaction()) {
+            return; // Wait for the rest of the job
+        }
+
+        PendingJob pending;
+        pending.socket = socket;
+        pending.clientId = job.id;
+        job.id = m_nextJobId++;
+        m_pending.insert(job.id, pending);
+        m_service->submit(job);
+    }
+}
+
+void RenderServer::sendResult(const RenderResult &result)
+{
+    QHash<quint32, PendingJob>::iterator it = m_pending.find(result.id);
+    if (it == m_pending.end()) return;
+    const PendingJob pending = it.value();
+    m_pending.erase(it);
+    if (!pending.socket || pending.socket->state() != QLocalSocket::ConnectedState) {
+        return; // Client went away, drop the image
+    }
+
+    RenderResult clientResult = result;
+    clientResult.id = pending.clientId;
+    QDataStream out(pending.socket.data());
+    out.setVersion(RENDER_STREAM_VERSION);
+    out << quint32(RENDER_PROTOCOL_MAGIC) << quint16(RENDER_PROTOCOL_VERSION) << clientResult;
+}
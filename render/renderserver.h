@@ -0,0 +1,48 @@
+#ifndef RENDERSERVER_H
+#define RENDERSERVER_H
+
+#include <QObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QHash>
+#include "renderjob.h"
+
+class RenderService;
+
+/*!
+ * \brief Accepts RenderJobs on a local socket and streams the results back.
+ *
+ * Any number of clients can connect. Results are written as soon as they
+ * are done, so they arrive in completion order and clients match them by
+ * their job id. There is no network access, only a local socket (a unix
+ * domain socket or a named pipe).
+ */
+class RenderServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RenderServer(RenderService *service, QObject *parent = nullptr);
+
+    bool listen(const QString &name);
+    const QString errorString() const { return m_server.errorString(); }
+    const QString fullServerName() const { return m_server.fullServerName(); }
+
+private slots:
+    void acceptConnections();
+    void readJobs();
+    void sendResult(const RenderResult &result);
+
+private:
+    struct PendingJob {
+        QPointer<QLocalSocket> socket;
+        quint32 clientId;
+    };
+
+    QLocalServer m_server;
+    RenderService *m_service;
+    quint32 m_nextJobId;
+    QHash<quint32, PendingJob> m_pending; // Clients choose their ids, the service sees ours
+};
+
+#endif // RENDERSERVER_H
@@ -0,0 +1,123 @@
+#include <QRunnable>
+#include <QThreadStorage>
+#include <QElapsedTimer>
+#include <QImageWriter>
+#include <QBuffer>
+#include "renderservice.h"
+#include "cardrenderer.h"
+#include "tracer.h"
+
+static QThreadStorage<CardRenderer*> s_renderers;
+
+class RenderTask : public QRunnable
+{
+public:
+    RenderTask(RenderService *service, const RenderJob &job, const FModelSnapshotPtr &snapshot)
+        : m_service(service), m_job(job), m_snapshot(snapshot) {}
+
+    void run() override
+    {
+        // The service waits for the pool in its destructor, so it outlives every task
+        emit m_service->finished(RenderService::run(m_job, m_snapshot));
+    }
+
+private:
+    RenderService *m_service;
+    RenderJob m_job;
+    FModelSnapshotPtr m_snapshot;
+};
+
+RenderService::RenderService(QObject *parent) : QObject(parent)
+{
+    qRegisterMetaType<RenderResult>();
+}
+
+RenderService::~RenderService()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+void RenderService::submit(const RenderJob &job)
+{
+    const FModelSnapshotPtr jobSnapshot = snapshot(job.countryCode.isEmpty() ? m_defaultCountryCode : job.countryCode);
+    if (!jobSnapshot->language(jobSnapshot->countryCode())) {
+        RenderResult result;
+        result.id = job.id;
+        result.errorString = tr("Unknown language '%1'.").arg(jobSnapshot->countryCode());
+        emit finished(result);
+        return;
+    }
+    m_pool.start(new RenderTask(this, job, jobSnapshot));
+}
+
+void RenderService::warmUp()
+{
+    FTRACE_SCOPE(Export, "RenderService::warmUp");
+    CardRenderer::renderRecord(CardRecord(), snapshot(m_defaultCountryCode));
+}
+
+void RenderService::invalidateSnapshots()
+{
+    m_snapshots.clear();
+}
+
+FModelSnapshotPtr RenderService::snapshot(const QString &countryCode)
+{
+    QHash<QString, FModelSnapshotPtr>::const_iterator it = m_snapshots.constFind(countryCode);
+    if (it != m_snapshots.constEnd()) {
+        return it.value();
+    }
+    const FModelSnapshotPtr captured = FModelSnapshot::capture(countryCode);
+    if (captured->language(countryCode)) {
+        m_snapshots.insert(countryCode, captured);
+    }
+    return captured;
+}
+
+/*!
+ * \brief Renders and encodes a job with this thread's renderer.
+ */
+RenderResult RenderService::run(const RenderJob &job, const FModelSnapshotPtr &snapshot)
+{
+    FTRACE_SCOPE(Export, "RenderService::run");
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!s_renderers.hasLocalData()) {
+        s_renderers.setLocalData(new CardRenderer(snapshot));
+    }
+    CardRenderer *renderer = s_renderers.localData();
+    renderer->setSnapshot(snapshot);
+    renderer->setRecord(job.record);
+
+    RenderResult result;
+    result.id = job.id;
+    encode(renderer->render(), job.output, &result);
+    result.renderNsecs = timer.nsecsElapsed();
+    return result;
+}
+
+/*!
+ * \brief Scales and encodes a rendered card as the output asks for.
+ */
+bool RenderService::encode(const QImage &card, const RenderOutput &output, RenderResult *result)
+{
+    FTRACE_SCOPE(Export, "RenderService::encode");
+    QImage image = card;
+    if (output.width > 0 && output.width != image.width()) {
+        image = image.scaledToWidth(output.width, Qt::SmoothTransformation);
+    }
+
+    result->data.clear();
+    QBuffer buffer(&result->data);
+    buffer.open(QIODevice::WriteOnly);
+    QImageWriter writer(&buffer, output.format);
+    writer.setQuality(output.quality);
+    if (!writer.write(image)) {
+        result->errorString = tr("Could not encode the card as '%1'. (%2)").arg(QString::fromLatin1(output.format), writer.errorString());
+        result->data.clear();
+        return false;
+    }
+    return true;
+}
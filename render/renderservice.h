@@ -0,0 +1,50 @@
+#ifndef RENDERSERVICE_H
+#define RENDERSERVICE_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QHash>
+#include "renderjob.h"
+#include "models/fmodelsnapshot.h"
+
+/*!
+ * \brief Renders and encodes RenderJobs on its own thread pool.
+ *
+ * Each pool thread keeps a CardRenderer, so text documents and layouts stay
+ * allocated between jobs, and the decoration and symbol caches are shared
+ * by all of them. Snapshots are captured once per language on first use.
+ *
+ * submit() has to be called from the thread the models live in, finished()
+ * is emitted from the pool threads and queued to the receivers.
+ */
+class RenderService : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RenderService(QObject *parent = nullptr);
+    ~RenderService();
+
+    void setDefaultCountryCode(const QString &countryCode) { m_defaultCountryCode = countryCode; }
+    const QString &defaultCountryCode() const { return m_defaultCountryCode; }
+
+    void submit(const RenderJob &job);
+    void warmUp(); // Renders an empty card, fills the shared caches and the font database
+    void invalidateSnapshots(); // Call after the models changed
+
+    QThreadPool *threadPool() { return &m_pool; }
+
+    static RenderResult run(const RenderJob &job, const FModelSnapshotPtr &snapshot);
+    static bool encode(const QImage &card, const RenderOutput &output, RenderResult *result);
+
+signals:
+    void finished(const RenderResult &result);
+
+private:
+    QThreadPool m_pool;
+    QString m_defaultCountryCode;
+    QHash<QString, FModelSnapshotPtr> m_snapshots;
+
+    FModelSnapshotPtr snapshot(const QString &countryCode);
+};
+
+#endif // RENDERSERVICE_H
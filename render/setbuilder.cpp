@@ -0,0 +1,242 @@
+#include <QDataStream>
+#include <QSet>
+#include <QSaveFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTextStream>
+#include "setbuilder.h"
+#include "batchrenderer.h"
+#include "cardrenderer.h"
+#include "buildcheckpoint.h"
+#include "cardset/cardsetfile.h"
+#include "tracer.h"
+
+SetBuilder::SetBuilder(const FModelSnapshotPtr &snapshot, const RenderOutput &output)
+    : m_snapshot(snapshot), m_output(output), m_checkpoint(nullptr)
+{
+}
+
+bool SetBuilder::plan(const CardSetReader &reader)
+{
+    FTRACE_SCOPE(Export, "SetBuilder::plan");
+    m_entries.clear();
+    m_dependencies.clear();
+    if (m_cacheDir.isEmpty()) {
+        m_errorString = QObject::tr("No cache directory set.");
+        return false;
+    }
+
+    // Output settings are the same for every side, hash them once with the fonts
+    m_settingsKey.clear();
+    QDataStream out(&m_settingsKey, QIODevice::WriteOnly);
+    out.setVersion(RENDER_STREAM_VERSION);
+    out << CardRenderer::fontKey() << m_output;
+
+    const QString extension = QString::fromLatin1(m_output.format).toLower();
+    m_ids = CardSetFile::idTable();
+    m_entries.reserve(reader.cardCount());
+    for (int i = 0; i < reader.cardCount(); ++i) {
+        SetBuildEntry entry;
+        entry.card = i;
+        entry.record = reader.card(i);
+        entry.fileName = QString("%1-%2.%3").arg(i, 4, 10, QChar('0')).arg(entry.record.side).arg(extension);
+        hashEntry(&entry);
+        m_entries.append(entry);
+        m_dependencies.setCard(i, entry.record, *m_snapshot);
+    }
+    return true;
+}
+
+void SetBuilder::hashEntry(SetBuildEntry *entry)
+{
+    entry->hash = CardRenderer::contentHash(entry->record, *m_snapshot, m_settingsKey);
+    const QString path = cachePath(entry->hash);
+    if (m_checkpoint && m_checkpoint->contains(entry->hash)) {
+        // Rendered by an interrupted run of this job, only the size is checked
+        entry->cached = m_checkpoint->verify(entry->hash, path);
+    } else {
+        entry->cached = QFileInfo::exists(path);
+    }
+}
+
+/*!
+ * \brief Switches to a snapshot of reloaded models and returns the number of rehashed sides.
+ *
+ * Entries that moved count as changed, so the records of every side using
+ * them are moved to the new ids here as well.
+ */
+int SetBuilder::updateSnapshot(const FModelSnapshotPtr &snapshot)
+{
+    FTRACE_SCOPE(Export, "SetBuilder::updateSnapshot");
+    const FModelSnapshotPtr previous = m_snapshot;
+    m_snapshot = snapshot;
+
+    QVector<int> cards;
+    if (previous->countryCode() == snapshot->countryCode()) {
+        cards = m_dependencies.dependents(CardDependencyIndex::changes(*previous, *snapshot));
+    } else {
+        cards.reserve(m_entries.size());
+        for (int i = 0; i < m_entries.size(); ++i) cards.append(i);
+    }
+
+    QVector<int>::const_iterator it = cards.constBegin();
+    for (; it != cards.constEnd(); ++it) {
+        SetBuildEntry &entry = m_entries[*it];
+        CardSetFile::remap(entry.record, m_ids);
+        hashEntry(&entry);
+        m_dependencies.setCard(*it, entry.record, *m_snapshot);
+    }
+    m_ids = CardSetFile::idTable();
+    return cards.size();
+}
+
+int SetBuilder::staleCount() const
+{
+    int count = 0;
+    QVector<SetBuildEntry>::const_iterator it = m_entries.constBegin();
+    for (; it != m_entries.constEnd(); ++it) {
+        if (!it->cached) ++count;
+    }
+    return count;
+}
+
+const QString SetBuilder::cachePath(const QByteArray &hash) const
+{
+    // Two levels keep the directories small for sets with thousands of cards
+    const QString name = QString::fromLatin1(hash);
+    return QDir(m_cacheDir).filePath(name.left(2) + "/" + name + "." + QString::fromLatin1(m_output.format).toLower());
+}
+
+/*!
+ * \brief Renders the sides missing from the cache in batches and updates the output directory.
+ */
+bool SetBuilder::build(WorkStealingScheduler *scheduler)
+{
+    FTRACE_SCOPE(Export, "SetBuilder::build");
+    QVector<int> stale;
+    QSet<QByteArray> scheduled; // Identical sides are only rendered once
+    m_rendered.clear();
+    for (int i = 0; i < m_entries.size(); ++i) {
+        if (!m_entries.at(i).cached && !scheduled.contains(m_entries.at(i).hash)) {
+            scheduled.insert(m_entries.at(i).hash);
+            stale.append(i);
+        }
+    }
+
+    BatchRenderer renderer(scheduler, m_snapshot);
+    for (int first = 0; first < stale.size(); first += SET_BUILD_BATCH_SIZE) {
+        const int count = qMin(SET_BUILD_BATCH_SIZE, stale.size() - first);
+        QVector<RenderJob> jobs;
+        jobs.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            RenderJob job;
+            job.id = quint32(stale.at(first + i));
+            job.record = m_entries.at(int(job.id)).record;
+            job.output = m_output;
+            jobs.append(job);
+        }
+
+        const QVector<RenderResult> results = renderer.render(jobs);
+        QVector<RenderResult>::const_iterator it = results.constBegin();
+        for (; it != results.constEnd(); ++it) {
+            const SetBuildEntry &entry = m_entries.at(int(it->id));
+            if (!it->isValid()) {
+                m_errorString = QObject::tr("Could not render card %1. (%2)").arg(entry.card).arg(it->errorString);
+                return false;
+            }
+            if (!writeCache(entry, it->data)) {
+                return false;
+            }
+            m_rendered.insert(entry.hash);
+            if (m_checkpoint) m_checkpoint->add(entry.hash, it->data.size());
+        }
+        if (m_checkpoint && !m_checkpoint->save()) {
+            m_errorString = m_checkpoint->errorString();
+            return false;
+        }
+        qInfo(qUtf8Printable(QObject::tr("Rendered %1 of %2 cards.").arg(first + count).arg(stale.size())));
+    }
+
+    QVector<SetBuildEntry>::iterator it = m_entries.begin();
+    for (; it != m_entries.end(); ++it) {
+        it->cached = true;
+    }
+    return m_outputDir.isEmpty() || updateOutputs();
+}
+
+bool SetBuilder::writeCache(const SetBuildEntry &entry, const QByteArray &data)
+{
+    const QString path = cachePath(entry.hash);
+    QDir().mkpath(QFileInfo(path).path());
+    // Written atomically, an interrupted build never leaves a broken image under a valid hash
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        m_errorString = QObject::tr("Could not write '%1'. (%2)").arg(path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool SetBuilder::updateOutputs()
+{
+    QDir outputDir(m_outputDir);
+    if (!outputDir.mkpath(".")) {
+        m_errorString = QObject::tr("Could not create the output directory '%1'.").arg(m_outputDir);
+        return false;
+    }
+    const QHash<QString, QByteArray> previous = readManifest();
+
+    QSaveFile manifest(outputDir.filePath(SET_BUILD_MANIFEST));
+    if (!manifest.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        m_errorString = QObject::tr("Could not write '%1'. (%2)").arg(manifest.fileName(), manifest.errorString());
+        return false;
+    }
+    QTextStream out(&manifest);
+
+    QSet<QString> current;
+    QVector<SetBuildEntry>::const_iterator it = m_entries.constBegin();
+    for (; it != m_entries.constEnd(); ++it) {
+        current.insert(it->fileName);
+        const QString target = outputDir.filePath(it->fileName);
+        if (previous.value(it->fileName) != it->hash || m_rendered.contains(it->hash) || !QFileInfo::exists(target)) {
+            QFile::remove(target);
+            if (!QFile::copy(cachePath(it->hash), target)) {
+                m_errorString = QObject::tr("Could not copy card %1 to '%2'.").arg(it->card).arg(target);
+                manifest.cancelWriting();
+                return false;
+            }
+        }
+        out << it->fileName << ' ' << it->hash << '\n';
+    }
+    out.flush();
+    if (!manifest.commit()) {
+        m_errorString = QObject::tr("Could not write '%1'. (%2)").arg(manifest.fileName(), manifest.errorString());
+        return false;
+    }
+
+    // Sides of cards removed from the set, only files the manifest names are touched
+    QHash<QString, QByteArray>::const_iterator old = previous.constBegin();
+    for (; old != previous.constEnd(); ++old) {
+        if (!current.contains(old.key()) && QFileInfo(old.key()).fileName() == old.key()) {
+            QFile::remove(outputDir.filePath(old.key()));
+        }
+    }
+    return true;
+}
+
+QHash<QString, QByteArray> SetBuilder::readManifest() const
+{
+    QHash<QString, QByteArray> hashes;
+    QFile file(QDir(m_outputDir).filePath(SET_BUILD_MANIFEST));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return hashes;
+    }
+    while (!file.atEnd()) {
+        const QList<QByteArray> fields = file.readLine().trimmed().split(' ');
+        if (fields.size() == 2) {
+            hashes.insert(QString::fromUtf8(fields.at(0)), fields.at(1));
+        }
+    }
+    return hashes;
+}
@@ -0,0 +1,91 @@
+#ifndef SETBUILDER_H
+#define SETBUILDER_H
+
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include "renderjob.h"
+#include "models/fmodelsnapshot.h"
+#include "cardset/carddependencyindex.h"
+#include "cardset/cardsetfile.h"
+
+class CardSetReader;
+class WorkStealingScheduler;
+class BuildCheckpoint;
+
+#define SET_BUILD_BATCH_SIZE 64 // Sides rendered and held in memory at once
+#define SET_BUILD_MANIFEST "manifest.txt"
+
+struct SetBuildEntry
+{
+    int card; // Index in the set
+    CardRecord record;
+    QString fileName; // In the output directory
+    QByteArray hash;
+    bool cached;
+};
+
+/*!
+ * \brief Renders a card set like make renders targets, only what changed.
+ *
+ * Every side gets a content hash over its record, the model data it uses,
+ * the fonts, the output settings and CARD_RENDERER_VERSION. Images are
+ * stored under their hash in the cache directory, so a side is only
+ * rendered when nothing with the same hash was rendered before, no matter
+ * which set or card it came from.
+ *
+ * The output directory gets a copy of every side plus a manifest of the
+ * hashes, files whose hash did not change are left alone. Files of sides
+ * the set no longer has are removed.
+ *
+ * With a BuildCheckpoint every finished batch is recorded, so a job that
+ * was interrupted resumes where it stopped instead of starting over.
+ *
+ * A long running builder keeps a CardDependencyIndex of its sides, so when
+ * a data file changes only the sides depending on its entries are hashed
+ * or rendered again.
+ */
+class SetBuilder
+{
+public:
+    SetBuilder(const FModelSnapshotPtr &snapshot, const RenderOutput &output);
+
+    void setCacheDir(const QString &dir) { m_cacheDir = dir; }
+    void setOutputDir(const QString &dir) { m_outputDir = dir; }
+    // Trusts and extends the progress of an interrupted job, set before plan()
+    void setCheckpoint(BuildCheckpoint *checkpoint) { m_checkpoint = checkpoint; }
+
+    bool plan(const CardSetReader &reader); // Hashes all sides and looks them up in the cache
+    const QVector<SetBuildEntry> &entries() const { return m_entries; }
+    int staleCount() const;
+
+    // Rehashes the sides using entries that differ in the new snapshot, all of them for another language
+    int updateSnapshot(const FModelSnapshotPtr &snapshot);
+    const CardDependencyIndex *dependencies() const { return &m_dependencies; }
+
+    bool build(WorkStealingScheduler *scheduler);
+    const QString errorString() const { return m_errorString; }
+
+    const QString cachePath(const QByteArray &hash) const;
+
+private:
+    FModelSnapshotPtr m_snapshot;
+    RenderOutput m_output;
+    QString m_cacheDir;
+    QString m_outputDir;
+    BuildCheckpoint *m_checkpoint;
+    QByteArray m_settingsKey;
+    QVector<SetBuildEntry> m_entries;
+    CardSetFile::IdTable m_ids; // String ids of the model ids in the records
+    CardDependencyIndex m_dependencies; // By entry
+    QSet<QByteArray> m_rendered; // By the last build, copied to the output even with an unchanged hash
+    QString m_errorString;
+
+    void hashEntry(SetBuildEntry *entry);
+
+    bool writeCache(const SetBuildEntry &entry, const QByteArray &data);
+    bool updateOutputs();
+    QHash<QString, QByteArray> readManifest() const;
+};
+
+#endif // SETBUILDER_H
@@ -0,0 +1,154 @@
+#include <QMutexLocker>
+#include "workstealingscheduler.h"
+
+WorkStealingScheduler::WorkStealingScheduler(int workerCount)
+    : m_nextWorker(0), m_queued(0), m_unfinished(0), m_stopping(false)
+{
+    const int count = qMax(1, workerCount);
+    m_workers.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        m_workers.append(new Worker(this, i));
+    }
+    QVector<Worker*>::const_iterator it = m_workers.constBegin();
+    for (; it != m_workers.constEnd(); ++it) {
+        (*it)->wallTimer.start();
+        (*it)->start();
+    }
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+    waitForDone();
+    {
+        QMutexLocker locker(&m_idleMutex);
+        m_stopping = true;
+        m_workAvailable.wakeAll();
+    }
+    QVector<Worker*>::const_iterator it = m_workers.constBegin();
+    for (; it != m_workers.constEnd(); ++it) {
+        (*it)->wait();
+        delete *it;
+    }
+}
+
+void WorkStealingScheduler::submit(const Task &task)
+{
+    // Workers keep their own subtasks, everything else is spread
+    Worker *current = dynamic_cast<Worker*>(QThread::currentThread());
+    Worker *target = current && current->scheduler() == this
+            ? current
+            : m_workers.at(int(uint(m_nextWorker.fetchAndAddRelaxed(1)) % uint(m_workers.size())));
+
+    m_unfinished.ref();
+    {
+        QMutexLocker locker(&target->mutex);
+        target->tasks.append(task);
+    }
+    m_queued.ref();
+
+    QMutexLocker locker(&m_idleMutex);
+    m_workAvailable.wakeOne();
+}
+
+void WorkStealingScheduler::waitForDone()
+{
+    QMutexLocker locker(&m_idleMutex);
+    while (m_unfinished.load() > 0) {
+        m_done.wait(&m_idleMutex);
+    }
+}
+
+QVector<WorkerStats> WorkStealingScheduler::stats() const
+{
+    QVector<WorkerStats> result;
+    result.reserve(m_workers.size());
+    QVector<Worker*>::const_iterator it = m_workers.constBegin();
+    for (; it != m_workers.constEnd(); ++it) {
+        QMutexLocker locker(&(*it)->mutex);
+        WorkerStats stats = (*it)->stats;
+        stats.wallNsecs = (*it)->wallTimer.nsecsElapsed();
+        result.append(stats);
+    }
+    return result;
+}
+
+void WorkStealingScheduler::resetStats()
+{
+    QVector<Worker*>::const_iterator it = m_workers.constBegin();
+    for (; it != m_workers.constEnd(); ++it) {
+        QMutexLocker locker(&(*it)->mutex);
+        (*it)->stats = WorkerStats();
+        (*it)->wallTimer.start();
+    }
+}
+
+int WorkStealingScheduler::currentWorker()
+{
+    Worker *current = dynamic_cast<Worker*>(QThread::currentThread());
+    return current ? current->index() : -1;
+}
+
+/*!
+ * \brief Takes the newest own task or else the oldest task of another worker.
+ */
+bool WorkStealingScheduler::take(int index, Task *task, bool *stolen)
+{
+    Worker *own = m_workers.at(index);
+    {
+        QMutexLocker locker(&own->mutex);
+        if (!own->tasks.isEmpty()) {
+            *task = own->tasks.takeLast();
+            *stolen = false;
+            m_queued.deref();
+            return true;
+        }
+    }
+    const int count = m_workers.size();
+    for (int i = 1; i < count; ++i) {
+        Worker *victim = m_workers.at((index + i) % count);
+        QMutexLocker locker(&victim->mutex);
+        if (!victim->tasks.isEmpty()) {
+            *task = victim->tasks.takeFirst();
+            *stolen = true;
+            m_queued.deref();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingScheduler::finishTask()
+{
+    if (!m_unfinished.deref()) {
+        QMutexLocker locker(&m_idleMutex);
+        m_done.wakeAll();
+    }
+}
+
+void WorkStealingScheduler::Worker::run()
+{
+    QElapsedTimer busyTimer;
+    forever {
+        Task task;
+        bool stolen = false;
+        if (!m_scheduler->take(m_index, &task, &stolen)) {
+            QMutexLocker locker(&m_scheduler->m_idleMutex);
+            // Checked under the lock submit() wakes with, so no wake up is lost
+            if (m_scheduler->m_queued.load() > 0) continue;
+            if (m_scheduler->m_stopping) return;
+            m_scheduler->m_workAvailable.wait(&m_scheduler->m_idleMutex);
+            continue;
+        }
+
+        busyTimer.start();
+        task();
+        const qint64 busy = busyTimer.nsecsElapsed();
+        {
+            QMutexLocker locker(&mutex);
+            stats.executed++;
+            if (stolen) stats.stolen++;
+            stats.busyNsecs += busy;
+        }
+        m_scheduler->finishTask();
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef WORKSTEALINGSCHEDULER_H
+#define WORKSTEALINGSCHEDULER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QList>
+#include <functional>
+
+class WorkStealingScheduler;
+
+struct WorkerStats
+{
+    WorkerStats() : executed(0), stolen(0), busyNsecs(0), wallNsecs(0) {}
+
+    double utilization() const { return wallNsecs > 0 ? double(busyNsecs) / wallNsecs : 0.0; }
+
+    int executed;
+    int stolen;       // Of executed, taken from another worker's queue
+    qint64 busyNsecs;
+    qint64 wallNsecs; // Since the start or the last resetStats()
+};
+
+/*!
+ * \brief Thread pool where every worker has its own task deque and idle workers steal.
+ *
+ * A worker runs the tasks it submitted itself newest first, so the subtasks
+ * of a card stay on the thread that still has its data in the cache. An
+ * idle worker takes the oldest task of another worker, which is usually the
+ * start of a whole card. Tasks submitted from outside are spread round
+ * robin. Unlike a static split, no worker sits idle while another one still
+ * has work queued.
+ */
+class WorkStealingScheduler
+{
+public:
+    typedef std::function<void()> Task;
+
+    explicit WorkStealingScheduler(int workerCount = QThread::idealThreadCount());
+    ~WorkStealingScheduler(); // Runs the queued tasks before stopping the workers
+
+    int workerCount() const { return m_workers.size(); }
+
+    void submit(const Task &task); // From any thread, tasks may submit further tasks
+    void waitForDone();
+
+    QVector<WorkerStats> stats() const;
+    void resetStats();
+
+    static int currentWorker(); // Index of the calling worker, -1 outside the scheduler
+
+private:
+    class Worker : public QThread
+    {
+    public:
+        Worker(WorkStealingScheduler *scheduler, int index) : m_scheduler(scheduler), m_index(index) {}
+
+        void run() override;
+
+        WorkStealingScheduler *scheduler() const { return m_scheduler; }
+        int index() const { return m_index; }
+
+        mutable QMutex mutex; // Guards the deque and the stats
+        QList<Task> tasks;
+        WorkerStats stats;
+        QElapsedTimer wallTimer;
+
+    private:
+        WorkStealingScheduler *m_scheduler;
+        int m_index;
+    };
+
+    QVector<Worker*> m_workers;
+    QAtomicInt m_nextWorker;
+    QAtomicInt m_queued;     // Submitted, not yet taken
+    QAtomicInt m_unfinished; // Submitted, not yet done
+    bool m_stopping;
+
+    QMutex m_idleMutex;
+    QWaitCondition m_workAvailable;
+    QWaitCondition m_done;
+
+    bool take(int index, Task *task, bool *stolen);
+    void finishTask();
+
+    Q_DISABLE_COPY(WorkStealingScheduler)
+};
+
+#endif // WORKSTEALINGSCHEDULER_H
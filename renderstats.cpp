@@ -0,0 +1,21 @@
+#include "renderstats.h"
+
+qreal CacheCounter::hitRate() const
+{
+    const quint64 h = hits();
+    const quint64 total = h + misses();
+    return total == 0 ? 0.0 : qreal(h) / qreal(total);
+}
+
+RenderStats *RenderStats::Instance()
+{
+    static RenderStats instance;
+    return &instance;
+}
+
+void RenderStats::reset()
+{
+    decorations.reset();
+    symbols.reset();
+    keywords.reset();
+}
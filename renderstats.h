@@ -0,0 +1,47 @@
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+#include <atomic>
+#include <QtGlobal>
+
+class CacheCounter
+{
+public:
+    CacheCounter() : m_hits(0), m_misses(0) {}
+
+    inline void hit() { m_hits.fetch_add(1, std::memory_order_relaxed); }
+    inline void miss() { m_misses.fetch_add(1, std::memory_order_relaxed); }
+    void reset() { m_hits.store(0); m_misses.store(0); }
+
+    quint64 hits() const { return m_hits.load(std::memory_order_relaxed); }
+    quint64 misses() const { return m_misses.load(std::memory_order_relaxed); }
+    qreal hitRate() const;
+
+private:
+    std::atomic<quint64> m_hits;
+    std::atomic<quint64> m_misses;
+
+    Q_DISABLE_COPY(CacheCounter)
+};
+
+/*!
+ * \brief Process wide counters of the render caches, shown by the preview debug overlay.
+ */
+class RenderStats
+{
+public:
+    static RenderStats *Instance();
+
+    CacheCounter decorations;
+    CacheCounter symbols;
+    CacheCounter keywords;
+
+    void reset();
+
+private:
+    RenderStats() {}
+
+    Q_DISABLE_COPY(RenderStats)
+};
+
+#endif // RENDERSTATS_H
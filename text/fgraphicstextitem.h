@@ -1,81 +1,63 @@
 #ifndef FGRAPHICSTEXTITEM_H
 #define FGRAPHICSTEXTITEM_H
 
-#include <QGraphicsTextItem>
+#include <QGraphicsItem>
 #include <QPen>
-#include <QPixmap>
 
-#include "ftextdocumentlayout.h"
-#include "ftextobject.h"
-#include "util.h"
+#include "ftextbox.h"
 
-struct FTextObjectReplacement
-{
-    QString word;
-    Util::TextObject::Format objectType;
-    QString symbolName;
-};
-
-class FGraphicsTextItem : public QGraphicsTextItem
+/*!
+ * \brief Shows an FTextBox in a QGraphicsScene.
+ *
+ * The item sits at its parent's origin, the text is drawn at the box's
+ * position inside the target rect.
+ */
+class FGraphicsTextItem : public QGraphicsItem
 {
 public:
-    enum FitToRectOrder { SpacingStretchSize, SizeSpacingStretch, SizeStretchSpacing };
+    typedef FTextBox::FitToRectOrder FitToRectOrder;
 
     FGraphicsTextItem(QGraphicsItem *parent = nullptr, const QString &name = QString());
-    FGraphicsTextItem(const QString &text, QGraphicsItem *parent = nullptr);
-
-    void setOutlinePen(QPen pen) { m_outlinePen = pen; }
-    void showOutline(bool show) { m_showOutline = show; }
 
+    QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
 
-    void addReplacement(const QString &word, Util::TextObject::Format objectType, const QString &symbolName = QString());
+    FTextBox *textBox() { return &m_box; }
+    const FTextBox *textBox() const { return &m_box; }
+    QTextDocument *document() const { return m_box.document(); }
+
+    void setOutlinePen(const QPen &pen);
+    void showOutline(bool show) { m_box.showOutline(show); }
+    void setDefaultTextColor(const QColor &color);
+
     void setTargetRect(const QRect &rect);
 
     void setText(const QString &text);
-    const QString text() const { return m_text; }
+    const QString text() const { return m_box.text(); }
 
     void insertTextBlock(const QString &text);
 
     void setMinimumTextSize(int textSize);
-    int minimumTextSize() const { return m_minTextSize; }
+    int minimumTextSize() const { return m_box.minimumTextSize(); }
 
     void setFitToRectOrder(const FitToRectOrder &order);
 
-    int calculatedTextSize() const { return m_calcTextSize; }
+    int calculatedTextSize() const { return m_box.calculatedTextSize(); }
+    const FTextFitStats &lastFit() const { return m_box.lastFit(); }
+    qint64 lastPaintTime() const { return m_box.lastPaintTime(); }
+    bool lastPaintRendered() const { return m_box.lastPaintRendered(); }
+    int backingStoreBytes() const { return m_box.backingStoreBytes(); }
     void fitToRect();
     void checkUpdate(bool allowFitting = true);
     void clear();
 
-public slots:
     void updatePixmap();
-    void setPlainText(const QString &text);
     void setFont(const QFont &font);
     void setFontFamily(const QString &family);
     void setVoidCostFont(const QFont &font);
 
 private:
-    bool m_showOutline;
-    bool m_isDirty;
-    int m_minTextSize;
-    int m_calcTextSize;
-    int m_defaultTextSize;
-    QString m_text;
-    QPen m_outlinePen;
-    QRect m_targetRect;
-    QFont m_defaultFont;
-    QFont m_voidCostFont;
-    FTextDocumentLayout *m_layout;
-    FKeywordTextObject *m_keywordTextObject;
-    FSymbolTextObject *m_symbolTextObject;
-    QPixmap m_textPixmap;
-    QVector<FTextObjectReplacement> m_replacements;
-    QMap<int, QString> m_textBlocks;
-    FitToRectOrder m_fitToRectOrder;
-
-    void generatePixmap();
-    void parseAndInsertText(const QString &text);
-    QString wordJoin(QString &text);
+    FTextBox m_box;
 };
 
 #endif // FGRAPHICSTEXTITEM_H
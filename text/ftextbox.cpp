@@ -0,0 +1,385 @@
+#include "ftextbox.h"
+#include "ftextcursor.h"
+#include "ftexttokenizer.h"
+#include "util.h"
+#include "tracer.h"
+#include <QPainter>
+#include <QTextCharFormat>
+#include <QAbstractTextDocumentLayout>
+#include <QSettings>
+#include <QElapsedTimer>
+
+FTextBox::FTextBox(const QString &name)
+    : m_showOutline(false), m_isDirty(true), m_minTextSize(9), m_calcTextSize(32), m_defaultTextSize(32),
+      m_outlinePen(Qt::NoPen), m_textColor(Qt::black), m_fitToRectOrder(SpacingStretchSize),
+      m_lastPaintNsecs(0), m_lastPaintRendered(false)
+{
+    m_document = new QTextDocument();
+    m_layout = new FTextDocumentLayout(m_document, name);
+    m_layout->registerHandler(Util::TextObject::KeywordTextFormat, &m_keywordTextObject);
+    m_layout->registerHandler(Util::TextObject::SymbolTextFormat, &m_symbolTextObject);
+    m_cursor = QTextCursor(m_document);
+
+    QTextBlockFormat blockFmt;
+    blockFmt.setTopMargin(20);
+    blockFmt.setBottomMargin(20);
+    blockFmt.setLineHeight(90, QTextBlockFormat::LineHeightTypes::ProportionalHeight);
+    m_cursor.mergeBlockFormat(blockFmt);
+
+    QTextOption opt = m_document->defaultTextOption();
+    opt.setWrapMode(QTextOption::WrapMode::WordWrap);
+    m_document->setDefaultTextOption(opt);
+
+    m_document->setDocumentLayout(m_layout);
+    QObject::connect(m_document, &QTextDocument::contentsChanged, m_document, [this]() { m_isDirty = true; });
+
+    QSettings settings;
+    m_voidCostFont.fromString(settings.value("font/voidcost", "Georgia").value<QString>());
+}
+
+FTextBox::~FTextBox()
+{
+    // The layout still references the text objects
+    delete m_document;
+}
+
+void FTextBox::setOutlinePen(const QPen &pen)
+{
+    m_outlinePen = pen;
+    m_isDirty = true;
+}
+
+void FTextBox::setDefaultTextColor(const QColor &color)
+{
+    m_textColor = color;
+    m_isDirty = true;
+}
+
+void FTextBox::setAlignment(Qt::Alignment alignment)
+{
+    QTextOption opt = m_document->defaultTextOption();
+    opt.setAlignment(alignment);
+    m_document->setDefaultTextOption(opt);
+    m_isDirty = true;
+}
+
+QPointF FTextBox::pos() const
+{
+    // Vertically centered in the target rect
+    return QPointF(m_targetRect.x(), (m_targetRect.y() + m_targetRect.height()/2) - size().height()/2);
+}
+
+// Drawing text is expensive (mostly when outline is active), hence we write it to an image when the text gets changed
+// and then just draw the image
+void FTextBox::render()
+{
+    m_image = QImage(size().toSize(), QImage::Format_ARGB32_Premultiplied);
+    m_image.fill(Qt::transparent);
+    if (m_image.isNull()) {
+        m_isDirty = false;
+        return;
+    }
+
+    QPainter p(&m_image);
+    paintDocument(&p);
+    p.end();
+    // Merging the outline format marked the document as changed
+    m_isDirty = false;
+}
+
+// Draw everything twice (once with outline and then without)
+void FTextBox::paintDocument(QPainter *painter)
+{
+    QAbstractTextDocumentLayout::PaintContext context;
+    context.palette.setColor(QPalette::Text, m_textColor);
+    context.clip = QRectF(QPointF(), size());
+
+    QTextCursor cursor(m_document);
+    cursor.select(QTextCursor::Document);
+    if (m_outlinePen != Qt::NoPen && m_outlinePen.color().alpha() > 0) {
+        QTextCharFormat format;
+        format.setTextOutline(m_outlinePen);
+        cursor.mergeCharFormat(format);
+        m_layout->draw(painter, context);
+        format.setTextOutline(Qt::NoPen);
+        cursor.mergeCharFormat(format);
+        m_layout->draw(painter, context);
+    } else {
+        QTextCharFormat format = cursor.charFormat();
+        if (format.penProperty(QTextFormat::TextOutline).style() != Qt::NoPen) {
+            format.setTextOutline(Qt::NoPen);
+            cursor.mergeCharFormat(format);
+        }
+        if (format.hasProperty(QTextCharFormat::OutlinePen)) {
+            format.clearProperty(QTextCharFormat::OutlinePen);
+            cursor.mergeCharFormat(format);
+        }
+        m_layout->draw(painter, context);
+    }
+}
+
+const QImage &FTextBox::image()
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_lastPaintRendered = m_isDirty;
+    if (m_isDirty) {
+        render();
+    }
+    m_lastPaintNsecs = timer.nsecsElapsed();
+    return m_image;
+}
+
+void FTextBox::draw(QPainter *painter)
+{
+    const QRectF target = rect();
+    if (Util::isVectorDevice(painter)) {
+        // Real glyphs for PDF, the backing image stays as it is for the next raster paint
+        const bool dirty = m_isDirty;
+        painter->save();
+        painter->translate(target.topLeft());
+        paintDocument(painter);
+        painter->restore();
+        m_isDirty = dirty;
+    } else {
+        const QImage &img = image();
+        if (!img.isNull()) {
+            painter->drawImage(target, img, QRectF(img.rect()));
+        }
+    }
+
+    if (Util::DrawDebugInfo) {
+        painter->save();
+        painter->setPen(QColor(255, 0, 255));
+        painter->setBrush(Qt::NoBrush);
+        painter->drawRect(target);
+        painter->restore();
+    }
+}
+
+void FTextBox::setFont(const QFont &font)
+{
+    m_defaultTextSize = font.pointSize();
+    m_defaultFont = font;
+    QTextBlockFormat blockFmt = m_cursor.blockFormat();
+    blockFmt.setTopMargin(font.pointSize()/2);
+    blockFmt.setBottomMargin(font.pointSize()/2);
+    m_cursor.mergeBlockFormat(blockFmt);
+    m_document->setDefaultFont(font);
+    checkUpdate();
+}
+
+void FTextBox::setFontFamily(const QString &family)
+{
+    m_defaultFont.setFamily(family);
+    m_document->setDefaultFont(m_defaultFont);
+    checkUpdate();
+}
+
+void FTextBox::setVoidCostFont(const QFont &font)
+{
+    m_voidCostFont = font;
+    QTextCursor c = m_document->find(QString(QChar::ObjectReplacementCharacter));
+    while (!c.isNull()) {
+        if (c.charFormat().objectType() == Util::TextObject::SymbolTextFormat) {
+            QTextCharFormat fmt;
+            fmt.setProperty(Util::TextObject::SymbolFont, font);
+            c.mergeCharFormat(fmt);
+        }
+        c = m_document->find(QString(QChar::ObjectReplacementCharacter), c.position());
+    }
+    m_isDirty = true;
+}
+
+void FTextBox::setTargetRect(const QRect &rect)
+{
+    m_document->setTextWidth(rect.width());
+    if (rect.size() != m_targetRect.size()) {
+        m_targetRect = rect;
+        m_document->setDefaultFont(m_defaultFont);
+        fitToRect();
+    } else {
+        m_targetRect = rect;
+    }
+}
+
+void FTextBox::setText(const QString &text)
+{
+    clear();
+    m_text = text;
+    parseAndInsertText(text);
+    checkUpdate();
+}
+
+void FTextBox::insertTextBlock(const QString &text)
+{
+    int lastKey = m_textBlocks.isEmpty() ? -1 : m_textBlocks.lastKey();
+    m_textBlocks.insert(lastKey + 1, text);
+    m_cursor.movePosition(QTextCursor::MoveOperation::NextBlock, QTextCursor::MoveMode::MoveAnchor, 1);
+    if (m_textBlocks.size() > 1) {
+        m_cursor.insertBlock();
+    }
+    parseAndInsertText(text);
+}
+
+void FTextBox::setMinimumTextSize(int textSize)
+{
+    if (textSize > m_calcTextSize) {
+        m_minTextSize = textSize;
+        checkUpdate();
+    } else {
+        m_minTextSize = textSize;
+    }
+}
+
+void FTextBox::setFitToRectOrder(FitToRectOrder order)
+{
+    if (m_fitToRectOrder != order) {
+        m_fitToRectOrder = order;
+        fitToRect();
+    }
+}
+
+void FTextBox::fitToRect()
+{
+    FTRACE_SCOPE(Fit, "FTextBox::fitToRect");
+    QElapsedTimer timer;
+    timer.start();
+    const int layoutCount = m_layout->layoutCount();
+    m_lastFit.iterations = 0;
+    QFont f = m_defaultFont;
+    m_document->setDefaultFont(m_defaultFont);
+    QTextBlockFormat blockFmt = m_cursor.blockFormat();
+    if (!m_targetRect.isValid() && m_calcTextSize != m_defaultTextSize) {
+        m_calcTextSize = m_defaultTextSize;
+        f.setPointSize(m_defaultTextSize);
+        m_document->setDefaultFont(f); // automatically updates layout
+        checkUpdate(false);
+        updateFitStats(f, layoutCount, timer.nsecsElapsed());
+        return;
+    }
+
+    bool breakLoop = false;
+    while ((size().width() > m_targetRect.width() || size().height() > m_targetRect.height()) && m_document->defaultFont().pointSize() > m_minTextSize && !breakLoop) {
+        FTRACE_SCOPE_ARG(Fit, "fitToRect iteration", f.pointSize());
+        m_lastFit.iterations++;
+        switch (m_fitToRectOrder) {
+        case SpacingStretchSize:
+            if (f.letterSpacing() > 90) {
+                f.setLetterSpacing(f.letterSpacingType(), f.letterSpacing() - 5);
+            } else if (f.stretch() > QFont::SemiCondensed || f.stretch() == QFont::AnyStretch) {
+                if (f.stretch() == QFont::AnyStretch) {
+                    f.setStretch(QFont::Unstretched - 3);
+                } else {
+                    f.setStretch(f.stretch() - 3);
+                }
+            } else {
+                f.setPointSize(f.pointSize() - 2);
+            }
+            break;
+        case SizeSpacingStretch:
+            if (f.pointSize() - 2 > m_minTextSize) {
+                f.setPointSize(f.pointSize() - 2);
+            } else if (f.letterSpacing() > 90) {
+                f.setLetterSpacing(f.letterSpacingType(), f.letterSpacing() - 5);
+            } else if (f.stretch() > QFont::SemiCondensed || f.stretch() == QFont::AnyStretch) {
+                if (f.stretch() == QFont::AnyStretch) {
+                    f.setStretch(QFont::Unstretched - 3);
+                } else {
+                    f.setStretch(f.stretch() - 3);
+                }
+            } else {
+                breakLoop = true;
+            }
+            break;
+        case SizeStretchSpacing:
+            if (f.pointSize() - 2 > m_minTextSize) {
+                f.setPointSize(f.pointSize() - 2);
+            } else if (f.stretch() > QFont::SemiCondensed || f.stretch() == QFont::AnyStretch) {
+                if (f.stretch() == QFont::AnyStretch) {
+                    f.setStretch(QFont::Unstretched - 3);
+                } else {
+                    f.setStretch(f.stretch() - 3);
+                }
+            } else if (f.letterSpacing() > 90) {
+                f.setLetterSpacing(f.letterSpacingType(), f.letterSpacing() - 5);
+            } else {
+                breakLoop = true;
+            }
+            break;
+        }
+
+        m_document->setDefaultFont(f); // automatically updates layout
+    }
+    if (m_calcTextSize != f.pointSize()) {
+        blockFmt.setTopMargin(f.pointSize()/2);
+        blockFmt.setBottomMargin(f.pointSize()/2);
+        m_cursor.mergeBlockFormat(blockFmt);
+    }
+    m_calcTextSize = f.pointSize();
+    m_isDirty = true;
+    updateFitStats(f, layoutCount, timer.nsecsElapsed());
+}
+
+void FTextBox::updateFitStats(const QFont &font, int layoutCountBefore, qint64 nsecs)
+{
+    m_lastFit.layoutPasses = m_layout->layoutCount() - layoutCountBefore;
+    m_lastFit.pointSize = font.pointSize();
+    m_lastFit.letterSpacing = font.letterSpacing();
+    m_lastFit.stretch = font.stretch();
+    m_lastFit.nsecs = nsecs;
+}
+
+void FTextBox::parseAndInsertText(const QString &text)
+{
+    const QVector<FTextToken> tokens = FTextTokenizer::tokenize(text);
+    QVector<FTextToken>::const_iterator it = tokens.constBegin();
+    for (; it != tokens.constEnd(); ++it) {
+        switch (it->type) {
+        case FTextToken::Text: {
+            // Insert normal text
+            QString str = it->text;
+            m_cursor.insertText(wordJoin(str));
+            break;
+        }
+        case FTextToken::Symbol:
+            FTextCursor::insertSymbol(m_cursor, Util::TextObject::Replacements[it->text].symbolName, m_outlinePen);
+            break;
+        case FTextToken::VoidCost:
+            FTextCursor::insertSymbol(m_cursor, ":/svg/symbol-voidcost.svg", m_outlinePen, it->text, m_voidCostFont);
+            break;
+        case FTextToken::Keyword:
+            FTextCursor::insertKeyword(m_cursor, it->text, it->gradient);
+            break;
+        }
+    }
+}
+
+/*!
+ * \brief Inserts the unicode character U+2060 (Word Joiner) after and before Slashes ('/') so that they do not get wrapped into a new line.
+ * \param text
+ * \return QString
+ */
+QString FTextBox::wordJoin(QString &text)
+{
+    QRegularExpression re("/", QRegularExpression::MultilineOption);
+    text.replace(re, QString(QChar(0x2060)) + "/" + QString(QChar(0x2060)));
+    return text;
+}
+
+void FTextBox::checkUpdate(bool allowFitting)
+{
+    if (m_targetRect.isValid() && (size().width() > m_targetRect.width() || size().height() > m_targetRect.height()) && allowFitting) {
+        fitToRect();
+    } else {
+        m_isDirty = true;
+    }
+}
+
+void FTextBox::clear()
+{
+    m_textBlocks.clear();
+    QTextCursor c = QTextCursor(m_document->firstBlock());
+    c.movePosition(QTextCursor::MoveOperation::End, QTextCursor::MoveMode::KeepAnchor, 1);
+    c.removeSelectedText();
+}
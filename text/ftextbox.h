@@ -0,0 +1,118 @@
+#ifndef FTEXTBOX_H
+#define FTEXTBOX_H
+
+#include <QTextDocument>
+#include <QTextCursor>
+#include <QImage>
+#include <QPen>
+#include <QMap>
+
+#include "ftextdocumentlayout.h"
+#include "ftextobject.h"
+
+// Outcome of the last fitToRect, shown by the preview debug overlay
+struct FTextFitStats
+{
+    int layoutPasses = 0;
+    int iterations = 0;
+    int pointSize = 0;
+    qreal letterSpacing = 0;
+    int stretch = 0;
+    qint64 nsecs = 0;
+};
+
+/*!
+ * \brief One text box of a card: parses the markup, shrinks the font until
+ * the text fits the target rect and rasterizes the result into a QImage.
+ * On vector devices like PDF the document is drawn directly instead.
+ *
+ * Owns its document and never touches QPixmap or widgets, so unlike
+ * QGraphicsTextItem it can be used from any QThread, one thread at a time.
+ * The text is laid out for the target rect's width and vertically centered
+ * in it, rect() is in the coordinates of the target rect.
+ */
+class FTextBox
+{
+public:
+    enum FitToRectOrder { SpacingStretchSize, SizeSpacingStretch, SizeStretchSpacing };
+
+    explicit FTextBox(const QString &name = QString());
+    ~FTextBox();
+
+    QTextDocument *document() const { return m_document; }
+
+    void setOutlinePen(const QPen &pen);
+    void showOutline(bool show) { m_showOutline = show; }
+    void setDefaultTextColor(const QColor &color);
+    void setAlignment(Qt::Alignment alignment);
+
+    void setTargetRect(const QRect &rect);
+    const QRect &targetRect() const { return m_targetRect; }
+
+    void setText(const QString &text);
+    const QString &text() const { return m_text; }
+
+    void insertTextBlock(const QString &text);
+    void clear();
+
+    void setMinimumTextSize(int textSize);
+    int minimumTextSize() const { return m_minTextSize; }
+
+    void setFitToRectOrder(FitToRectOrder order);
+
+    void setFont(const QFont &font);
+    void setFontFamily(const QString &family);
+    void setVoidCostFont(const QFont &font);
+    const QFont &defaultFont() const { return m_defaultFont; }
+
+    QSizeF size() const { return m_document->size(); }
+    QPointF pos() const;
+    QRectF rect() const { return QRectF(pos(), size()); }
+
+    void fitToRect();
+    void checkUpdate(bool allowFitting = true);
+    void invalidate() { m_isDirty = true; } // Rasterize again on the next image()
+
+    const QImage &image();
+    void draw(QPainter *painter);
+
+    int calculatedTextSize() const { return m_calcTextSize; }
+    const FTextFitStats &lastFit() const { return m_lastFit; }
+    qint64 lastPaintTime() const { return m_lastPaintNsecs; }
+    bool lastPaintRendered() const { return m_lastPaintRendered; } // False when the backing image was reused
+    int backingStoreBytes() const { return int(m_image.sizeInBytes()); }
+
+private:
+    bool m_showOutline;
+    bool m_isDirty;
+    int m_minTextSize;
+    int m_calcTextSize;
+    int m_defaultTextSize;
+    QString m_text;
+    QPen m_outlinePen;
+    QColor m_textColor;
+    QRect m_targetRect;
+    QFont m_defaultFont;
+    QFont m_voidCostFont;
+    FKeywordTextObject m_keywordTextObject;
+    FSymbolTextObject m_symbolTextObject;
+    QTextDocument *m_document;
+    FTextDocumentLayout *m_layout;
+    QTextCursor m_cursor;
+    QImage m_image;
+    QMap<int, QString> m_textBlocks;
+    FitToRectOrder m_fitToRectOrder;
+    FTextFitStats m_lastFit;
+    qint64 m_lastPaintNsecs;
+    bool m_lastPaintRendered;
+
+    void render();
+    void paintDocument(QPainter *painter); // At the origin, in the document's coordinates
+    void updateFitStats(const QFont &font, int layoutCountBefore, qint64 nsecs);
+    void parseAndInsertText(const QString &text);
+    QString wordJoin(QString &text);
+
+    Q_DISABLE_COPY(FTextBox)
+};
+
+#endif // FTEXTBOX_H
@@ -6,6 +6,12 @@
 #include <QPainter>
 #include "util.h"
 #include "ftextcursor.h"
+#include "renderstats.h"
 
+#define SYMBOL_CACHE_LIMIT (16 * 1024 * 1024)
 
-
+ImageCache *FTextCursor::symbolCache()
+{
+    static ImageCache cache(&RenderStats::Instance()->symbols, SYMBOL_CACHE_LIMIT);
+    return &cache;
+}
@@ -10,6 +10,7 @@
 #include <QPainter>
 #include <QDebug>
 #include "util.h"
+#include "render/imagecache.h"
 
 class FTextCursor : public QTextCursor
 {
@@ -114,15 +115,37 @@ public:
 //        renderer.setViewBox(viewBox);
 //        renderer.render(&p, svgImage.rect());
 
-        QPixmap svgImage = Util::XML::svgToPixmap(filename, QSize(-1, qCeil(fm.height())), outline);
+        QImage svgImage = symbolImage(filename, qCeil(fm.height()), outline);
 
         format.setProperty(Util::TextObject::SymbolData, svgImage);
+        // Vector devices draw the SVG itself instead of the image
+        format.setProperty(Util::TextObject::SymbolFile, filename);
+        format.setProperty(Util::TextObject::SymbolOutline, outline);
+        format.setProperty(Util::TextObject::SymbolHeight, qCeil(fm.height()));
 
         cursor.insertText(QString(QChar::ObjectReplacementCharacter), format);
 
         // Revert charFormat
         cursor.setCharFormat(oldFormat);
     }
+
+    // Symbols get inserted again on every text change, rasterize each variant only once
+    static QImage symbolImage(const QString &filename, int height, const QPen &outline)
+    {
+        const bool hasOutline = outline != Qt::NoPen && outline.color().alpha() > 0;
+        const QString key = QString("symbol:%1@%2:%3:%4").arg(filename).arg(height)
+                .arg(hasOutline ? outline.color().name(QColor::HexArgb) : QString())
+                .arg(hasOutline ? outline.widthF() : 0.0);
+        QImage image;
+        if (symbolCache()->find(key, &image)) {
+            return image;
+        }
+        image = Util::XML::svgToImage(filename, QSize(-1, height), outline);
+        symbolCache()->insert(key, image);
+        return image;
+    }
+
+    static ImageCache *symbolCache();
 };
 
 #endif // FTEXTCURSOR_H
@@ -1,4 +1,5 @@
 #include "ftextdocumentlayout.h"
+#include "tracer.h"
 #include <QDebug>
 
 #include <QtMath>
@@ -216,6 +217,7 @@ FTextDocumentLayout::FTextDocumentLayout(QTextDocument *document, const QString
     m_name = name;
     m_idealWidth = 0;
     m_useClip = false;
+    m_layoutCount = 0;
     currentLazyLayoutPosition = -1;
     lazyLayoutStepSize = 1000;
     contentHasAlignment = false;
@@ -790,6 +792,8 @@ void FTextDocumentLayout::markFrames(QTextFrame *current, int from, int charsRem
 
 QRectF FTextDocumentLayout::doLayout(int from, int charsRemoved, int charsAdded)
 {
+    FTRACE_SCOPE_ARG(Layout, "FTextDocumentLayout::doLayout", charsAdded);
+    m_layoutCount++;
     #if DEBUG_PRINT==1
     qDebug() << "("<<m_name<<") FTextDocumentLayout::doLayout(from =" << from << ", charsRemoved =" << charsRemoved << ", charsAdded =" << charsAdded << ")";
     #endif
@@ -36,6 +36,7 @@ public:
 
     qreal idealWidth() const;
     void setViewport(const QRectF &viewport) { viewportRect = viewport; }
+    int layoutCount() const { return m_layoutCount; } // Number of doLayout passes so far
 
 protected:
     void documentChanged(int from, int charsRemoved, int charsAdded) override;
@@ -45,6 +46,7 @@ private:
     QString m_name;
     qreal m_idealWidth;
     bool m_useClip;
+    int m_layoutCount;
     QBasicTimer layoutTimer;
     QBasicTimer sizeChangedTimer;
     QVector<QCheckPoint> checkPoints;
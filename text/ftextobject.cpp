@@ -1,5 +1,6 @@
 #include "ftextobject.h"
 #include "util.h"
+#include "renderstats.h"
 
 #include <QFontMetricsF>
 #include <QTextBlock>
@@ -24,6 +25,17 @@ QSizeF FKeywordTextObject::intrinsicSize(QTextDocument *doc, int posInDocument,
     if (!showGradient) {
         f.setPointSize(fmt.font().pointSize() - 4);
     }
+
+    // QFont::key() does not cover spacing and stretch
+    const QString key = f.key() % QLatin1Char('|') % QString::number(f.letterSpacing()) % QLatin1Char('|') % QString::number(f.stretch())
+            % QLatin1Char('|') % (showGradient ? QLatin1Char('g') : QLatin1Char('-')) % contents;
+    QHash<QString, QSizeF>::const_iterator cached = m_sizes.constFind(key);
+    if (cached != m_sizes.constEnd()) {
+        RenderStats::Instance()->keywords.hit();
+        return cached.value();
+    }
+    RenderStats::Instance()->keywords.miss();
+
     QFontMetricsF fm(f);
     //qreal marginx = fm.horizontalAdvance("x");
     qreal marginy = fm.xHeight()/2;
@@ -35,6 +47,11 @@ QSizeF FKeywordTextObject::intrinsicSize(QTextDocument *doc, int posInDocument,
     size.setWidth(width);
     size.setHeight(fm.height() + marginy);
 
+    if (m_sizes.size() >= KEYWORD_SIZE_CACHE_LIMIT) {
+        m_sizes.clear();
+    }
+    m_sizes.insert(key, size);
+
     return size;
 }
 
@@ -199,6 +216,17 @@ QSizeF FSymbolTextObject::intrinsicSize(QTextDocument *doc, int posInDocument, c
     return size;
 }
 
+void FSymbolTextObject::drawSymbol(QPainter *painter, const QRectF &dest, const QTextCharFormat &format, const QImage &image, bool vector)
+{
+    if (!vector) {
+        painter->drawImage(dest, image);
+        return;
+    }
+    const QString filename = format.property(Util::TextObject::SymbolFile).toString();
+    const int height = format.intProperty(Util::TextObject::SymbolHeight);
+    Util::XML::drawSvg(painter, dest, filename, QSize(-1, height), format.penProperty(Util::TextObject::SymbolOutline));
+}
+
 void FSymbolTextObject::drawObject(QPainter *painter, const QRectF &rect, QTextDocument *doc, int posInDocument, const QTextFormat &format)
 {
     Q_UNUSED(doc);
@@ -211,21 +239,19 @@ void FSymbolTextObject::drawObject(QPainter *painter, const QRectF &rect, QTextD
     qreal marginy = fm.xHeight()/4;
     qreal marginx = marginy;
 
-    //QImage svgImage = qvariant_cast<QImage>(fmt.property(Util::TextObject::SymbolData));
-    QPixmap svgImage = qvariant_cast<QPixmap>(fmt.property(Util::TextObject::SymbolData));
+    QImage svgImage = qvariant_cast<QImage>(fmt.property(Util::TextObject::SymbolData));
     qreal outlineWidth = qvariant_cast<qreal>(fmt.property(Util::TextObject::SymbolOutlineWidth));
 
 
     QRectF dest;
     dest = QRectF(rect.x() + 0*marginx/2, rect.y() + 0*marginy/2, rect.width() - 0*marginx, rect.height() - 0*marginy);
 
+    const bool vector = Util::isVectorDevice(painter) && fmt.hasProperty(Util::TextObject::SymbolFile);
     if (fmt.textOutline().color().alpha() > 0 && fmt.textOutline() != Qt::NoPen && outlineWidth > -1) {
-        //painter->drawImage(dest, svgImage);
-        painter->drawPixmap(dest, svgImage, svgImage.rect());
+        drawSymbol(painter, dest, fmt, svgImage, vector);
     } else if (outlineWidth <= -1) {
         dest = QRectF(rect.x() + marginx/2, rect.y() + marginy/2, rect.width() - marginx, rect.height() - marginy);
-        //painter->drawImage(dest, svgImage);
-        painter->drawPixmap(dest, svgImage, svgImage.rect());
+        drawSymbol(painter, dest, fmt, svgImage, vector);
     }
 
     if (fmt.textOutline().color().alpha() <= 0 || fmt.textOutline() == Qt::NoPen || outlineWidth <= -1) {
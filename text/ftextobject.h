@@ -4,6 +4,9 @@
 #include <QObject>
 #include <QTextObjectInterface>
 #include <QRegularExpression>
+#include <QHash>
+
+#define KEYWORD_SIZE_CACHE_LIMIT 1024
 
 class FKeywordTextObject : public QObject, public QTextObjectInterface
 {
@@ -12,6 +15,10 @@ class FKeywordTextObject : public QObject, public QTextObjectInterface
 public:
     QSizeF intrinsicSize(QTextDocument *doc, int posInDocument, const QTextFormat &format) override;
     void drawObject(QPainter *painter, const QRectF &rect, QTextDocument *doc, int posInDocument, const QTextFormat &format) override;
+
+private:
+    // Every layout pass of fitToRect asks for the size again, measuring text is the slow part
+    QHash<QString, QSizeF> m_sizes;
 };
 
 class FSymbolTextObject : public QObject, public QTextObjectInterface
@@ -21,6 +28,10 @@ class FSymbolTextObject : public QObject, public QTextObjectInterface
 
     QSizeF intrinsicSize(QTextDocument *doc, int posInDocument, const QTextFormat &format) override;
     void drawObject(QPainter *painter, const QRectF &rect, QTextDocument *doc, int posInDocument, const QTextFormat &format) override;
+
+private:
+    // The rasterized image, or the SVG as paths on vector devices like PDF
+    void drawSymbol(QPainter *painter, const QRectF &dest, const QTextCharFormat &format, const QImage &image, bool vector);
 };
 
 #endif // FTEXTOBJECT_H
@@ -0,0 +1,66 @@
+#include <QRegularExpression>
+#include "ftexttokenizer.h"
+#include "util.h"
+
+QVector<FTextToken> FTextTokenizer::tokenize(const QString &text)
+{
+    static const QRegularExpression re("\\[([^+/]+?)\\]", QRegularExpression::CaseInsensitiveOption | QRegularExpression::MultilineOption);
+
+    QVector<FTextToken> tokens;
+    QRegularExpressionMatchIterator matchIter = re.globalMatch(text);
+    int lastCaptureEnd = 0;
+    while (matchIter.hasNext()) {
+        QRegularExpressionMatch match = matchIter.next();
+        if (!match.hasMatch()) continue;
+
+        if (match.capturedStart(0) > lastCaptureEnd) {
+            tokens.append({FTextToken::Text, text.mid(lastCaptureEnd, match.capturedStart(0) - lastCaptureEnd), false,
+                           lastCaptureEnd, match.capturedStart(0) - lastCaptureEnd});
+        }
+
+        const QString name = match.captured(1);
+        bool intConverted = true;
+        FTextToken token = {FTextToken::Keyword, name, false, match.capturedStart(0), match.capturedLength(0)};
+        if (Util::TextObject::Replacements.contains(name)) {
+            token.type = FTextToken::Symbol;
+        } else if (name.size() == 1 && name.toInt(&intConverted) > -1 && intConverted) {
+            token.type = FTextToken::VoidCost;
+        } else if (name.at(name.size()-1) == '!') {
+            token.text = name.left(name.size()-1);
+            token.gradient = true;
+        }
+        tokens.append(token);
+        lastCaptureEnd = match.capturedEnd(0);
+    }
+
+    if (lastCaptureEnd < text.length()) {
+        tokens.append({FTextToken::Text, text.mid(lastCaptureEnd), false, lastCaptureEnd, text.length() - lastCaptureEnd});
+    }
+    return tokens;
+}
+
+QStringList FTextTokenizer::terms(const QString &text)
+{
+    QStringList result;
+    const QVector<FTextToken> tokens = tokenize(text);
+    QVector<FTextToken>::const_iterator it = tokens.constBegin();
+    for (; it != tokens.constEnd(); ++it) {
+        if (it->type != FTextToken::Text) {
+            result.append(bracketTerm(it->text));
+            continue;
+        }
+        // Words are runs of letters and digits, anything else separates them
+        const QString folded = it->text.toCaseFolded();
+        int wordStart = -1;
+        for (int i = 0; i <= folded.size(); ++i) {
+            bool isWordChar = i < folded.size() && (folded.at(i).isLetterOrNumber() || folded.at(i).isMark());
+            if (isWordChar && wordStart < 0) {
+                wordStart = i;
+            } else if (!isWordChar && wordStart >= 0) {
+                result.append(folded.mid(wordStart, i - wordStart));
+                wordStart = -1;
+            }
+        }
+    }
+    return result;
+}
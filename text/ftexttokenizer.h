@@ -0,0 +1,35 @@
+#ifndef FTEXTTOKENIZER_H
+#define FTEXTTOKENIZER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+struct FTextToken
+{
+    enum Type { Text, Symbol, VoidCost, Keyword };
+
+    Type type;
+    QString text; // Replacement name, void cost digit or keyword without the trailing '!'
+    bool gradient; // Keyword only
+    int start;
+    int length;
+};
+
+/*!
+ * \brief Splits card text into plain text, symbols, void costs and keywords.
+ *
+ * This is the syntax understood by FGraphicsTextItem, e.g.
+ * "[Judgement]", "[Rest]" or "[3]".
+ */
+class FTextTokenizer
+{
+public:
+    static QVector<FTextToken> tokenize(const QString &text);
+
+    // Search terms, case folded. Bracket tokens keep their brackets.
+    static QStringList terms(const QString &text);
+    static QString bracketTerm(const QString &name) { return QLatin1Char('[') + name.toCaseFolded() + QLatin1Char(']'); }
+};
+
+#endif // FTEXTTOKENIZER_H
@@ -0,0 +1,186 @@
+#include <QFile>
+#include <QThread>
+#include <QStringList>
+#include <QCoreApplication>
+#include "tracer.h"
+
+std::atomic<quint32> Tracer::s_mask(Tracer::NoCategory);
+
+Tracer::Tracer()
+    : m_dropped(0)
+{
+    m_clock.start();
+}
+
+Tracer *Tracer::Instance()
+{
+    static Tracer instance;
+    return &instance;
+}
+
+/*!
+ * \brief Parses a comma separated list like "layout,fit" or "all" into a category mask.
+ */
+quint32 Tracer::parseCategories(const QString &list)
+{
+    quint32 mask = NoCategory;
+    // Empty parts match no category, so they need no skipping
+    const QStringList names = list.toLower().split(',');
+    QStringList::const_iterator it = names.constBegin();
+    for (; it != names.constEnd(); ++it) {
+        const QString name = it->trimmed();
+        if (name == "all" || name == "1") mask |= AllCategories;
+        else if (name == "layout") mask |= Layout;
+        else if (name == "fit") mask |= Fit;
+        else if (name == "svg") mask |= Svg;
+        else if (name == "paint") mask |= Paint;
+        else if (name == "export") mask |= Export;
+    }
+    return mask;
+}
+
+const char *Tracer::categoryName(Category category)
+{
+    switch (category) {
+    case Layout: return "layout";
+    case Fit:    return "fit";
+    case Svg:    return "svg";
+    case Paint:  return "paint";
+    case Export: return "export";
+    default:     return "other";
+    }
+}
+
+// Quoted JSON string, thread names come from QObject::objectName() and may hold anything
+static QByteArray jsonString(const QString &string)
+{
+    QByteArray out("\"");
+    const QByteArray utf8 = string.toUtf8();
+    for (int i = 0; i < utf8.size(); ++i) {
+        const char c = utf8.at(i);
+        switch (c) {
+        case '"':  out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+            if (uchar(c) < 0x20) {
+                out.append("\\u00").append(QByteArray::number(uchar(c), 16).rightJustified(2, '0'));
+            } else {
+                out.append(c);
+            }
+        }
+    }
+    return out.append('"');
+}
+
+Tracer::ThreadBuffer *Tracer::threadBuffer()
+{
+    static thread_local ThreadBuffer *buffer = nullptr;
+    if (buffer == nullptr) {
+        buffer = new ThreadBuffer;
+        QThread *thread = QThread::currentThread();
+        buffer->threadName = thread->objectName();
+        if (buffer->threadName.isEmpty()) {
+            buffer->threadName = (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+                    ? QString("Main") : QString(thread->metaObject()->className());
+        }
+        QMutexLocker locker(&m_buffersMutex);
+        buffer->tid = m_buffers.size() + 1;
+        m_buffers.push_back(buffer);
+    }
+    return buffer;
+}
+
+void Tracer::record(const Event &event)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    QMutexLocker locker(&buffer->mutex);
+    if (buffer->events.size() >= TRACER_MAX_EVENTS_PER_THREAD) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events.push_back(event);
+}
+
+void Tracer::clear()
+{
+    QMutexLocker locker(&m_buffersMutex);
+    QVector<ThreadBuffer*>::const_iterator it = m_buffers.constBegin();
+    for (; it != m_buffers.constEnd(); ++it) {
+        QMutexLocker bufferLocker(&(*it)->mutex);
+        (*it)->events.clear();
+    }
+    m_dropped.store(0, std::memory_order_relaxed);
+}
+
+bool Tracer::writeChromeJson(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning(qUtf8Printable(QObject::tr("Could not write trace file %1").arg(filename)));
+        return false;
+    }
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+    QByteArray out("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+
+    QMutexLocker locker(&m_buffersMutex);
+    QVector<ThreadBuffer*>::const_iterator it = m_buffers.constBegin();
+    for (; it != m_buffers.constEnd(); ++it) {
+        ThreadBuffer *buffer = *it;
+        QMutexLocker bufferLocker(&buffer->mutex);
+        const QByteArray tid = QByteArray::number(buffer->tid);
+
+        if (!first) out.append(",\n");
+        first = false;
+        out.append("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":").append(pid)
+           .append(",\"tid\":").append(tid)
+           .append(",\"args\":{\"name\":").append(jsonString(buffer->threadName)).append("}}");
+
+        QVector<Event>::const_iterator ev = buffer->events.constBegin();
+        for (; ev != buffer->events.constEnd(); ++ev) {
+            // Chrome expects microseconds, keep the nanosecond part as fraction
+            out.append(",\n{\"ph\":\"X\",\"name\":\"").append(ev->name)
+               .append("\",\"cat\":\"").append(categoryName(ev->category))
+               .append("\",\"pid\":").append(pid)
+               .append(",\"tid\":").append(tid)
+               .append(",\"ts\":").append(QByteArray::number(ev->start / 1000.0, 'f', 3))
+               .append(",\"dur\":").append(QByteArray::number(ev->duration / 1000.0, 'f', 3));
+            if (ev->hasArg) {
+                out.append(",\"args\":{\"value\":").append(QByteArray::number(ev->arg)).append("}");
+            }
+            out.append("}");
+        }
+        // Write per thread so huge traces are not held twice in memory
+        file.write(out);
+        out.clear();
+    }
+    out.append("\n]}\n");
+    file.write(out);
+
+    if (m_dropped.load(std::memory_order_relaxed) > 0) {
+        qWarning(qUtf8Printable(QObject::tr("%1 trace events were dropped, the per thread limit was reached.").arg(m_dropped.load())));
+    }
+    return file.error() == QFile::NoError;
+}
+
+/* Span */
+
+void TraceSpan::begin(Tracer::Category category, const char *name, qint64 arg, bool hasArg)
+{
+    m_event.name = name;
+    m_event.category = category;
+    m_event.arg = arg;
+    m_event.hasArg = hasArg;
+    m_event.start = Tracer::Instance()->now();
+}
+
+void TraceSpan::end()
+{
+    Tracer *tracer = Tracer::Instance();
+    m_event.duration = tracer->now() - m_event.start;
+    tracer->record(m_event);
+}
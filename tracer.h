@@ -0,0 +1,121 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <QtGlobal>
+#include <QVector>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QString>
+
+#define TRACER_MAX_EVENTS_PER_THREAD 1048576
+
+/*!
+ * \brief Collects timed spans of the render pipeline and writes them as Chrome trace-event JSON.
+ *
+ * Only compiled in with CONFIG+=tracing (defines FOWCE_TRACING), otherwise the
+ * FTRACE_* macros expand to nothing. When compiled in, a span of a disabled
+ * category costs one load and branch. Every thread records into its own
+ * buffer, the buffers are only merged when the trace is written.
+ *
+ * Load the written file in chrome://tracing or ui.perfetto.dev.
+ */
+class Tracer
+{
+public:
+    enum Category : quint32 {
+        NoCategory = 0x0,
+        Layout = 0x1,
+        Fit = 0x2,
+        Svg = 0x4,
+        Paint = 0x8,
+        Export = 0x10,
+        AllCategories = 0x1F
+    };
+
+    struct Event {
+        const char *name; // Must be a string literal, it is not copied
+        Category category;
+        qint64 start; // nsecs since the tracer was created
+        qint64 duration;
+        qint64 arg;
+        bool hasArg;
+    };
+
+    static Tracer *Instance();
+
+    static inline bool isEnabled(Category category) { return s_mask.load(std::memory_order_relaxed) & category; }
+    static void setCategories(quint32 mask) { s_mask.store(mask, std::memory_order_relaxed); }
+    static quint32 categories() { return s_mask.load(std::memory_order_relaxed); }
+    static quint32 parseCategories(const QString &list);
+    static const char *categoryName(Category category);
+
+    qint64 now() const { return m_clock.nsecsElapsed(); }
+    void record(const Event &event);
+
+    bool writeChromeJson(const QString &filename);
+    void clear();
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    Tracer();
+
+    struct ThreadBuffer {
+        int tid;
+        QString threadName;
+        QMutex mutex; // Only contended while the trace is written
+        QVector<Event> events;
+    };
+
+    static std::atomic<quint32> s_mask;
+
+    QElapsedTimer m_clock;
+    QMutex m_buffersMutex;
+    QVector<ThreadBuffer*> m_buffers; // Never freed, threads may record until exit
+    std::atomic<quint64> m_dropped;
+
+    ThreadBuffer *threadBuffer();
+
+    Q_DISABLE_COPY(Tracer)
+};
+
+class TraceSpan
+{
+public:
+    inline TraceSpan(Tracer::Category category, const char *name)
+        : m_active(Tracer::isEnabled(category))
+    {
+        if (m_active) begin(category, name, 0, false);
+    }
+    inline TraceSpan(Tracer::Category category, const char *name, qint64 arg)
+        : m_active(Tracer::isEnabled(category))
+    {
+        if (m_active) begin(category, name, arg, true);
+    }
+    inline ~TraceSpan()
+    {
+        if (m_active) end();
+    }
+
+private:
+    bool m_active;
+    Tracer::Event m_event;
+
+    void begin(Tracer::Category category, const char *name, qint64 arg, bool hasArg);
+    void end();
+
+    Q_DISABLE_COPY(TraceSpan)
+};
+
+#define FTRACE_CONCAT_(a, b) a##b
+#define FTRACE_CONCAT(a, b) FTRACE_CONCAT_(a, b)
+
+#ifdef FOWCE_TRACING
+#define FTRACE_SCOPE(category, name) TraceSpan FTRACE_CONCAT(_traceSpan, __LINE__)(Tracer::category, name)
+#define FTRACE_SCOPE_ARG(category, name, arg) TraceSpan FTRACE_CONCAT(_traceSpan, __LINE__)(Tracer::category, name, qint64(arg))
+#else
+#define FTRACE_SCOPE(category, name) ((void)0)
+#define FTRACE_SCOPE_ARG(category, name, arg) ((void)0)
+#endif
+
+#endif // TRACER_H
@@ -1,5 +1,11 @@
+#include <QThreadStorage>
+#include <QSharedPointer>
 #include "util.h"
 
+// Exports draw the same few symbols on every card, parse each variant once per thread
+typedef QHash<QString, QSharedPointer<QSvgRenderer>> SvgRenderers;
+static QThreadStorage<SvgRenderers*> s_svgRenderers;
+
 bool Util::DrawDebugInfo = false;
 
 const QColor Util::Blue = QColor(120, 200, 255);
@@ -22,3 +28,81 @@ const QMap<QString, Util::TextObject::Replacement> Util::TextObject::Replacement
     {"time", Util::TextObject::Replacement{Util::TextObject::SymbolTextFormat, ":/svg/attribute-time.svg"}},
     {"rest", Util::TextObject::Replacement{Util::TextObject::SymbolTextFormat, ":/svg/symbol-rest.svg"}}
 };
+
+QSvgRenderer *Util::XML::svgRenderer(const QString &filename, const QColor &stroke, qreal strokeWidth)
+{
+    if (!s_svgRenderers.hasLocalData()) {
+        s_svgRenderers.setLocalData(new SvgRenderers());
+    }
+    SvgRenderers *renderers = s_svgRenderers.localData();
+    const QString key = QString("%1:%2:%3").arg(filename, stroke.isValid() ? stroke.name(QColor::HexArgb) : QString()).arg(strokeWidth);
+    SvgRenderers::const_iterator cached = renderers->constFind(key);
+    if (cached != renderers->constEnd()) {
+        return cached->data();
+    }
+
+    QFile svgFile(filename);
+    if (!svgFile.open(QIODevice::ReadOnly)) {
+        renderers->insert(key, QSharedPointer<QSvgRenderer>());
+        return nullptr;
+    }
+    QDomDocument domDoc;
+    domDoc.setContent(svgFile.readAll());
+
+    if (stroke.isValid()) {
+        // Same DOM modification as svgToImage
+        QDomElement backgroundElem = findElementById(domDoc, "background").toElement();
+        if (backgroundElem.isNull()) {
+            renderers->insert(key, QSharedPointer<QSvgRenderer>());
+            return nullptr;
+        }
+        QMap<QString, QString> styles = getStyleAttrib(backgroundElem);
+        styles["stroke"] = stroke.name();
+        styles["stroke-width"] = QString::number(strokeWidth);
+        backgroundElem.setAttribute("style", styleAttribToString(styles));
+    }
+
+    QSharedPointer<QSvgRenderer> renderer(new QSvgRenderer(domDoc.toByteArray()));
+    renderers->insert(key, renderer);
+    return renderer.data();
+}
+
+void Util::XML::drawSvg(QPainter *painter, const QRectF &target, const QString &filename, const QSize &size, const QPen &outline, bool increaseQuality)
+{
+    FTRACE_SCOPE_ARG(Svg, "Util::XML::drawSvg", size.height());
+    if (target.isEmpty() || size.isNull() || filename.isEmpty() || (size.width() < 0 && size.height() < 0)) {
+        return;
+    }
+    QSvgRenderer *renderer = svgRenderer(filename);
+    if (!renderer || !renderer->isValid()) {
+        return;
+    }
+
+    // The outline width and viewBox follow svgToImage, so both outputs look alike
+    const int svgHeight = renderer->defaultSize().height();
+    const int svgWidth = renderer->defaultSize().width();
+    if (svgHeight <= 0 || svgWidth <= 0) {
+        return;
+    }
+    const int quality = increaseQuality ? 2 : 1;
+    int height = size.height() * quality;
+    if (size.height() == -1) {
+        height = qCeil(size.width() * (svgHeight / svgWidth) * quality);
+    }
+    qreal outlineWidth = 0.0;
+    const bool hasOutline = outline.color().alpha() > 0 && outline != Qt::NoPen;
+    if (hasOutline && height > 0) {
+        outlineWidth = qFloor((svgHeight/height) * outline.widthF() * quality);
+    }
+    const QRectF viewBox = QRectF(-outlineWidth, -outlineWidth, svgHeight + outlineWidth*2, svgWidth + outlineWidth*2);
+
+    if (hasOutline) {
+        QSvgRenderer *outlineRenderer = svgRenderer(filename, outline.color(), outlineWidth * quality);
+        if (outlineRenderer) {
+            outlineRenderer->setViewBox(viewBox);
+            outlineRenderer->render(painter, target);
+        }
+    }
+    renderer->setViewBox(viewBox);
+    renderer->render(painter, target);
+}
@@ -7,6 +7,7 @@
 #include <QStringBuilder>
 #include <QFile>
 #include <QtSvg>
+#include "tracer.h"
 
 #define APPNAME "FOWCE\0"
 #define ORGNAME "FOWCE\0"
@@ -35,6 +36,16 @@ public:
 };*/
     static bool DrawDebugInfo;
 
+    // PDF, SVG and QPicture keep paths and text, draw vectors into them instead of rasterized images
+    static bool isVectorDevice(const QPainter *painter)
+    {
+        if (!painter || !painter->paintEngine()) {
+            return false;
+        }
+        const QPaintEngine::Type type = painter->paintEngine()->type();
+        return type == QPaintEngine::Pdf || type == QPaintEngine::Picture || type == QPaintEngine::SVG;
+    }
+
     class XML
     {
     public:
@@ -94,12 +105,20 @@ public:
 
         static QPixmap svgToPixmap(const QString &filename, const QSize &size, const QPen &outline = Qt::NoPen, bool increaseQuality = true)
         {
+            const QImage image = svgToImage(filename, size, outline, increaseQuality);
+            return image.isNull() ? QPixmap() : QPixmap::fromImage(image);
+        }
+
+        // Same as svgToPixmap but safe to call from any thread, the image is premultiplied ARGB32
+        static QImage svgToImage(const QString &filename, const QSize &size, const QPen &outline = Qt::NoPen, bool increaseQuality = true)
+        {
+            FTRACE_SCOPE_ARG(Svg, "Util::XML::svgToImage", size.height());
             if (size.isNull() || filename.isEmpty() || (size.width() < 0 && size.height() < 0)) {
-                return QPixmap();
+                return QImage();
             }
             QFile svgFile(filename);
             if (!svgFile.open(QIODevice::ReadOnly)) {
-                return QPixmap();
+                return QImage();
             }
             QByteArray svgData(svgFile.readAll());
 
@@ -127,7 +146,7 @@ public:
             // If we have an outline set, this will increase the viewBox so the outline won't be cut off
             QRectF viewBox = QRectF(-outlineWidth, -outlineWidth, svgHeight + outlineWidth*2, svgWidth + outlineWidth*2);
 
-            QPixmap pix(QSize(qCeil(width), qCeil(height)));
+            QImage pix(QSize(qCeil(width), qCeil(height)), QImage::Format_ARGB32_Premultiplied);
             pix.fill(Qt::transparent);
 
             QPainter p(&pix);
@@ -164,6 +183,13 @@ public:
 
             return pix;
         }
+
+        // Vector counterpart of svgToImage, draws the SVG and its outline as paths into target.
+        // Size and quality are what svgToImage would get, they decide the outline width the same way
+        static void drawSvg(QPainter *painter, const QRectF &target, const QString &filename, const QSize &size,
+                            const QPen &outline = Qt::NoPen, bool increaseQuality = true);
+        // Parsed once per thread, null when an outline is asked for an SVG without "background" element
+        static QSvgRenderer *svgRenderer(const QString &filename, const QColor &stroke = QColor(), qreal strokeWidth = 0);
     };
 
     class TextObject
@@ -171,7 +197,7 @@ public:
     public:
         enum Format { KeywordTextFormat = QTextFormat::UserObject + 1, SymbolTextFormat = QTextFormat::UserObject + 2 };
         enum { KeywordData = 1, KeywordGradient = 2 };
-        enum { SymbolData = 1, SymbolOutlineWidth = 2, SymbolText = 3, SymbolFont = 4 };
+        enum { SymbolData = 1, SymbolOutlineWidth = 2, SymbolText = 3, SymbolFont = 4, SymbolFile = 5, SymbolOutline = 6, SymbolHeight = 7 };
 
         struct Replacement
         {
@@ -9,14 +9,14 @@ WillCostDelegate::WillCostDelegate(QObject *parent) : QStyledItemDelegate(parent
 
 QWidget *WillCostDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &/*option*/, const QModelIndex &index) const
 {
-    const WillCost *cost = static_cast<const WillCostModel*>(index.model())->getCost(index);
+    const WillCost cost = static_cast<const WillCostModel*>(index.model())->getCost(index);
 
     if (index.column() == 2) {
         int maxCost = MAX_CARD_COST;
-        if (cost->dynamic) {
+        if (cost.dynamic) {
             maxCost = MAX_CARD_COST_DYNAMIC;
-        } else if (!cost->characteristic) {
-            maxCost = cost->attribute->maxCost();
+        } else if (!cost.characteristic) {
+            maxCost = cost.attribute->maxCost();
         }
         QSpinBox *editor = new QSpinBox(parent);
         editor->setFrame(false);
@@ -1,66 +1,183 @@
 #include <QPixmap>
 #include <QIcon>
 #include "willcostmodel.h"
+#include "iconcache.h"
 #include "util.h"
 
+WillCostSchema::WillCostSchema(const FAttributeModel *attributeModel)
+{
+    QVector<FAbstractObject*>::const_iterator it;
+    for (it = attributeModel->dataVec()->begin(); it != attributeModel->dataVec()->end(); ++it) {
+        const FAttribute *attribute = static_cast<FAttribute*>(*it);
+        m_rowIndex.insert(key(attribute->id(), -1), m_rows.size());
+        m_rows.push_back({attribute, nullptr, attribute->isGeneric()});
+
+        QVector<const FWillCharacteristic*>::const_iterator cit;
+        for (cit = attribute->characteristics()->begin(); cit != attribute->characteristics()->end(); ++cit) {
+            m_rowIndex.insert(key(attribute->id(), (*cit)->id()), m_rows.size());
+            m_rows.push_back({attribute, (*cit), false});
+        }
+    }
+}
+
+QHash<const FAttributeModel*, QSharedPointer<const WillCostSchema>> &WillCostSchema::schemas()
+{
+    static QHash<const FAttributeModel*, QSharedPointer<const WillCostSchema>> schemas;
+    return schemas;
+}
+
+QSharedPointer<const WillCostSchema> WillCostSchema::forModel(const FAttributeModel *attributeModel)
+{
+    if (!attributeModel) return QSharedPointer<const WillCostSchema>();
+
+    QSharedPointer<const WillCostSchema> schema = schemas().value(attributeModel);
+    if (!schema) {
+        schema = QSharedPointer<const WillCostSchema>(new WillCostSchema(attributeModel));
+        schemas().insert(attributeModel, schema);
+    }
+    return schema;
+}
+
+void WillCostSchema::invalidate(const FAttributeModel *attributeModel)
+{
+    // Models still holding the old schema keep it alive until they call updateSchema()
+    schemas().remove(attributeModel);
+}
+
 WillCostModel::WillCostModel(QObject *parent, const FAttributeModel *attributeModel)
-    : QAbstractTableModel(parent), m_attributeModel(attributeModel), m_columnCount(4),
-      m_totalNonGenericCost(0), m_totalGenericCost(0), m_costExceeded(false)
+    : QAbstractTableModel(parent), m_attributeModel(attributeModel), m_schema(WillCostSchema::forModel(attributeModel)),
+      m_columnCount(4), m_totalNonGenericCost(0), m_totalGenericCost(0), m_costExceeded(false)
 {
-    if (m_attributeModel) {
-        // Calculate rows
-        int count = 0;
-        QVector<FAbstractObject*>::const_iterator it;
-        for (it = m_attributeModel->dataVec()->begin(); it != m_attributeModel->dataVec()->end(); ++it) {
-            const FAttribute *attribute = static_cast<FAttribute*>(*it);
-            costs.push_back(WillCost(attribute, nullptr, 0, attribute->isGeneric(), false));
-
-            QVector<const FWillCharacteristic*>::const_iterator cit;
-            for (cit = attribute->characteristics()->begin(); cit != attribute->characteristics()->end(); ++cit) {
-                costs.push_back(WillCost(attribute, (*cit), 0, false, false));
-            }
+}
+
+void WillCostModel::updateSchema()
+{
+    const QSharedPointer<const WillCostSchema> schema = WillCostSchema::forModel(m_attributeModel);
+    if (schema == m_schema) return;
 
-            count += 1 + attribute->characteristics()->size();
+    // Reloads update attributes and characteristics in place, so the objects
+    // identify a row across schemas even when their numeric ids changed
+    QHash<QPair<const FAttribute*, const FWillCharacteristic*>, int> newRows;
+    for (int row = 0; row < schema->rowCount(); ++row) {
+        const WillCostRow &schemaRow = schema->row(row);
+        newRows.insert(qMakePair(schemaRow.attribute, schemaRow.characteristic), row);
+    }
+
+    beginResetModel();
+    QMap<int, WillCostEntry> entries;
+    m_totalNonGenericCost = 0;
+    m_totalGenericCost = 0;
+    QMap<int, WillCostEntry>::const_iterator it;
+    for (it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        const WillCostRow &oldRow = m_schema->row(it.key());
+        const int row = newRows.value(qMakePair(oldRow.attribute, oldRow.characteristic), -1);
+        if (row < 0) continue;
+
+        entries.insert(row, it.value());
+        if (schema->row(row).generic) {
+            m_totalGenericCost += it.value().cost;
+        } else {
+            m_totalNonGenericCost += it.value().cost;
         }
-        m_rowCount = count;
-    } else {
-        m_rowCount = 0;
     }
+    m_schema = schema;
+    m_entries = entries;
+    endResetModel();
+    updateCostExceeded();
 }
 
 const FAttribute* WillCostModel::getAttribute(const QModelIndex &index) const
 {
-    if (!index.isValid() || index.row() > m_rowCount) return nullptr;
-    return costs[index.row()].attribute;
+    if (!index.isValid() || index.row() >= rowCount(QModelIndex())) return nullptr;
+    return m_schema->row(index.row()).attribute;
 }
 
-const WillCost* WillCostModel::getCost(const QModelIndex &index) const
+WillCost WillCostModel::cost(int row) const
 {
-    if (!index.isValid() || index.row() > m_rowCount) return nullptr;
-    return &costs[index.row()];
+    if (row < 0 || row >= rowCount(QModelIndex())) return WillCost();
+    const WillCostRow &schemaRow = m_schema->row(row);
+    const WillCostEntry entry = m_entries.value(row);
+    return WillCost(schemaRow.attribute, schemaRow.characteristic, entry.cost, schemaRow.generic, entry.dynamic);
+}
+
+void WillCostModel::setCost(int row, int cost)
+{
+    if (row < 0 || row >= rowCount(QModelIndex())) return;
+    WillCostEntry entry = m_entries.value(row);
+    int costDifference = cost - entry.cost;
+    if (costDifference == 0) return;
+
+    if (m_schema->row(row).generic) {
+        m_totalGenericCost += costDifference;
+    } else {
+        m_totalNonGenericCost += costDifference;
+    }
+    entry.cost = qint8(cost);
+    if (entry.cost == 0 && !entry.dynamic) {
+        m_entries.remove(row);
+    } else {
+        m_entries.insert(row, entry);
+    }
+
+    QModelIndex idx = index(row, 2);
+    emit dataChanged(idx, idx);
+    updateCostExceeded();
+}
+
+void WillCostModel::setDynamic(int row, bool dynamic)
+{
+    if (row < 0 || row >= rowCount(QModelIndex())) return;
+    WillCostEntry entry = m_entries.value(row);
+    if (entry.dynamic == dynamic) return;
+
+    entry.dynamic = dynamic;
+    if (entry.cost == 0 && !entry.dynamic) {
+        m_entries.remove(row);
+    } else {
+        m_entries.insert(row, entry);
+    }
+
+    QModelIndex idx = index(row, 3);
+    emit dataChanged(idx, idx);
+    // If current cost exceeds maximum dynamic cost -> update
+    if (dynamic && entry.cost > MAX_CARD_COST_DYNAMIC) {
+        setCost(row, MAX_CARD_COST_DYNAMIC);
+    }
+}
+
+void WillCostModel::updateCostExceeded()
+{
+    if (m_totalGenericCost > MAX_TOTAL_CARD_COST_GENERIC || m_totalNonGenericCost > MAX_TOTAL_CARD_COST) {
+        m_costExceeded = true;
+        emit costExceeded(true);
+    } else if (m_costExceeded) {
+        m_costExceeded = false;
+        emit costExceeded(false);
+    }
 }
 
 QVariant WillCostModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.column() > m_columnCount || index.row() > m_rowCount) return QVariant();
+    if (!index.isValid() || index.column() >= m_columnCount || index.row() >= rowCount(QModelIndex())) return QVariant();
+    const WillCost c = cost(index.row());
     if (role == Qt::DisplayRole) {
         if (index.column() == 0) {
             return QString("");
         } else if (index.column() == 1) {
             QString name;
-            if (costs[index.row()].characteristic) {
-                name = QString("%1 (%2)").arg(costs[index.row()].attribute->name(), costs[index.row()].characteristic->name());
+            if (c.characteristic) {
+                name = QString("%1 (%2)").arg(c.attribute->name(), c.characteristic->name());
             } else {
-                name = costs[index.row()].attribute->name();
+                name = c.attribute->name();
             }
             return name;
         } else if (index.column() == 2) {
-            return costs[index.row()].cost;
+            return c.cost;
         } else if (index.column() == 3) {
-            if (!costs[index.row()].attribute->isGeneric() || costs[index.row()].characteristic) {
+            if (!c.attribute->isGeneric() || c.characteristic) {
                 return QVariant();
             }
-            if (costs[index.row()].dynamic) {
+            if (c.dynamic) {
                 return QObject::tr("Yes", "Is checkbox checked");
             } else {
                 return QObject::tr("No", "Is checkbox checked");
@@ -68,31 +185,18 @@ QVariant WillCostModel::data(const QModelIndex &index, int role) const
        } else return QVariant();
     } else if (role == Qt::DecorationRole) {
         if (index.column() == 0) {
-            QPixmap test;
-            if (costs[index.row()].characteristic) {
-                if (costs[index.row()].characteristic->iconPath().isEmpty()) {
-                    return QVariant(QIcon::fromTheme("missing"));
-                } else {
-                    return QVariant(QIcon::fromTheme(costs[index.row()].characteristic->iconPath()));
-                }
-            } else {
-                if (costs[index.row()].attribute->iconPath().isEmpty()) {
-                    return QVariant(QIcon::fromTheme("missing"));
-                } else {
-                    return QVariant(QIcon::fromTheme(costs[index.row()].attribute->iconPath()));
-                }
-            }
+            return QVariant(IconCache::Instance()->icon(c.characteristic ? c.characteristic->iconPath() : c.attribute->iconPath()));
         }
     } else if (role == Qt::EditRole) {
         if (index.column() == 2) {
-            return QVariant(costs[index.row()].cost);
+            return QVariant(c.cost);
         }
     } else if (role == Qt::CheckStateRole) {
         if (index.column() == 3) {
-            if (!costs[index.row()].attribute->isGeneric() || costs[index.row()].characteristic) {
+            if (!c.attribute->isGeneric() || c.characteristic) {
                 return QVariant();
             }
-            if (costs[index.row()].dynamic) {
+            if (c.dynamic) {
                 return QVariant(Qt::CheckState::Checked);
             } else {
                 return QVariant(Qt::CheckState::Unchecked);
@@ -147,31 +251,9 @@ bool WillCostModel::setData(const QModelIndex &index, const QVariant &value, int
 {
     if (!index.isValid()) return false;
     if (index.column() == 2 && role == Qt::EditRole) {
-        int costDifference = value.toInt() - costs[index.row()].cost;
-        if (costs[index.row()].generic) {
-            m_totalGenericCost += costDifference;
-        } else {
-            m_totalNonGenericCost += costDifference;
-        }
-
-        costs[index.row()].cost = value.toInt();
-        emit dataChanged(index, index);
-
-        if (m_totalGenericCost > MAX_TOTAL_CARD_COST_GENERIC || m_totalNonGenericCost > MAX_TOTAL_CARD_COST) {
-            m_costExceeded = true;
-            emit costExceeded(true);
-        } else if (m_costExceeded) {
-            m_costExceeded = false;
-            emit costExceeded(false);
-        }
+        setCost(index.row(), value.toInt());
     } else if (index.column() == 3 && role == Qt::CheckStateRole) {
-        costs[index.row()].dynamic = value.toInt() == Qt::CheckState::Checked ? true : false;
-        emit dataChanged(index, index);
-        // If current cost exceeds maximum dynamic cost -> update
-        if (costs[index.row()].cost > MAX_CARD_COST_DYNAMIC) {
-            QModelIndex idx = WillCostModel::index(index.row(), 2, index.parent());
-            setData(idx, QVariant(MAX_CARD_COST_DYNAMIC), Qt::EditRole);
-        }
+        setDynamic(index.row(), value.toInt() == Qt::CheckState::Checked);
     }
     return false;
 }
@@ -2,6 +2,9 @@
 #define WILLCOSTMODEL_H
 
 #include <QAbstractTableModel>
+#include <QHash>
+#include <QMap>
+#include <QSharedPointer>
 #include "models/fattributemodel.h"
 
 class WillCost
@@ -18,6 +21,45 @@ public:
     bool dynamic;
 };
 
+struct WillCostRow
+{
+    const FAttribute *attribute;
+    const FWillCharacteristic *characteristic;
+    bool generic;
+};
+
+/*!
+ * \brief Row layout of the will cost table: every attribute followed by its
+ * characteristics. Built once per attribute model and shared by all cards,
+ * invalidate() drops it after the attribute model was reloaded.
+ */
+class WillCostSchema
+{
+public:
+    static QSharedPointer<const WillCostSchema> forModel(const FAttributeModel *attributeModel);
+    static void invalidate(const FAttributeModel *attributeModel);
+
+    int rowCount() const { return m_rows.size(); }
+    const WillCostRow &row(int row) const { return m_rows.at(row); }
+    int rowOf(int attributeId, int characteristicId = -1) const { return m_rowIndex.value(key(attributeId, characteristicId), -1); }
+
+private:
+    explicit WillCostSchema(const FAttributeModel *attributeModel);
+
+    QVector<WillCostRow> m_rows;
+    QHash<quint32, int> m_rowIndex;
+
+    static QHash<const FAttributeModel*, QSharedPointer<const WillCostSchema>> &schemas();
+    static quint32 key(int attributeId, int characteristicId) { return (quint32(quint16(attributeId)) << 16) | quint16(characteristicId); }
+};
+
+struct WillCostEntry
+{
+    WillCostEntry() : cost(0), dynamic(false) {}
+    qint8 cost;
+    bool dynamic;
+};
+
 class WillCostModel : public QAbstractTableModel
 {
     Q_OBJECT
@@ -25,9 +67,23 @@ public:
     WillCostModel(QObject *parent = nullptr, const FAttributeModel *attributeModel = nullptr);
 
     const FAttribute *getAttribute(const QModelIndex &index) const;
-    const WillCost *getCost(const QModelIndex &index) const;
+    WillCost getCost(const QModelIndex &index) const { return cost(index.isValid() ? index.row() : -1); }
+    WillCost cost(int row) const;
+    int rowOf(int attributeId, int characteristicId = -1) const { return m_schema ? m_schema->rowOf(attributeId, characteristicId) : -1; }
+
+    // Rows with a cost or the dynamic flag set, everything else is 0
+    const QMap<int, WillCostEntry> &entries() const { return m_entries; }
+    void setCost(int row, int cost);
+    void setDynamic(int row, bool dynamic);
+
+    int totalNonGenericCost() const { return m_totalNonGenericCost; }
+    int totalGenericCost() const { return m_totalGenericCost; }
+    bool isCostExceeded() const { return m_costExceeded; }
 
-    int rowCount(const QModelIndex &/*parent*/) const override { return m_rowCount; }
+    // Switches to the current schema of the attribute model, costs of removed attributes are dropped
+    void updateSchema();
+
+    int rowCount(const QModelIndex &/*parent*/) const override { return m_schema ? m_schema->rowCount() : 0; }
     int columnCount(const QModelIndex &/*parent*/) const override { return m_columnCount; }
     QVariant data(const QModelIndex &index, int role) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
@@ -36,13 +92,15 @@ public:
 
 private:
     const FAttributeModel *m_attributeModel;
-    QVector<WillCost> costs;
-    int m_rowCount;
+    QSharedPointer<const WillCostSchema> m_schema;
+    QMap<int, WillCostEntry> m_entries;
     int m_columnCount;
     int m_totalNonGenericCost;
     int m_totalGenericCost;
     bool m_costExceeded;
 
+    void updateCostExceeded();
+
 signals:
     void costExceeded(bool exceeded);
 };